@@ -718,12 +718,34 @@ private:
 
   /// @}
 
+  /// \name Arithmetic on native floating point types.
+  /// @{
+
+  /// For IEEE single and double precision, try to compute \p Op on this value,
+  /// \p rhs and \p addend (if not null) with native float or double arithmetic,
+  /// rounding to nearest, ties to even. Returns false without changing
+  /// anything if the generic code is needed for a bit-exact result and status.
+  template <typename OpFn>
+  bool computeNative(OpFn Op, const IEEEFloat &rhs, const IEEEFloat *addend,
+                     opStatus &fs);
+
+  // The generic versions of the arithmetic operations. Exported for
+  // IEEEFloatUnitTestHelper.
+  LLVM_ABI opStatus multiplyGeneric(const IEEEFloat &, roundingMode);
+  LLVM_ABI opStatus divideGeneric(const IEEEFloat &, roundingMode);
+  LLVM_ABI opStatus fusedMultiplyAddGeneric(const IEEEFloat &,
+                                            const IEEEFloat &, roundingMode);
+
+  /// @}
+
   /// \name Miscellany
   /// @{
 
   bool convertFromStringSpecials(StringRef str);
   opStatus normalize(roundingMode, lostFraction);
-  opStatus addOrSubtract(const IEEEFloat &, roundingMode, bool subtract);
+  // Exported for IEEEFloatUnitTestHelper.
+  LLVM_ABI opStatus addOrSubtract(const IEEEFloat &, roundingMode,
+                                  bool subtract);
   opStatus handleOverflow(roundingMode);
   bool roundAwayFromZero(roundingMode, lostFraction, unsigned int) const;
   opStatus convertToSignExtendedInteger(MutableArrayRef<integerPart>,
@@ -0,0 +1,157 @@
+//===- llvm/ADT/CallableArena.h - Slab storage for callables ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines CallableArena, which stores a batch of pending callables
+/// of one signature in bump-allocated slabs.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_CALLABLEARENA_H
+#define LLVM_ADT_CALLABLEARENA_H
+
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace llvm {
+
+/// A batch of pending callables, such as the tasks of a queue, which are all
+/// invoked and then all released together.
+///
+/// Storing each task in its own unique_function heap-allocates every callable
+/// larger than the inline buffer, one allocation per task. A CallableArena
+/// instead places each callable, of any size, in a slab of a BumpPtrAllocator
+/// next to a small header holding its call and destroy pointers, and chains
+/// the headers in insertion order. Pushing a callable is a bump of a pointer,
+/// the callables of a batch are contiguous in memory, and clear() releases
+/// them all at once, only visiting those with a non-trivial destructor.
+///
+/// \code
+///   CallableArena<void(Context &)> Pending;
+///   for (Job &J : Jobs)
+///     Pending.push_back([&J](Context &Ctx) { J.run(Ctx); });
+///   Pending.invokeAll(Ctx);
+///   Pending.clear();
+/// \endcode
+template <typename FunctionT> class CallableArena;
+
+template <typename R, typename... P> class CallableArena<R(P...)> {
+  struct Entry {
+    R (*Call)(Entry *, P &...);
+    /// Null if the callable is trivially destructible.
+    void (*Destroy)(Entry *);
+    Entry *Next;
+  };
+
+  template <typename CallableT>
+  static constexpr size_t CallableOffset =
+      alignTo(sizeof(Entry), alignof(CallableT));
+
+  template <typename CallableT> static CallableT *getCallable(Entry *E) {
+    return reinterpret_cast<CallableT *>(reinterpret_cast<char *>(E) +
+                                         CallableOffset<CallableT>);
+  }
+
+  template <typename CallableT> static R callImpl(Entry *E, P &...Params) {
+    return (*getCallable<CallableT>(E))(Params...);
+  }
+
+  template <typename CallableT> static void destroyImpl(Entry *E) {
+    getCallable<CallableT>(E)->~CallableT();
+  }
+
+  BumpPtrAllocator Allocator;
+  Entry *Head = nullptr;
+  Entry *Tail = nullptr;
+  size_t NumEntries = 0;
+  /// Whether any pending callable has a non-trivial destructor.
+  bool NeedsDestroy = false;
+
+public:
+  CallableArena() = default;
+  CallableArena(const CallableArena &) = delete;
+  CallableArena &operator=(const CallableArena &) = delete;
+
+  CallableArena(CallableArena &&RHS)
+      : Allocator(std::move(RHS.Allocator)), Head(RHS.Head), Tail(RHS.Tail),
+        NumEntries(RHS.NumEntries), NeedsDestroy(RHS.NeedsDestroy) {
+    RHS.Head = RHS.Tail = nullptr;
+    RHS.NumEntries = 0;
+    RHS.NeedsDestroy = false;
+  }
+
+  CallableArena &operator=(CallableArena &&RHS) {
+    clear();
+    Allocator = std::move(RHS.Allocator);
+    Head = RHS.Head;
+    Tail = RHS.Tail;
+    NumEntries = RHS.NumEntries;
+    NeedsDestroy = RHS.NeedsDestroy;
+    RHS.Head = RHS.Tail = nullptr;
+    RHS.NumEntries = 0;
+    RHS.NeedsDestroy = false;
+    return *this;
+  }
+
+  ~CallableArena() { clear(); }
+
+  bool empty() const { return NumEntries == 0; }
+  size_t size() const { return NumEntries; }
+
+  /// Add \p Callable to the end of the batch.
+  template <typename CallableT> void push_back(CallableT Callable) {
+    void *Mem =
+        Allocator.Allocate(CallableOffset<CallableT> + sizeof(CallableT),
+                           std::max(alignof(Entry), alignof(CallableT)));
+    Entry *E = new (Mem) Entry{&callImpl<CallableT>, nullptr, nullptr};
+    if constexpr (!std::is_trivially_destructible_v<CallableT>) {
+      E->Destroy = &destroyImpl<CallableT>;
+      NeedsDestroy = true;
+    }
+    new (getCallable<CallableT>(E)) CallableT(std::move(Callable));
+
+    if (Tail)
+      Tail->Next = E;
+    else
+      Head = E;
+    Tail = E;
+    ++NumEntries;
+  }
+
+  /// Invoke every pending callable, in the order they were added, with
+  /// \p Params. As each callable is passed the same arguments, they are passed
+  /// as lvalues. The callables stay pending until clear().
+  void invokeAll(P... Params) {
+    for (Entry *E = Head; E; E = E->Next)
+      E->Call(E, Params...);
+  }
+
+  /// Destroy all the pending callables and release their storage.
+  void clear() {
+    if (NeedsDestroy)
+      for (Entry *E = Head; E; E = E->Next)
+        if (E->Destroy)
+          E->Destroy(E);
+    Allocator.Reset();
+    Head = Tail = nullptr;
+    NumEntries = 0;
+    NeedsDestroy = false;
+  }
+
+  /// Return the number of bytes of slab memory held by the arena.
+  size_t getTotalMemory() const { return Allocator.getTotalMemory(); }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_CALLABLEARENA_H
@@ -0,0 +1,116 @@
+//===- ConcurrentIntEqClasses.h - Concurrent IntEqClasses -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Equivalence classes for small integers that can be joined from many threads
+/// at once. Like IntEqClasses, this maps the integers 0 .. N-1 into M
+/// equivalence classes, and compress() numbers them 0 .. M-1 once they are
+/// built.
+///
+/// The classes form a lock-free union-find: each integer points to a smaller
+/// member of its class, links are made with compare-and-swap, and lookups
+/// shorten the paths they walk by path halving. Since every link points to a
+/// smaller integer, the leader of a class is always its smallest member, no
+/// matter in which order the classes were joined.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_CONCURRENTINTEQCLASSES_H
+#define LLVM_ADT_CONCURRENTINTEQCLASSES_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/EquivalenceClasses.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Compiler.h"
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+namespace llvm {
+
+class ConcurrentIntEqClasses {
+  /// EC - When uncompressed, map each integer to a smaller member of its
+  /// equivalence class. The class leader is the smallest member and maps to
+  /// itself.
+  ///
+  /// When compressed, EC[i] is the equivalence class of i.
+  std::unique_ptr<std::atomic<unsigned>[]> EC;
+  unsigned Size = 0;
+
+  /// NumClasses - The number of equivalence classes when compressed, or 0 when
+  /// uncompressed.
+  unsigned NumClasses = 0;
+
+public:
+  /// ConcurrentIntEqClasses - Create an equivalence class mapping for
+  /// 0 .. N-1, with every integer in a class of its own.
+  LLVM_ABI explicit ConcurrentIntEqClasses(unsigned N = 0);
+
+  /// size - Return the number of integers that are mapped.
+  unsigned size() const { return Size; }
+
+  /// Join the equivalence classes of a and b. After joining classes,
+  /// findLeader(a) == findLeader(b). This may be called from several threads
+  /// at once, and concurrently with findLeader(). This requires an
+  /// uncompressed map. Returns the new leader.
+  LLVM_ABI unsigned join(unsigned a, unsigned b);
+
+  /// joinAll - Join the classes of each pair of integers in \p Pairs, running
+  /// the joins in parallel. This requires an uncompressed map.
+  LLVM_ABI void joinAll(ArrayRef<std::pair<unsigned, unsigned>> Pairs);
+
+  /// findLeader - Compute the leader of a's equivalence class. This is the
+  /// smallest member of the class. This may be called from several threads at
+  /// once. This requires an uncompressed map.
+  LLVM_ABI unsigned findLeader(unsigned a) const;
+
+  /// compress - Compress equivalence classes by numbering them 0 .. M, in
+  /// order of their leaders. This makes the equivalence class map immutable,
+  /// and must not run concurrently with anything else.
+  LLVM_ABI void compress();
+
+  /// getNumClasses - Return the number of equivalence classes after compress()
+  /// was called.
+  unsigned getNumClasses() const { return NumClasses; }
+
+  /// operator[] - Return a's equivalence class number, 0 .. getNumClasses()-1.
+  /// This requires a compressed map.
+  unsigned operator[](unsigned a) const {
+    assert(NumClasses && "operator[] called before compress()");
+    return EC[a].load(std::memory_order_relaxed);
+  }
+
+  /// toEquivalenceClasses - Build the EquivalenceClasses of \p Elements, where
+  /// Elements[i] stands for the integer i, so that the classes can be walked
+  /// with member iterators. The leader of each class is the element of its
+  /// smallest member. This requires a compressed map.
+  template <class ElemTy>
+  EquivalenceClasses<ElemTy>
+  toEquivalenceClasses(ArrayRef<ElemTy> Elements) const {
+    assert(NumClasses && "toEquivalenceClasses() called before compress()");
+    assert(Elements.size() == Size && "wrong number of elements");
+    EquivalenceClasses<ElemTy> Classes;
+    // The first member of each class seen is the smallest, its leader.
+    SmallVector<unsigned, 8> Leader(NumClasses, Size);
+    for (unsigned i = 0; i != Size; ++i) {
+      unsigned Class = (*this)[i];
+      if (Leader[Class] == Size) {
+        Leader[Class] = i;
+        Classes.insert(Elements[i]);
+      } else {
+        Classes.unionSets(Elements[Leader[Class]], Elements[i]);
+      }
+    }
+    return Classes;
+  }
+};
+
+} // End llvm namespace
+
+#endif
@@ -0,0 +1,284 @@
+//===- ConcurrentPagedVector.h - Concurrent PagedVector ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the ConcurrentPagedVector class.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_ADT_CONCURRENTPAGEDVECTOR_H
+#define LLVM_ADT_CONCURRENTPAGEDVECTOR_H
+
+#include "llvm/ADT/iterator_range.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/ThreadSafeAllocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace llvm {
+/// A PagedVector that can be grown, and whose pages can be materialized, from
+/// several threads at once.
+///
+/// Like PagedVector, elements are allocated a page at a time, on the first
+/// access to any element of the page, and all the elements of a page are
+/// default constructed together. This suits huge, sparsely filled tables
+/// indexed by an ID and filled in parallel.
+///
+/// The pages are reached through a directory of segments, where segment K
+/// holds the pointers to 2^K pages, so the vector can grow without ever
+/// moving the page pointers. Like the page table of PagedVector, the
+/// directory takes a pointer per page up to the last one accessed. Segments
+/// and pages are both installed with a compare-and-swap on a null pointer:
+///
+///  - operator[] on a materialized page is wait-free: two atomic loads and
+///    some arithmetic;
+///  - materializing a page is lock-free. When two threads race for the same
+///    page, the loser destroys its copy and uses the winner's. The memory of
+///    the losing copy stays in the allocator until it is reset;
+///  - size() only grows, with grow_by() and grow_to_at_least().
+///
+/// AllocatorTy must be safe to call from several threads, such as
+/// ThreadSafeAllocator<BumpPtrAllocator> or PerThreadBumpPtrAllocator. Pages
+/// are not freed one by one, but when the allocator is reset, which happens in
+/// clear() and the destructor if the vector owns the allocator.
+///
+/// Only element access and growth may happen concurrently; clear() and
+/// iteration over the materialized elements must not race with anything.
+template <typename T, size_t PageSize = 1024 / sizeof(T),
+          typename AllocatorTy = ThreadSafeAllocator<BumpPtrAllocator>>
+class ConcurrentPagedVector {
+  static_assert(PageSize > 1, "PageSize must be greater than 0. Most likely "
+                              "you want it to be greater than 16.");
+
+  /// Enough segments to give every page index a slot.
+  static constexpr unsigned NumSegments = 64;
+
+  /// The actual number of elements in the vector which can be accessed.
+  std::atomic<size_t> Size{0};
+
+  /// Segment K holds the pointers to pages 2^K - 1 .. 2^(K+1) - 2.
+  mutable std::atomic<std::atomic<T *> *> Segments[NumSegments] = {};
+
+  AllocatorTy *Allocator;
+  std::unique_ptr<AllocatorTy> OwnedAllocator;
+
+  static unsigned getSegment(size_t Page) { return Log2_64(Page + 1); }
+  static size_t getSegmentOffset(size_t Page, unsigned Segment) {
+    return Page + 1 - (size_t(1) << Segment);
+  }
+
+  /// Return the slot of the pointer to page \p Page, creating its segment if
+  /// \p Create is set, or null if the segment does not exist.
+  std::atomic<T *> *getPageSlot(size_t Page, bool Create) const {
+    unsigned Segment = getSegment(Page);
+    std::atomic<T *> *Slots =
+        Segments[Segment].load(std::memory_order_acquire);
+    if (LLVM_UNLIKELY(!Slots)) {
+      if (!Create)
+        return nullptr;
+      Slots = new std::atomic<T *>[size_t(1) << Segment]();
+      std::atomic<T *> *Expected = nullptr;
+      if (!Segments[Segment].compare_exchange_strong(
+              Expected, Slots, std::memory_order_acq_rel)) {
+        delete[] Slots;
+        Slots = Expected;
+      }
+    }
+    return &Slots[getSegmentOffset(Page, Segment)];
+  }
+
+  /// Allocate and construct a page and install it in \p Slot, unless another
+  /// thread did so first. Return the installed page.
+  T *materializePage(std::atomic<T *> &Slot) const {
+    T *NewPage = static_cast<T *>(
+        Allocator->Allocate(PageSize * sizeof(T), alignof(T)));
+    // We need to invoke the default constructor on all the elements of the
+    // page.
+    std::uninitialized_value_construct_n(NewPage, PageSize);
+    T *Expected = nullptr;
+    if (Slot.compare_exchange_strong(Expected, NewPage,
+                                     std::memory_order_acq_rel))
+      return NewPage;
+    // Another thread got there first; use its page.
+    std::destroy_n(NewPage, PageSize);
+    return Expected;
+  }
+
+  T *getPage(size_t Page) const {
+    std::atomic<T *> *Slot = getPageSlot(Page, /*Create=*/false);
+    return Slot ? Slot->load(std::memory_order_acquire) : nullptr;
+  }
+
+public:
+  using value_type = T;
+
+  /// Default constructor. We build our own allocator.
+  ConcurrentPagedVector()
+      : Allocator(new AllocatorTy), OwnedAllocator(Allocator) {}
+  explicit ConcurrentPagedVector(AllocatorTy &A) : Allocator(&A) {}
+
+  ~ConcurrentPagedVector() {
+    clear();
+    for (auto &Segment : Segments)
+      delete[] Segment.load(std::memory_order_relaxed);
+  }
+
+  // Forbid copy and move as we do not need them for the current use case.
+  ConcurrentPagedVector(const ConcurrentPagedVector &) = delete;
+  ConcurrentPagedVector(ConcurrentPagedVector &&) = delete;
+  ConcurrentPagedVector &operator=(const ConcurrentPagedVector &) = delete;
+  ConcurrentPagedVector &operator=(ConcurrentPagedVector &&) = delete;
+
+  /// Look up an element at position `Index`.
+  /// If the associated page is not filled, it will be filled with default
+  /// constructed elements. This may be called from several threads at once.
+  T &operator[](size_t Index) const {
+    assert(Index < size());
+    std::atomic<T *> &Slot = *getPageSlot(Index / PageSize, /*Create=*/true);
+    T *PagePtr = Slot.load(std::memory_order_acquire);
+    // If the page was not yet allocated, allocate it.
+    if (LLVM_UNLIKELY(!PagePtr))
+      PagePtr = materializePage(Slot);
+    // Dereference the element in the page.
+    return PagePtr[Index % PageSize];
+  }
+
+  /// Return true if the page holding element `Index` has been materialized.
+  [[nodiscard]] bool isMaterialized(size_t Index) const {
+    return getPage(Index / PageSize) != nullptr;
+  }
+
+  /// Return the size of the vector.
+  [[nodiscard]] size_t size() const {
+    return Size.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  /// Grow the vector by \p N elements and return the index of the first one.
+  /// Concurrent calls get disjoint ranges of indices. The elements are
+  /// constructed when their page is first accessed.
+  size_t grow_by(size_t N) {
+    return Size.fetch_add(N, std::memory_order_acq_rel);
+  }
+
+  /// Grow the vector to at least \p NewSize elements. This never shrinks the
+  /// vector, even if another thread grew it concurrently.
+  void grow_to_at_least(size_t NewSize) {
+    size_t Current = Size.load(std::memory_order_relaxed);
+    while (Current < NewSize &&
+           !Size.compare_exchange_weak(Current, NewSize,
+                                       std::memory_order_acq_rel))
+      ;
+  }
+
+  /// Clear the vector: destroy the elements of the materialized pages and
+  /// reset the size. The pages' memory is only reclaimed if we own the
+  /// allocator. This must not run concurrently with anything else.
+  void clear() {
+    size_t NumPages = divideCeil(size(), PageSize);
+    for (size_t Page = 0; Page < NumPages; ++Page) {
+      std::atomic<T *> *Slot = getPageSlot(Page, /*Create=*/false);
+      if (!Slot)
+        continue;
+      if (T *PagePtr = Slot->exchange(nullptr, std::memory_order_relaxed))
+        std::destroy_n(PagePtr, PageSize);
+    }
+    Size.store(0, std::memory_order_relaxed);
+    // If we own the allocator, replace it with a fresh one.
+    if (OwnedAllocator) {
+      OwnedAllocator = std::make_unique<AllocatorTy>();
+      Allocator = OwnedAllocator.get();
+    }
+  }
+
+  /// Iterator on all the elements of the vector
+  /// which have actually being constructed.
+  class MaterializedIterator {
+    const ConcurrentPagedVector *PV;
+    size_t ElementIdx;
+    size_t EndIdx;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    MaterializedIterator(ConcurrentPagedVector const *PV, size_t ElementIdx)
+        : PV(PV), ElementIdx(ElementIdx), EndIdx(PV->size()) {
+      skipUnmaterialized();
+    }
+
+    /// Pre-increment operator.
+    ///
+    /// When incrementing the iterator, we skip the elements which have not
+    /// been materialized yet.
+    MaterializedIterator &operator++() {
+      ++ElementIdx;
+      if (ElementIdx % PageSize == 0)
+        skipUnmaterialized();
+      return *this;
+    }
+
+    MaterializedIterator operator++(int) {
+      MaterializedIterator Copy = *this;
+      ++*this;
+      return Copy;
+    }
+
+    T const &operator*() const {
+      assert(ElementIdx < EndIdx);
+      T *PagePtr = PV->getPage(ElementIdx / PageSize);
+      assert(PagePtr);
+      return PagePtr[ElementIdx % PageSize];
+    }
+
+    friend bool operator==(const MaterializedIterator &LHS,
+                           const MaterializedIterator &RHS) {
+      assert(LHS.PV == RHS.PV);
+      return LHS.ElementIdx == RHS.ElementIdx;
+    }
+
+    friend bool operator!=(const MaterializedIterator &LHS,
+                           const MaterializedIterator &RHS) {
+      return !(LHS == RHS);
+    }
+
+    [[nodiscard]] size_t getIndex() const { return ElementIdx; }
+
+  private:
+    void skipUnmaterialized() {
+      while (ElementIdx < EndIdx && !PV->getPage(ElementIdx / PageSize))
+        ElementIdx = alignTo(ElementIdx + 1, PageSize);
+      ElementIdx = std::min(ElementIdx, EndIdx);
+    }
+  };
+
+  /// Iterators over the materialized elements of the vector.
+  ///
+  /// This includes all the elements belonging to allocated pages,
+  /// even if they have not been accessed yet. It's enough to access
+  /// one element of a page to materialize all the elements of the page.
+  MaterializedIterator materialized_begin() const {
+    return MaterializedIterator(this, 0);
+  }
+
+  MaterializedIterator materialized_end() const {
+    return MaterializedIterator(this, size());
+  }
+
+  [[nodiscard]] llvm::iterator_range<MaterializedIterator>
+  materialized() const {
+    return {materialized_begin(), materialized_end()};
+  }
+};
+} // namespace llvm
+#endif // LLVM_ADT_CONCURRENTPAGEDVECTOR_H
@@ -15,6 +15,8 @@
 
 namespace llvm {
 
+class ThreadPoolInterface;
+
 /// DAGDeltaAlgorithm - Implements a "delta debugging" algorithm for minimizing
 /// directed acyclic graphs using a predicate function.
 ///
@@ -65,12 +67,20 @@ public:
   changeset_ty Run(const changeset_ty &Changes,
                    const std::vector<edge_ty> &Dependencies);
 
+  /// Run - Like Run(Changes, Dependencies), but test candidate change sets
+  /// concurrently on \p Pool. \see DeltaAlgorithm::Run.
+  changeset_ty Run(const changeset_ty &Changes,
+                   const std::vector<edge_ty> &Dependencies,
+                   ThreadPoolInterface &Pool);
+
   /// UpdatedSearchState - Callback used when the search state changes.
   virtual void UpdatedSearchState(const changeset_ty &Changes,
                                   const changesetlist_ty &Sets,
                                   const changeset_ty &Required) {}
 
   /// ExecuteOneTest - Execute a single test predicate on the change set \p S.
+  /// When running on a thread pool, this is called from several threads at
+  /// once.
   virtual bool ExecuteOneTest(const changeset_ty &S) = 0;
 };
 
@@ -8,12 +8,16 @@
 #ifndef LLVM_ADT_DELTAALGORITHM_H
 #define LLVM_ADT_DELTAALGORITHM_H
 
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/Support/Compiler.h"
 #include <set>
 #include <vector>
 
 namespace llvm {
 
+class ThreadPoolInterface;
+
 /// DeltaAlgorithm - Implements the delta debugging algorithm (A. Zeller '99)
 /// for minimizing arbitrary sets using a predicate function.
 ///
@@ -33,6 +37,9 @@ namespace llvm {
 /// requirements, and the algorithm will generally produce reasonable
 /// results. However, it may run substantially more tests than with a good
 /// predicate.
+///
+/// Tests usually run an external program, so the search can also be run on a
+/// thread pool, which tests all candidate subsets at each step concurrently.
 class LLVM_ABI DeltaAlgorithm {
 public:
   using change_ty = unsigned;
@@ -41,24 +48,41 @@ public:
   using changesetlist_ty = std::vector<changeset_ty>;
 
 private:
+  /// The changes being minimized, in increasing order. Change sets are kept as
+  /// bit vectors over the positions in this list, which are cheap to copy,
+  /// combine and hash.
+  std::vector<change_ty> Universe;
+
   /// Cache of failed test results. Successful test results are never cached
   /// since we always reduce following a success.
-  std::set<changeset_ty> FailedTestsCache;
+  DenseSet<BitVector> FailedTestsCache;
+
+  /// The pool candidate change sets are tested on, if running in parallel.
+  ThreadPoolInterface *Pool = nullptr;
+
+  /// ToChangeSet - Convert a bit vector over Universe to a change set.
+  changeset_ty ToChangeSet(const BitVector &Changes) const;
 
   /// GetTestResult - Get the test result for the \p Changes from the
   /// cache, executing the test if necessary.
   ///
   /// \param Changes - The change set to test.
   /// \return - The test result.
-  bool GetTestResult(const changeset_ty &Changes);
+  bool GetTestResult(const BitVector &Changes);
+
+  /// FindFirstPassing - Return the index of the first of \p Candidates that
+  /// satisfies the predicate, or the number of candidates if none does.
+  /// Without a pool the candidates are tested in order, stopping at the first
+  /// success. With one they are all tested concurrently, and tests which can
+  /// no longer affect the answer are skipped once one succeeds.
+  unsigned FindFirstPassing(const std::vector<BitVector> &Candidates);
 
   /// Split - Partition a set of changes \p S into one or two subsets.
-  void Split(const changeset_ty &S, changesetlist_ty &Res);
+  void Split(const BitVector &S, std::vector<BitVector> &Res);
 
   /// Delta - Minimize a set of \p Changes which has been partitioned into
   /// smaller sets, by attempting to remove individual subsets.
-  changeset_ty Delta(const changeset_ty &Changes,
-                     const changesetlist_ty &Sets);
+  BitVector Delta(const BitVector &Changes, const std::vector<BitVector> &Sets);
 
   /// Search - Search for a subset (or subsets) in \p Sets which can be
   /// removed from \p Changes while still satisfying the predicate.
@@ -66,8 +90,8 @@ private:
   /// \param Res - On success, a subset of Changes which satisfies the
   /// predicate.
   /// \return - True on success.
-  bool Search(const changeset_ty &Changes, const changesetlist_ty &Sets,
-              changeset_ty &Res);
+  bool Search(const BitVector &Changes, const std::vector<BitVector> &Sets,
+              BitVector &Res);
 
 protected:
   /// UpdatedSearchState - Callback used when the search state changes.
@@ -75,6 +99,8 @@ protected:
                                   const changesetlist_ty &Sets) {}
 
   /// ExecuteOneTest - Execute a single test predicate on the change set \p S.
+  /// When running on a thread pool, this is called from several threads at
+  /// once.
   virtual bool ExecuteOneTest(const changeset_ty &S) = 0;
 
   DeltaAlgorithm& operator=(const DeltaAlgorithm&) = default;
@@ -86,6 +112,11 @@ public:
   /// subsets of changes and returning the smallest set which still satisfies
   /// the test predicate.
   changeset_ty Run(const changeset_ty &Changes);
+
+  /// Run - Like Run(Changes), but test the candidate subsets and complements
+  /// at each step of the search concurrently on \p Pool. For a deterministic
+  /// predicate the result is the same as that of the sequential search.
+  changeset_ty Run(const changeset_ty &Changes, ThreadPoolInterface &Pool);
 };
 
 } // end namespace llvm
@@ -0,0 +1,182 @@
+//===- llvm/ADT/EditDistanceIndex.h - Nearest strings by edit distance ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines EditDistanceIndex, which finds the strings of a fixed
+/// dictionary that are closest to a query string by edit distance.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_EDITDISTANCEINDEX_H
+#define LLVM_ADT_EDITDISTANCEINDEX_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/edit_distance.h"
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace llvm {
+
+/// A dictionary entry returned by EditDistanceIndex::findClosest.
+struct EditDistanceMatch {
+  /// The index of the entry in the dictionary.
+  unsigned Index;
+  /// The edit distance between the entry and the query.
+  unsigned Distance;
+
+  bool operator<(const EditDistanceMatch &RHS) const {
+    return std::tie(Distance, Index) < std::tie(RHS.Distance, RHS.Index);
+  }
+  bool operator==(const EditDistanceMatch &RHS) const {
+    return Index == RHS.Index && Distance == RHS.Distance;
+  }
+};
+
+/// Finds the entries of a dictionary that are closest to a query string, as
+/// measured by StringRef::edit_distance. This is the batch form of calling
+/// edit_distance against every entry, as typo correction does: the query is
+/// preprocessed once, and each comparison uses the bit-parallel algorithm.
+///
+/// By default the dictionary is also organized into a BK-tree when the index
+/// is built. Edit distance is a metric, so a query can then skip every subtree
+/// that the triangle inequality shows is too far away, which for the usual
+/// small distances avoids looking at most of the dictionary.
+///
+/// The index refers to the dictionary strings and does not copy them.
+class EditDistanceIndex {
+public:
+  /// Index \p Dictionary. If \p BuildTree is false, queries compare against
+  /// every entry, which is cheaper for small dictionaries and one-off queries.
+  explicit EditDistanceIndex(ArrayRef<StringRef> Dictionary,
+                             bool AllowReplacements = true,
+                             bool BuildTree = true)
+      : Dictionary(Dictionary), AllowReplacements(AllowReplacements) {
+    if (!BuildTree || Dictionary.empty())
+      return;
+    Nodes.reserve(Dictionary.size());
+    Nodes.push_back({0, 0, NoNode, NoNode});
+    for (unsigned I = 1, E = Dictionary.size(); I != E; ++I)
+      insert(I);
+  }
+
+  /// Return up to \p K dictionary entries closest to \p Query, ordered by
+  /// distance and then by index. If \p MaxEditDistance is non-zero, entries
+  /// further away than that are not returned.
+  SmallVector<EditDistanceMatch, 4>
+  findClosest(StringRef Query, unsigned K, unsigned MaxEditDistance = 0) const {
+    SmallVector<EditDistanceMatch, 4> Best;
+    if (K == 0)
+      return Best;
+    detail::BitParallelEditDistance Pattern(
+        ArrayRef<uint8_t>(Query.bytes_begin(), Query.size()));
+    unsigned Limit =
+        MaxEditDistance ? MaxEditDistance : std::numeric_limits<unsigned>::max();
+
+    // Best is kept as a max-heap, so the worst match found so far is on top
+    // and the search can ignore anything further away than it.
+    auto Radius = [&] {
+      return Best.size() == K ? Best.front().Distance : Limit;
+    };
+    auto Consider = [&](unsigned Index, unsigned Distance) {
+      EditDistanceMatch M{Index, Distance};
+      if (Distance > Limit)
+        return;
+      if (Best.size() == K) {
+        if (!(M < Best.front()))
+          return;
+        std::pop_heap(Best.begin(), Best.end());
+        Best.pop_back();
+      }
+      Best.push_back(M);
+      std::push_heap(Best.begin(), Best.end());
+    };
+
+    if (Nodes.empty()) {
+      for (unsigned I = 0, E = Dictionary.size(); I != E; ++I) {
+        StringRef Entry = Dictionary[I];
+        // The distance is at least the difference in length.
+        size_t LengthDiff = std::max(Entry.size(), Query.size()) -
+                            std::min(Entry.size(), Query.size());
+        if (LengthDiff > Radius())
+          continue;
+        Consider(I, distance(Pattern, Entry));
+      }
+    } else {
+      SmallVector<unsigned, 32> Worklist = {0};
+      while (!Worklist.empty()) {
+        const Node &N = Nodes[Worklist.pop_back_val()];
+        unsigned D = distance(Pattern, Dictionary[N.Index]);
+        Consider(N.Index, D);
+        // Every entry below a child at distance E from N is at distance E from
+        // N, so by the triangle inequality it is at least |D - E| from the
+        // query.
+        unsigned R = Radius();
+        for (unsigned C = N.FirstChild; C != NoNode;
+             C = Nodes[C].NextSibling) {
+          unsigned E = Nodes[C].Distance;
+          if ((E > D ? E - D : D - E) <= R)
+            Worklist.push_back(C);
+        }
+      }
+    }
+
+    std::sort_heap(Best.begin(), Best.end());
+    return Best;
+  }
+
+private:
+  static constexpr unsigned NoNode = std::numeric_limits<unsigned>::max();
+
+  /// A BK-tree node. The children of a node are kept in a singly linked list.
+  struct Node {
+    unsigned Index;
+    /// The distance between this node's entry and its parent's.
+    unsigned Distance;
+    unsigned FirstChild;
+    unsigned NextSibling;
+  };
+
+  unsigned distance(const detail::BitParallelEditDistance &Pattern,
+                    StringRef Text) const {
+    return Pattern
+        .compute(
+            Text.size(), [&](size_t I) { return Text.bytes_begin()[I]; },
+            AllowReplacements)
+        .Distance;
+  }
+
+  void insert(unsigned Index) {
+    StringRef Entry = Dictionary[Index];
+    unsigned Current = 0;
+    for (;;) {
+      unsigned D = Dictionary[Nodes[Current].Index].edit_distance(
+          Entry, AllowReplacements);
+      unsigned *Link = &Nodes[Current].FirstChild;
+      while (*Link != NoNode && Nodes[*Link].Distance != D)
+        Link = &Nodes[*Link].NextSibling;
+      if (*Link == NoNode) {
+        *Link = Nodes.size();
+        Nodes.push_back({Index, D, NoNode, NoNode});
+        return;
+      }
+      Current = *Link;
+    }
+  }
+
+  ArrayRef<StringRef> Dictionary;
+  bool AllowReplacements;
+  std::vector<Node> Nodes;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_EDITDISTANCEINDEX_H
@@ -0,0 +1,210 @@
+//===- FlatScopedHashTable.h - A scoped hash table over a log ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements FlatScopedHashTable, a scoped hash table with the same
+// interface as ScopedHashTable but without a heap node per insertion:
+//
+//  FlatScopedHashTable<int, int> HT;
+//  {
+//    FlatScopedHashTableScope<int, int> Scope1(HT);
+//    HT.insert(0, 0);
+//    HT.insert(1, 1);
+//    {
+//      FlatScopedHashTableScope<int, int> Scope2(HT);
+//      HT.insert(0, 42);
+//    }
+//  }
+//
+// All values live in a single vector in the order they were inserted, which
+// is also scope order, and the map holds the index of the innermost value for
+// each key. Each entry records the index of the value it shadows. Popping a
+// scope walks back over its entries, restoring the map, and truncates the
+// vector; a lookup is one map probe and one array access.
+//
+// Since values are only ever removed from the end, a value can only be
+// inserted into the current scope; there is no insertIntoScope(). References
+// to values are invalidated by insertions.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_FLATSCOPEDHASHTABLE_H
+#define LLVM_ADT_FLATSCOPEDHASHTABLE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/SmallVector.h"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+namespace llvm {
+
+template <typename K, typename V, typename KInfo = DenseMapInfo<K>>
+class FlatScopedHashTable;
+
+template <typename K, typename V, typename KInfo = DenseMapInfo<K>>
+class FlatScopedHashTableScope {
+  /// HT - The hashtable that we are active for.
+  FlatScopedHashTable<K, V, KInfo> &HT;
+
+  /// PrevScope - This is the scope that we are shadowing in HT.
+  FlatScopedHashTableScope *PrevScope;
+
+  /// FirstValInScope - The index of the first value inserted in this scope.
+  unsigned FirstValInScope;
+
+public:
+  FlatScopedHashTableScope(FlatScopedHashTable<K, V, KInfo> &HT);
+  FlatScopedHashTableScope(FlatScopedHashTableScope &) = delete;
+  FlatScopedHashTableScope &operator=(FlatScopedHashTableScope &) = delete;
+  ~FlatScopedHashTableScope();
+
+  FlatScopedHashTableScope *getParentScope() { return PrevScope; }
+  const FlatScopedHashTableScope *getParentScope() const { return PrevScope; }
+};
+
+template <typename K, typename V, typename KInfo> class FlatScopedHashTable {
+public:
+  /// ScopeTy - A type alias for easy access to the name of the scope for this
+  /// hash table.
+  using ScopeTy = FlatScopedHashTableScope<K, V, KInfo>;
+  using size_type = unsigned;
+
+private:
+  friend class FlatScopedHashTableScope<K, V, KInfo>;
+
+  static constexpr unsigned NoVal = std::numeric_limits<unsigned>::max();
+
+  struct ValTy {
+    K Key;
+    V Val;
+    /// The index of the value this one shadows, or NoVal.
+    unsigned NextForKey;
+  };
+
+  /// Vals - Every value in the table, in scope order.
+  SmallVector<ValTy, 0> Vals;
+  /// TopLevelMap - The index of the innermost value of each key.
+  DenseMap<K, unsigned, KInfo> TopLevelMap;
+  ScopeTy *CurScope = nullptr;
+
+public:
+  FlatScopedHashTable() = default;
+  FlatScopedHashTable(const FlatScopedHashTable &) = delete;
+  FlatScopedHashTable &operator=(const FlatScopedHashTable &) = delete;
+
+  ~FlatScopedHashTable() {
+    assert(!CurScope && TopLevelMap.empty() && "Scope imbalance!");
+  }
+
+  /// Return 1 if the specified key is in the table, 0 otherwise.
+  size_type count(const K &Key) const { return TopLevelMap.count(Key); }
+
+  V lookup(const K &Key) const {
+    auto I = TopLevelMap.find(Key);
+    if (I != TopLevelMap.end())
+      return Vals[I->second].Val;
+
+    return V();
+  }
+
+  /// Insert \p Val for \p Key into the current scope, shadowing any value the
+  /// key already has until the scope is popped.
+  void insert(const K &Key, const V &Val) {
+    assert(CurScope && "No scope active!");
+    auto [I, Inserted] = TopLevelMap.try_emplace(Key, Vals.size());
+    Vals.push_back({Key, Val, Inserted ? NoVal : I->second});
+    I->second = Vals.size() - 1;
+  }
+
+  /// Iterates over the values of a key, from the innermost scope outwards.
+  class iterator {
+    FlatScopedHashTable *HT = nullptr;
+    unsigned Idx = NoVal;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = V;
+    using difference_type = std::ptrdiff_t;
+    using pointer = V *;
+    using reference = V &;
+
+    iterator() = default;
+    iterator(FlatScopedHashTable *HT, unsigned Idx) : HT(HT), Idx(Idx) {}
+
+    V &operator*() const {
+      assert(Idx != NoVal && "Dereference end()");
+      return HT->Vals[Idx].Val;
+    }
+    V *operator->() const { return &**this; }
+
+    bool operator==(const iterator &RHS) const { return Idx == RHS.Idx; }
+    bool operator!=(const iterator &RHS) const { return Idx != RHS.Idx; }
+
+    iterator &operator++() { // Preincrement
+      assert(Idx != NoVal && "incrementing past end()");
+      Idx = HT->Vals[Idx].NextForKey;
+      return *this;
+    }
+    iterator operator++(int) { // Postincrement
+      iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+  };
+
+  iterator end() { return iterator(this, NoVal); }
+
+  iterator begin(const K &Key) {
+    auto I = TopLevelMap.find(Key);
+    if (I == TopLevelMap.end())
+      return end();
+    return iterator(this, I->second);
+  }
+
+  ScopeTy *getCurScope() { return CurScope; }
+  const ScopeTy *getCurScope() const { return CurScope; }
+
+  /// reserve - Make room for \p NumVals values in total, in all scopes, without
+  /// reallocating.
+  void reserve(unsigned NumVals) { Vals.reserve(NumVals); }
+};
+
+/// FlatScopedHashTableScope ctor - Install this as the current scope for the
+/// hash table.
+template <typename K, typename V, typename KInfo>
+FlatScopedHashTableScope<K, V, KInfo>::FlatScopedHashTableScope(
+    FlatScopedHashTable<K, V, KInfo> &HT)
+    : HT(HT), PrevScope(HT.CurScope), FirstValInScope(HT.Vals.size()) {
+  HT.CurScope = this;
+}
+
+template <typename K, typename V, typename KInfo>
+FlatScopedHashTableScope<K, V, KInfo>::~FlatScopedHashTableScope() {
+  assert(HT.CurScope == this && "Scope imbalance!");
+  HT.CurScope = PrevScope;
+
+  // Unshadow the values this scope hid, innermost first, then drop all of
+  // this scope's values at once.
+  for (unsigned I = HT.Vals.size(); I != FirstValInScope;) {
+    auto &ThisEntry = HT.Vals[--I];
+    auto KeyEntry = HT.TopLevelMap.find(ThisEntry.Key);
+    assert(KeyEntry != HT.TopLevelMap.end() && KeyEntry->second == I &&
+           "Scope imbalance!");
+    if (ThisEntry.NextForKey == HT.NoVal)
+      HT.TopLevelMap.erase(KeyEntry);
+    else
+      KeyEntry->second = ThisEntry.NextForKey;
+  }
+  HT.Vals.truncate(FirstValInScope);
+}
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_FLATSCOPEDHASHTABLE_H
@@ -11,7 +11,8 @@
 /// in `<function>`.
 ///
 /// It provides `unique_function`, which works like `std::function` but supports
-/// move-only callable objects and const-qualification.
+/// move-only callable objects, const-qualification and a configurable inline
+/// capacity.
 ///
 /// Future plans:
 /// - Add a `function` that provides ref-qualified support, which doesn't work
@@ -33,11 +34,11 @@
 #define LLVM_ADT_FUNCTIONEXTRAS_H
 
 #include "llvm/ADT/PointerIntPair.h"
-#include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/STLForwardCompat.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/MemAlloc.h"
 #include "llvm/Support/type_traits.h"
+#include <algorithm>
 #include <cstring>
 #include <type_traits>
 
@@ -53,7 +54,13 @@ namespace llvm {
 ///   It can only hold functions which themselves have a const operator().
 /// - unique_function<int()> has a non-const operator().
 ///   It can hold functions with a non-const operator(), like mutable lambdas.
-template <typename FunctionT> class unique_function;
+///
+/// Callables of up to InlineSize bytes are stored in the unique_function
+/// itself; larger ones are heap-allocated. InlineSize defaults to three
+/// pointers, and can be raised for callables with larger captures, e.g.
+/// unique_function<void(), 64>, at the cost of a larger unique_function.
+template <typename FunctionT, size_t InlineSize = sizeof(void *) * 3>
+class unique_function;
 
 namespace detail {
 
@@ -72,9 +79,15 @@ using EnableIfCallable = std::enable_if_t<std::disjunction<
                             std::declval<Params>()...)),
                         Ret>>::value>;
 
-template <typename ReturnT, typename... ParamTs> class UniqueFunctionBase {
+template <size_t InlineSize, typename ReturnT, typename... ParamTs>
+class UniqueFunctionBase {
 protected:
-  static constexpr size_t InlineStorageSize = sizeof(void *) * 3;
+  // Round the inline storage up to whole pointers, and make it large enough to
+  // hold the out-of-line storage.
+  static constexpr size_t InlineStorageSize =
+      std::max((InlineSize + sizeof(void *) - 1) / sizeof(void *) *
+                   sizeof(void *),
+               sizeof(void *) * 3);
   static constexpr size_t InlineStorageAlign = alignof(void *);
 
   // Provide a type function to map parameters that won't observe extra copies
@@ -108,8 +121,9 @@ protected:
   using AdjustedParamT = typename AdjustedParamTBase<T>::type;
 
   // The type of the erased function pointer we use as a callback to dispatch to
-  // the stored callable when it is trivial to move and destroy.
-  using CallPtrT = ReturnT (*)(void *CallableAddr,
+  // the stored callable. It is passed the address of the storage union, and
+  // knows whether the callable is inline or behind the out-of-line pointer.
+  using CallPtrT = ReturnT (*)(void *StorageAddr,
                                AdjustedParamT<ParamTs>... Params);
   using MovePtrT = void (*)(void *LHSCallableAddr, void *RHSCallableAddr);
   using DestroyPtrT = void (*)(void *CallableAddr);
@@ -121,18 +135,15 @@ protected:
   };
 
   /// A struct we use to aggregate three callbacks when we need full set of
-  /// operations.
-  struct alignas(8) NonTrivialCallbacks {
-    CallPtrT CallPtr;
+  /// operations. It starts with a TrivialCallback, so that the call pointer is
+  /// found the same way for both kinds of callables.
+  struct alignas(8) NonTrivialCallbacks : TrivialCallback {
     MovePtrT MovePtr;
     DestroyPtrT DestroyPtr;
   };
 
-  // Create a pointer union between either a pointer to a static trivial call
-  // pointer in a struct or a pointer to a static struct of the call, move, and
-  // destroy pointers.
-  using CallbackPointerUnionT =
-      PointerUnion<TrivialCallback *, NonTrivialCallbacks *>;
+  // The flags stored next to the callback pointer.
+  static constexpr unsigned InlineStorageFlag = 1, NonTrivialCallbacksFlag = 2;
 
   // The main storage buffer. This will either have a pointer to out-of-line
   // storage or an inline buffer storing the callable.
@@ -157,28 +168,24 @@ protected:
   } StorageUnion;
 
   // A compressed pointer to either our dispatching callback or our table of
-  // dispatching callbacks and the flag for whether the callable itself is
-  // stored inline or not.
-  PointerIntPair<CallbackPointerUnionT, 1, bool> CallbackAndInlineFlag;
+  // dispatching callbacks, with flags for whether the callable itself is stored
+  // inline and whether the pointer is to the full table.
+  PointerIntPair<TrivialCallback *, 2, unsigned> CallbackAndFlags;
 
-  bool isInlineStorage() const { return CallbackAndInlineFlag.getInt(); }
-
-  bool isTrivialCallback() const {
-    return isa<TrivialCallback *>(CallbackAndInlineFlag.getPointer());
+  bool isInlineStorage() const {
+    return CallbackAndFlags.getInt() & InlineStorageFlag;
   }
 
-  CallPtrT getTrivialCallback() const {
-    return cast<TrivialCallback *>(CallbackAndInlineFlag.getPointer())->CallPtr;
+  bool isTrivialCallback() const {
+    return !(CallbackAndFlags.getInt() & NonTrivialCallbacksFlag);
   }
 
   NonTrivialCallbacks *getNonTrivialCallbacks() const {
-    return cast<NonTrivialCallbacks *>(CallbackAndInlineFlag.getPointer());
+    return static_cast<NonTrivialCallbacks *>(CallbackAndFlags.getPointer());
   }
 
-  CallPtrT getCallPtr() const {
-    return isTrivialCallback() ? getTrivialCallback()
-                               : getNonTrivialCallbacks()->CallPtr;
-  }
+  // Calls load the call pointer without branching on either flag.
+  CallPtrT getCallPtr() const { return CallbackAndFlags.getPointer()->CallPtr; }
 
   // These three functions are only const in the narrow sense. They return
   // mutable pointers to function state.
@@ -186,8 +193,8 @@ protected:
   // underlying functor may be internally mutable.
   //
   // const callers must ensure they're only used in const-correct ways.
-  void *getCalleePtr() const {
-    return isInlineStorage() ? getInlineStorage() : getOutOfLineStorage();
+  void *getStorage() const {
+    return const_cast<StorageUnionT *>(&StorageUnion);
   }
   void *getInlineStorage() const { return &StorageUnion.InlineStorage; }
   void *getOutOfLineStorage() const {
@@ -205,9 +212,13 @@ protected:
     StorageUnion.OutOfLineStorage = {Ptr, Size, Alignment};
   }
 
-  template <typename CalledAsT>
-  static ReturnT CallImpl(void *CallableAddr,
+  template <typename CalledAsT, bool IsInlineStorage>
+  static ReturnT CallImpl(void *StorageAddr,
                           AdjustedParamT<ParamTs>... Params) {
+    auto *Storage = static_cast<StorageUnionT *>(StorageAddr);
+    void *CallableAddr = IsInlineStorage
+                             ? static_cast<void *>(Storage->InlineStorage)
+                             : Storage->OutOfLineStorage.StoragePtr;
     auto &Func = *reinterpret_cast<CalledAsT *>(CallableAddr);
     return Func(std::forward<ParamTs>(Params)...);
   }
@@ -223,6 +234,12 @@ protected:
     reinterpret_cast<CallableT *>(CallableAddr)->~CallableT();
   }
 
+  // Callables which are trivial to move and destroy only need a call pointer.
+  template <typename CallableT>
+  static constexpr bool IsTrivial =
+      std::is_trivially_move_constructible_v<CallableT> &&
+      std::is_trivially_destructible_v<CallableT>;
+
   // The pointers to call/move/destroy functions are determined for each
   // callable type (and called-as type, which determines the overload chosen).
 
@@ -230,15 +247,16 @@ protected:
   // type erased behaviors needed. Create a static instance of the struct type
   // here and each instance will contain a pointer to it.
   // Wrap in a struct to avoid https://gcc.gnu.org/PR71954
-  template <typename CallableT, typename CalledAs> struct CallbacksHolder {
+  template <typename CallableT, typename CalledAs, bool IsInlineStorage>
+  struct CallbacksHolder {
     inline static auto Callbacks = []() constexpr {
       // For trivial callables, we don't need to store move and destroy
       // callbacks.
-      if constexpr (std::is_trivially_move_constructible_v<CallableT> &&
-                    std::is_trivially_destructible_v<CallableT>)
-        return TrivialCallback{&CallImpl<CalledAs>};
+      if constexpr (IsTrivial<CallableT>)
+        return TrivialCallback{&CallImpl<CalledAs, IsInlineStorage>};
       else
-        return NonTrivialCallbacks{&CallImpl<CalledAs>, &MoveImpl<CallableT>,
+        return NonTrivialCallbacks{{&CallImpl<CalledAs, IsInlineStorage>},
+                                   &MoveImpl<CallableT>,
                                    &DestroyImpl<CallableT>};
     }();
   };
@@ -251,11 +269,10 @@ protected:
   // (We always store a T, even if the call will use a pointer to const T).
   template <typename CallableT, typename CalledAsT>
   UniqueFunctionBase(CallableT Callable, CalledAs<CalledAsT>) {
-    bool IsInlineStorage = true;
+    constexpr bool IsInlineStorage = sizeof(CallableT) <= InlineStorageSize &&
+                                     alignof(CallableT) <= InlineStorageAlign;
     void *CallableAddr = getInlineStorage();
-    if (sizeof(CallableT) > InlineStorageSize ||
-        alignof(CallableT) > InlineStorageAlign) {
-      IsInlineStorage = false;
+    if constexpr (!IsInlineStorage) {
       // Allocate out-of-line storage. FIXME: Use an explicit alignment
       // parameter in C++17 mode.
       auto Size = sizeof(CallableT);
@@ -266,12 +283,14 @@ protected:
 
     // Now move into the storage.
     new (CallableAddr) CallableT(std::move(Callable));
-    CallbackAndInlineFlag.setPointerAndInt(
-        &CallbacksHolder<CallableT, CalledAsT>::Callbacks, IsInlineStorage);
+    CallbackAndFlags.setPointerAndInt(
+        &CallbacksHolder<CallableT, CalledAsT, IsInlineStorage>::Callbacks,
+        (IsInlineStorage ? InlineStorageFlag : 0) |
+            (IsTrivial<CallableT> ? 0 : NonTrivialCallbacksFlag));
   }
 
   ~UniqueFunctionBase() {
-    if (!CallbackAndInlineFlag.getPointer())
+    if (!CallbackAndFlags.getPointer())
       return;
 
     // Cache this value so we don't re-check it after type-erased operations.
@@ -287,8 +306,8 @@ protected:
   }
 
   UniqueFunctionBase(UniqueFunctionBase &&RHS) noexcept {
-    // Copy the callback and inline flag.
-    CallbackAndInlineFlag = RHS.CallbackAndInlineFlag;
+    // Copy the callback and flags.
+    CallbackAndFlags = RHS.CallbackAndFlags;
 
     // If the RHS is empty, just copying the above is sufficient.
     if (!RHS)
@@ -307,8 +326,8 @@ protected:
       getNonTrivialCallbacks()->DestroyPtr(RHS.getInlineStorage());
     }
 
-    // Clear the old callback and inline flag to get back to as-if-null.
-    RHS.CallbackAndInlineFlag = {};
+    // Clear the old callback and flags to get back to as-if-null.
+    RHS.CallbackAndFlags = {};
 
 #if !defined(NDEBUG) && !LLVM_ADDRESS_SANITIZER_BUILD
     // In debug builds without ASan, we also scribble across the rest of the
@@ -334,15 +353,16 @@ protected:
 
 public:
   explicit operator bool() const {
-    return (bool)CallbackAndInlineFlag.getPointer();
+    return (bool)CallbackAndFlags.getPointer();
   }
 };
 
 } // namespace detail
 
-template <typename R, typename... P>
-class unique_function<R(P...)> : public detail::UniqueFunctionBase<R, P...> {
-  using Base = detail::UniqueFunctionBase<R, P...>;
+template <size_t InlineSize, typename R, typename... P>
+class unique_function<R(P...), InlineSize>
+    : public detail::UniqueFunctionBase<InlineSize, R, P...> {
+  using Base = detail::UniqueFunctionBase<InlineSize, R, P...>;
 
 public:
   unique_function() = default;
@@ -361,14 +381,14 @@ public:
              typename Base::template CalledAs<CallableT>{}) {}
 
   R operator()(P... Params) {
-    return this->getCallPtr()(this->getCalleePtr(), Params...);
+    return this->getCallPtr()(this->getStorage(), Params...);
   }
 };
 
-template <typename R, typename... P>
-class unique_function<R(P...) const>
-    : public detail::UniqueFunctionBase<R, P...> {
-  using Base = detail::UniqueFunctionBase<R, P...>;
+template <size_t InlineSize, typename R, typename... P>
+class unique_function<R(P...) const, InlineSize>
+    : public detail::UniqueFunctionBase<InlineSize, R, P...> {
+  using Base = detail::UniqueFunctionBase<InlineSize, R, P...>;
 
 public:
   unique_function() = default;
@@ -387,7 +407,7 @@ public:
              typename Base::template CalledAs<const CallableT>{}) {}
 
   R operator()(P... Params) const {
-    return this->getCallPtr()(this->getCalleePtr(), Params...);
+    return this->getCallPtr()(this->getStorage(), Params...);
   }
 };
 
@@ -0,0 +1,262 @@
+//===- llvm/ADT/IndexedPriorityQueue.h - Addressable heap -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines the IndexedPriorityQueue class, a priority queue whose
+/// elements can be found, reprioritized and erased by key.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_INDEXEDPRIORITYQUEUE_H
+#define LLVM_ADT_INDEXEDPRIORITYQUEUE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLForwardCompat.h"
+#include "llvm/ADT/SmallVector.h"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace llvm {
+
+/// A position map for IndexedPriorityQueue whose keys map to small, dense
+/// integers, such as node or register numbers. It is a plain array indexed by
+/// ToIndexT(Key), which avoids hashing on every move of a heap element.
+template <typename KeyT, typename ToIndexT = identity> class DensePositionMap {
+  SmallVector<unsigned, 0> Slots;
+  ToIndexT ToIndex;
+
+public:
+  unsigned lookup(const KeyT &Key) const {
+    size_t Idx = ToIndex(Key);
+    return Idx < Slots.size() ? Slots[Idx] : 0;
+  }
+
+  unsigned &operator[](const KeyT &Key) {
+    size_t Idx = ToIndex(Key);
+    if (Idx >= Slots.size())
+      Slots.resize(Idx + 1);
+    return Slots[Idx];
+  }
+
+  void erase(const KeyT &Key) {
+    size_t Idx = ToIndex(Key);
+    if (Idx < Slots.size())
+      Slots[Idx] = 0;
+  }
+
+  void clear() { Slots.clear(); }
+};
+
+/// A priority queue of unique keys, each with a priority, which supports
+/// changing the priority of a key and erasing a key in O(log n), as needed by
+/// shortest-path searches and list schedulers.
+///
+/// Like std::priority_queue, top() is the key whose priority is the greatest
+/// according to Compare; use std::greater for a min-queue.
+///
+/// The queue is an Arity-ary heap of (key, priority) pairs. A wider heap is
+/// shallower, so pushes and priority increases, which sift up, touch fewer
+/// levels, and the children of a node share a cache line. MapT records the
+/// position of every key in the heap. It must provide lookup(), operator[],
+/// erase() and clear() like DenseMap<KeyT, unsigned>, which is the default;
+/// DensePositionMap is faster when keys are dense integers.
+template <typename KeyT, typename PriorityT,
+          typename Compare = std::less<PriorityT>, unsigned Arity = 4,
+          typename MapT = DenseMap<KeyT, unsigned>>
+class IndexedPriorityQueue {
+  static_assert(Arity >= 2, "A heap needs at least two children per node");
+
+  struct Entry {
+    KeyT Key;
+    PriorityT Priority;
+  };
+
+  SmallVector<Entry, 0> Heap;
+  /// Maps each key to its position in Heap plus one, so that zero, the value
+  /// of a missing key, means "not in the queue".
+  MapT Positions;
+  Compare Comp;
+
+  /// Store \p E at \p Pos, and record its new position.
+  void place(unsigned Pos, Entry &&E) {
+    Positions[E.Key] = Pos + 1;
+    Heap[Pos] = std::move(E);
+  }
+
+  void siftUp(unsigned Pos) {
+    Entry E = std::move(Heap[Pos]);
+    while (Pos != 0) {
+      unsigned Parent = (Pos - 1) / Arity;
+      if (!Comp(Heap[Parent].Priority, E.Priority))
+        break;
+      place(Pos, std::move(Heap[Parent]));
+      Pos = Parent;
+    }
+    place(Pos, std::move(E));
+  }
+
+  void siftDown(unsigned Pos) {
+    size_t Size = Heap.size();
+    Entry E = std::move(Heap[Pos]);
+    while (true) {
+      size_t First = size_t(Pos) * Arity + 1;
+      if (First >= Size)
+        break;
+      size_t Last = std::min<size_t>(First + Arity, Size);
+      size_t Best = First;
+      for (size_t Child = First + 1; Child < Last; ++Child)
+        if (Comp(Heap[Best].Priority, Heap[Child].Priority))
+          Best = Child;
+      if (!Comp(E.Priority, Heap[Best].Priority))
+        break;
+      place(Pos, std::move(Heap[Best]));
+      Pos = Best;
+    }
+    place(Pos, std::move(E));
+  }
+
+  /// Restore the heap property around \p Pos, whose priority changed.
+  void fixup(unsigned Pos) {
+    if (Pos != 0 && Comp(Heap[(Pos - 1) / Arity].Priority, Heap[Pos].Priority))
+      siftUp(Pos);
+    else
+      siftDown(Pos);
+  }
+
+  /// Remove the entry at \p Pos, whose key has already been dropped from
+  /// Positions.
+  void removeAt(unsigned Pos) {
+    Entry Last = Heap.pop_back_val();
+    if (Pos == Heap.size())
+      return;
+    Heap[Pos] = std::move(Last);
+    fixup(Pos);
+  }
+
+public:
+  using key_type = KeyT;
+  using priority_type = PriorityT;
+  using size_type = unsigned;
+
+  explicit IndexedPriorityQueue(const Compare &Comp = Compare())
+      : Comp(Comp) {}
+
+  bool empty() const { return Heap.empty(); }
+  size_type size() const { return Heap.size(); }
+
+  void reserve(size_type N) { Heap.reserve(N); }
+
+  void clear() {
+    Heap.clear();
+    Positions.clear();
+  }
+
+  /// Return true if \p Key is in the queue.
+  bool contains(const KeyT &Key) const { return Positions.lookup(Key) != 0; }
+
+  /// Return the priority of \p Key, which must be in the queue.
+  const PriorityT &getPriority(const KeyT &Key) const {
+    unsigned Pos = Positions.lookup(Key);
+    assert(Pos && "Key is not in the queue!");
+    return Heap[Pos - 1].Priority;
+  }
+
+  /// Return the key with the greatest priority.
+  const KeyT &top() const {
+    assert(!empty() && "Cannot call top() on an empty queue!");
+    return Heap.front().Key;
+  }
+
+  /// Return the priority of top().
+  const PriorityT &topPriority() const {
+    assert(!empty() && "Cannot call topPriority() on an empty queue!");
+    return Heap.front().Priority;
+  }
+
+  /// Add \p Key, which must not be in the queue yet, with priority \p P.
+  void push(const KeyT &Key, PriorityT P) {
+    assert(!contains(Key) && "Key is already in the queue!");
+    Heap.push_back({Key, std::move(P)});
+    siftUp(Heap.size() - 1);
+  }
+
+  /// Remove top() from the queue.
+  void pop() {
+    assert(!empty() && "Cannot pop an empty queue!");
+    Positions.erase(Heap.front().Key);
+    removeAt(0);
+  }
+
+  /// Remove top() from the queue and return it.
+  [[nodiscard]] KeyT pop_top() {
+    KeyT Key = top();
+    pop();
+    return Key;
+  }
+
+  /// Set the priority of \p Key to \p P, moving it up or down the heap, or add
+  /// it if it is not in the queue. Return true if \p Key was added.
+  bool update(const KeyT &Key, PriorityT P) {
+    unsigned Pos = Positions.lookup(Key);
+    if (!Pos) {
+      push(Key, std::move(P));
+      return true;
+    }
+    Heap[Pos - 1].Priority = std::move(P);
+    fixup(Pos - 1);
+    return false;
+  }
+
+  /// Remove \p Key from the queue. Return true if it was in the queue.
+  bool erase(const KeyT &Key) {
+    unsigned Pos = Positions.lookup(Key);
+    if (!Pos)
+      return false;
+    Positions.erase(Key);
+    removeAt(Pos - 1);
+    return true;
+  }
+
+  /// Add a sequence of (key, priority) pairs whose keys are distinct and not
+  /// in the queue yet. When the sequence is at least as long as the queue, the
+  /// heap is rebuilt bottom-up in linear time instead of sifting up each new
+  /// key.
+  template <typename RangeT> void insert(RangeT &&Entries) {
+    size_t OldSize = Heap.size();
+    for (auto &&[Key, P] : Entries) {
+      assert(!contains(Key) && "Key is already in the queue!");
+      Heap.push_back({Key, P});
+    }
+    // A key repeated in the sequence is only caught once the first copy has
+    // a position.
+    size_t NewSize = Heap.size();
+    if (NewSize - OldSize < OldSize) {
+      for (size_t Pos = OldSize; Pos != NewSize; ++Pos) {
+        assert(!contains(Heap[Pos].Key) && "Key is repeated in the sequence!");
+        siftUp(Pos);
+      }
+      return;
+    }
+    for (size_t Pos = 0; Pos != NewSize; ++Pos) {
+      assert((Pos < OldSize || !contains(Heap[Pos].Key)) &&
+             "Key is repeated in the sequence!");
+      Positions[Heap[Pos].Key] = Pos + 1;
+    }
+    if (NewSize < 2)
+      return;
+    for (size_t Pos = (NewSize - 2) / Arity + 1; Pos-- != 0;)
+      siftDown(Pos);
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_INDEXEDPRIORITYQUEUE_H
@@ -0,0 +1,310 @@
+//===- llvm/ADT/RoaringBitVector.h - A roaring bitmap -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// A compressed bitvector in the style of roaring bitmaps, for sets that mix
+/// dense regions, long runs and scattered bits.
+///
+/// The 32-bit index space is split into blocks of 65536 bits, keyed by the
+/// high 16 bits of an index. Each non-empty block is stored in whichever of
+/// three containers suits it:
+///
+///  - an array container, a sorted array of the low 16 bits of each member,
+///    for blocks with at most 4096 members;
+///  - a bitmap container, 1024 64-bit words, for denser blocks;
+///  - a run container, a sorted list of [Start, Last] intervals, for blocks
+///    made of long runs. These come from set(Begin, End) and runOptimize().
+///
+/// Every container caches its number of members, so count() only adds up one
+/// number per block, and set operations between two bitmaps run a word at a
+/// time over flat arrays.
+///
+/// The set operations mirror those of SparseBitVector. A RoaringBitVector can
+/// also be written to a flat buffer, which RoaringBitVectorView can query in
+/// place, e.g. from a memory-mapped file.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_ROARINGBITVECTOR_H
+#define LLVM_ADT_ROARINGBITVECTOR_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <iterator>
+
+namespace llvm {
+
+class raw_ostream;
+class RoaringBitVectorView;
+
+class RoaringBitVector {
+public:
+  /// The kinds of container a block can be stored in.
+  enum ContainerKind : uint8_t {
+    ArrayContainer,
+    BitmapContainer,
+    RunContainer
+  };
+
+  /// The number of bits in a block.
+  static constexpr unsigned BlockSize = 1u << 16;
+  /// The most members an array container holds before becoming a bitmap.
+  static constexpr unsigned MaxArraySize = 4096;
+  /// The number of words in a bitmap container.
+  static constexpr unsigned BitmapWords = BlockSize / 64;
+
+private:
+  friend class RoaringBitVectorView;
+
+  struct Container {
+    /// The high 16 bits of the members of this block.
+    uint16_t Key;
+    ContainerKind Kind;
+    /// The number of members, 1 .. BlockSize.
+    uint32_t Cardinality = 0;
+    /// The sorted members of an array container, or the Start and Last of
+    /// each interval of a run container, in pairs.
+    SmallVector<uint16_t, 0> Values;
+    /// The BitmapWords words of a bitmap container.
+    SmallVector<uint64_t, 0> Words;
+
+    Container(uint16_t Key, ContainerKind Kind) : Key(Key), Kind(Kind) {}
+
+    unsigned getNumRuns() const { return Values.size() / 2; }
+    uint16_t runStart(unsigned I) const { return Values[2 * I]; }
+    uint16_t runLast(unsigned I) const { return Values[2 * I + 1]; }
+    /// Return the first run whose last member is not below \p Low.
+    unsigned findRun(unsigned Low) const;
+    /// Return the number of runs the members of this container form.
+    unsigned getRunCount() const;
+    /// Return the size of the serialized members of this container.
+    size_t getPayloadBytes() const;
+
+    bool test(uint16_t Low) const;
+    bool set(uint16_t Low);
+    bool reset(uint16_t Low);
+    int findFirst() const;
+    int findLast() const;
+    /// Return the first member not below \p From, or -1.
+    int findNext(unsigned From) const;
+
+    /// Store the members of this container into \p Out as a bitmap.
+    void toWords(uint64_t *Out) const;
+    /// Convert this container to a bitmap container.
+    void makeBitmap();
+    /// Pick an array or bitmap container for the members in Words, whose
+    /// Cardinality is up to date.
+    void shrinkBitmap();
+    /// Convert a run container to an array or bitmap container.
+    void makeArrayOrBitmap();
+    /// Convert this container to the kind that needs the least memory.
+    bool runOptimize();
+
+    bool unionWith(const Container &RHS);
+    bool intersectWith(const Container &RHS);
+    bool intersectWithComplement(const Container &RHS);
+    bool intersects(const Container &RHS) const;
+    bool operator==(const Container &RHS) const;
+  };
+
+  /// The non-empty blocks, sorted by key.
+  SmallVector<Container, 0> Containers;
+
+  /// Return the first container whose key is not below \p Key.
+  Container *findContainer(uint16_t Key);
+  const Container *findContainer(uint16_t Key) const {
+    return const_cast<RoaringBitVector *>(this)->findContainer(Key);
+  }
+
+public:
+  class iterator {
+    const RoaringBitVector *BV = nullptr;
+    /// The container of the current member, or Containers.size() at the end.
+    unsigned ContainerIdx = 0;
+    /// The position of the current member within its array container, or of
+    /// its interval within its run container.
+    unsigned Pos = 0;
+    unsigned Value = 0;
+
+    LLVM_ABI void advance();
+    LLVM_ABI void settle();
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = unsigned;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const unsigned *;
+    using reference = const unsigned &;
+
+    iterator() = default;
+    iterator(const RoaringBitVector *BV, bool End) : BV(BV) {
+      if (End)
+        ContainerIdx = BV->Containers.size();
+      else
+        settle();
+    }
+
+    iterator &operator++() {
+      advance();
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator Tmp = *this;
+      advance();
+      return Tmp;
+    }
+
+    unsigned operator*() const { return Value; }
+
+    bool operator==(const iterator &RHS) const {
+      if (ContainerIdx != RHS.ContainerIdx)
+        return false;
+      return ContainerIdx == BV->Containers.size() || Value == RHS.Value;
+    }
+    bool operator!=(const iterator &RHS) const { return !(*this == RHS); }
+  };
+
+  RoaringBitVector() = default;
+
+  void clear() { Containers.clear(); }
+
+  // Test, Reset, and Set a bit in the bitmap.
+  LLVM_ABI bool test(unsigned Idx) const;
+  LLVM_ABI void reset(unsigned Idx);
+  void set(unsigned Idx) { test_and_set(Idx); }
+  /// Set the bit at \p Idx, and return true if it was not set before.
+  LLVM_ABI bool test_and_set(unsigned Idx);
+
+  /// Set the bits in [Begin, End). Whole blocks in the range are stored as run
+  /// containers.
+  LLVM_ABI void set(unsigned Begin, unsigned End);
+
+  LLVM_ABI bool operator==(const RoaringBitVector &RHS) const;
+  bool operator!=(const RoaringBitVector &RHS) const { return !(*this == RHS); }
+
+  /// Union our bitmap with the RHS and return true if we changed.
+  LLVM_ABI bool operator|=(const RoaringBitVector &RHS);
+
+  /// Intersect our bitmap with the RHS and return true if ours changed.
+  LLVM_ABI bool operator&=(const RoaringBitVector &RHS);
+
+  /// Intersect our bitmap with the complement of the RHS and return true if
+  /// ours changed.
+  LLVM_ABI bool intersectWithComplement(const RoaringBitVector &RHS);
+
+  /// Store RHS1 & ~RHS2 into this bitmap.
+  LLVM_ABI void intersectWithComplement(const RoaringBitVector &RHS1,
+                                        const RoaringBitVector &RHS2);
+
+  /// Return true if we share any bits in common with RHS.
+  LLVM_ABI bool intersects(const RoaringBitVector &RHS) const;
+
+  /// Return true iff all bits set in RHS are also set in this bitmap.
+  LLVM_ABI bool contains(const RoaringBitVector &RHS) const;
+
+  /// Return the first set bit in the bitmap. Return -1 if no bits are set.
+  /// Indices span all 32 bits, so the result does not fit in an int.
+  LLVM_ABI int64_t find_first() const;
+
+  /// Return the last set bit in the bitmap. Return -1 if no bits are set.
+  LLVM_ABI int64_t find_last() const;
+
+  bool empty() const { return Containers.empty(); }
+
+  /// Return the number of set bits.
+  uint64_t count() const {
+    uint64_t BitCount = 0;
+    for (const Container &C : Containers)
+      BitCount += C.Cardinality;
+    return BitCount;
+  }
+
+  iterator begin() const { return iterator(this, false); }
+  iterator end() const { return iterator(this, true); }
+
+  /// Store each block in the kind of container that needs the least memory,
+  /// turning blocks made of long runs into run containers. Return true if any
+  /// container changed kind.
+  LLVM_ABI bool runOptimize();
+
+  /// Return the number of blocks stored in each kind of container.
+  LLVM_ABI unsigned getNumContainers(ContainerKind Kind) const;
+
+  /// Return the size of the flat buffer written by serialize().
+  LLVM_ABI size_t getSerializedSize() const;
+
+  /// Append the flat, little-endian form of this bitmap to \p Out. This can
+  /// be queried in place with RoaringBitVectorView, or read back with
+  /// deserialize().
+  LLVM_ABI void serialize(SmallVectorImpl<char> &Out) const;
+
+  /// Read a bitmap written by serialize(), checking that it is well formed.
+  LLVM_ABI static Expected<RoaringBitVector> deserialize(StringRef Buffer);
+};
+
+/// A read-only view of a RoaringBitVector serialized into a flat buffer, which
+/// answers queries without copying the buffer. The buffer must outlive the
+/// view.
+class RoaringBitVectorView {
+  StringRef Buffer;
+  unsigned NumContainers = 0;
+
+  RoaringBitVectorView(StringRef Buffer, unsigned NumContainers)
+      : Buffer(Buffer), NumContainers(NumContainers) {}
+
+  uint16_t getKey(unsigned I) const;
+  RoaringBitVector::ContainerKind getKind(unsigned I) const;
+  uint32_t getCardinality(unsigned I) const;
+  const char *getPayload(unsigned I) const;
+  uint32_t getPayloadSize(unsigned I) const;
+
+  friend class RoaringBitVector;
+
+public:
+  /// Create a view of \p Buffer, checking that its header and container
+  /// descriptors are well formed.
+  LLVM_ABI static Expected<RoaringBitVectorView> create(StringRef Buffer);
+
+  LLVM_ABI bool test(unsigned Idx) const;
+  LLVM_ABI uint64_t count() const;
+  bool empty() const { return NumContainers == 0; }
+};
+
+// Convenience functions for infix union, intersection, difference operators.
+
+inline RoaringBitVector operator|(const RoaringBitVector &LHS,
+                                  const RoaringBitVector &RHS) {
+  RoaringBitVector Result(LHS);
+  Result |= RHS;
+  return Result;
+}
+
+inline RoaringBitVector operator&(const RoaringBitVector &LHS,
+                                  const RoaringBitVector &RHS) {
+  RoaringBitVector Result(LHS);
+  Result &= RHS;
+  return Result;
+}
+
+inline RoaringBitVector operator-(const RoaringBitVector &LHS,
+                                  const RoaringBitVector &RHS) {
+  RoaringBitVector Result;
+  Result.intersectWithComplement(LHS, RHS);
+  return Result;
+}
+
+/// Dump a RoaringBitVector to a stream.
+LLVM_ABI void dump(const RoaringBitVector &LHS, raw_ostream &out);
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_ROARINGBITVECTOR_H
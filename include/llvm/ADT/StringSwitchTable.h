@@ -0,0 +1,243 @@
+//===- llvm/ADT/StringSwitchTable.h - Perfect-hash StringSwitch -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines StringSwitchTable, a StringSwitch over a fixed set of
+/// cases whose perfect hash table is built at compile time.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_STRINGSWITCHTABLE_H
+#define LLVM_ADT_STRINGSWITCHTABLE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace llvm {
+
+namespace detail {
+
+/// A perfect hash of a fixed set of N strings, built at compile time, which
+/// maps each string to its index in the set.
+///
+/// It uses hash-and-displace: each string is hashed once, the high bits of
+/// the hash pick a bucket, and the bucket's displacement, chosen at build time
+/// so that no two strings collide, mixes the hash into a slot of the table.
+/// find() returns the index stored in the slot of its input, which the caller
+/// must compare against the input, since strings out of the set land in
+/// arbitrary slots.
+template <size_t N> class StringPerfectHash {
+  static_assert(N > 0, "A perfect hash needs at least one string");
+  static_assert(N < 0xffff, "Too many strings for a perfect hash");
+
+  /// About two strings per bucket, and a table at most 80% full.
+  static constexpr size_t NumBuckets = NextPowerOf2((N + 1) / 2 - 1);
+  static constexpr size_t NumSlots = NextPowerOf2(N + N / 4 - 1);
+
+  /// The displacement of each bucket.
+  std::array<uint16_t, NumBuckets> Displacements = {};
+  /// The index of the string stored in each slot, or NotFound.
+  std::array<uint16_t, NumSlots> Slots = {};
+
+  /// The finalizer of MurmurHash3, which spreads every input bit over all the
+  /// output bits.
+  static constexpr uint64_t mix(uint64_t H) {
+    H ^= H >> 33;
+    H *= 0xff51afd7ed558ccdULL;
+    H ^= H >> 33;
+    return H;
+  }
+
+  static constexpr uint64_t hash(StringRef S) {
+    // FNV-1a, whose high bits depend little on the last characters of short
+    // strings until they are mixed.
+    uint64_t H = 0xcbf29ce484222325ULL;
+    for (size_t I = 0, E = S.size(); I != E; ++I) {
+      H ^= uint8_t(S.data()[I]);
+      H *= 0x100000001b3ULL;
+    }
+    return mix(H);
+  }
+
+  static constexpr size_t getBucket(uint64_t H) {
+    return (H >> 32) & (NumBuckets - 1);
+  }
+
+  /// Every displacement scatters the strings of a bucket differently.
+  static constexpr size_t getSlot(uint64_t H, uint16_t Displacement) {
+    return mix(H + Displacement * 0x9e3779b97f4a7c15ULL) & (NumSlots - 1);
+  }
+
+public:
+  static constexpr uint16_t NotFound = 0xffff;
+
+  /// Build the hash of the strings Key(0) to Key(N - 1). When a string
+  /// appears several times, only its first index is stored.
+  template <typename KeyFnT> constexpr void build(KeyFnT Key) {
+    for (uint16_t &Slot : Slots)
+      Slot = NotFound;
+
+    // Group the strings by bucket, keeping the order of the strings within
+    // each bucket.
+    std::array<uint64_t, N> Hashes = {};
+    std::array<uint16_t, NumBuckets + 1> BucketStart = {};
+    for (size_t I = 0; I != N; ++I) {
+      Hashes[I] = hash(Key(I));
+      ++BucketStart[getBucket(Hashes[I]) + 1];
+    }
+    for (size_t B = 0; B != NumBuckets; ++B)
+      BucketStart[B + 1] += BucketStart[B];
+    std::array<uint16_t, N> BucketKeys = {};
+    std::array<uint16_t, NumBuckets> Fill = {};
+    for (size_t I = 0; I != N; ++I) {
+      size_t B = getBucket(Hashes[I]);
+      BucketKeys[BucketStart[B] + Fill[B]++] = I;
+    }
+
+    // Place the largest buckets first, while the table is still empty. Sort
+    // the buckets by decreasing size with a counting sort.
+    std::array<uint16_t, N + 2> SizeStart = {};
+    for (size_t B = 0; B != NumBuckets; ++B)
+      ++SizeStart[N - (BucketStart[B + 1] - BucketStart[B]) + 1];
+    for (size_t Size = 0; Size <= N; ++Size)
+      SizeStart[Size + 1] += SizeStart[Size];
+    std::array<uint16_t, NumBuckets> Order = {};
+    for (size_t B = 0; B != NumBuckets; ++B)
+      Order[SizeStart[N - (BucketStart[B + 1] - BucketStart[B])]++] = B;
+
+    // Only the first of several equal strings is placed. Equal strings land
+    // in the same bucket.
+    std::array<bool, N> Skip = {};
+    for (size_t B = 0; B != NumBuckets; ++B)
+      for (size_t I = BucketStart[B]; I != BucketStart[B + 1]; ++I)
+        for (size_t J = BucketStart[B]; J != I && !Skip[I]; ++J)
+          Skip[I] = Hashes[BucketKeys[I]] == Hashes[BucketKeys[J]] &&
+                    std::string_view(Key(BucketKeys[I])) ==
+                        std::string_view(Key(BucketKeys[J]));
+
+    for (size_t B : Order) {
+      size_t Begin = BucketStart[B], End = BucketStart[B + 1];
+      if (Begin == End)
+        break;
+      for (uint32_t D = 0;; ++D) {
+        if (D > 0xffff)
+          report_fatal_error("cannot build a perfect hash of the strings");
+        // Place the strings of the bucket, undoing the placement on the first
+        // collision.
+        size_t Placed = Begin;
+        for (; Placed != End; ++Placed) {
+          if (Skip[Placed])
+            continue;
+          size_t Slot = getSlot(Hashes[BucketKeys[Placed]], D);
+          if (Slots[Slot] != NotFound)
+            break;
+          Slots[Slot] = BucketKeys[Placed];
+        }
+        if (Placed == End) {
+          Displacements[B] = D;
+          break;
+        }
+        for (size_t I = Begin; I != Placed; ++I)
+          if (!Skip[I])
+            Slots[getSlot(Hashes[BucketKeys[I]], D)] = NotFound;
+      }
+    }
+  }
+
+  /// Return the index of the only string of the set which \p S can be, or
+  /// NotFound.
+  constexpr uint16_t find(StringRef S) const {
+    uint64_t H = hash(S);
+    return Slots[getSlot(H, Displacements[getBucket(H)])];
+  }
+};
+
+} // end namespace detail
+
+/// A switch over a fixed set of strings which finds the matching case with a
+/// single hash and a single string comparison.
+///
+/// StringSwitch compares its input against every case in turn, which gets
+/// slow for large keyword sets looked up on every token. A StringSwitchTable
+/// is built once, usually as a constexpr variable, so that its perfect hash
+/// table is computed by the compiler:
+///
+/// \code
+/// static constexpr auto Colors = makeStringSwitchTable<Color>({
+///     {"red", Red},
+///     {"orange", Orange},
+///     {"violet", Violet},
+///     {"purple", Violet},
+/// });
+/// Color C = Colors.lookup_or(argv[i], UnknownColor);
+/// \endcode
+///
+/// For a handful of cases, StringSwitch is as fast or faster, since the
+/// compiler can turn its comparisons into a switch on the length; the table
+/// pays off from a few dozen cases on.
+///
+/// As with StringSwitch, when a string appears in several cases the value of
+/// the first one is returned. The table keeps references to the case
+/// strings, which must outlive it; string literals always do.
+template <typename T, size_t N> class StringSwitchTable {
+  std::array<std::pair<StringRef, T>, N> Cases;
+  detail::StringPerfectHash<N> Hash;
+
+  template <size_t... I>
+  constexpr StringSwitchTable(const std::pair<StringRef, T> (&Init)[N],
+                              std::index_sequence<I...>)
+      : Cases{{{Init[I].first, Init[I].second}...}} {
+    Hash.build([this](size_t Idx) { return Cases[Idx].first; });
+  }
+
+public:
+  constexpr StringSwitchTable(const std::pair<StringRef, T> (&Init)[N])
+      : StringSwitchTable(Init, std::make_index_sequence<N>()) {}
+
+  /// Return the value of the case matching \p S, if any.
+  constexpr std::optional<T> lookup(StringRef S) const {
+    uint16_t Idx = Hash.find(S);
+    if (Idx == Hash.NotFound ||
+        std::string_view(Cases[Idx].first) != std::string_view(S))
+      return std::nullopt;
+    return Cases[Idx].second;
+  }
+
+  /// Return the value of the case matching \p S, or \p Default.
+  constexpr T lookup_or(StringRef S, T Default) const {
+    if (std::optional<T> Result = lookup(S))
+      return *Result;
+    return Default;
+  }
+
+  /// Return true if \p S matches one of the cases.
+  constexpr bool contains(StringRef S) const { return lookup(S).has_value(); }
+
+  /// Return the number of cases, counting repeated strings.
+  static constexpr size_t size() { return N; }
+};
+
+/// Build a StringSwitchTable from a list of (string, value) cases, e.g.
+/// \code
+/// static constexpr auto Table = makeStringSwitchTable<int>({{"a", 1}});
+/// \endcode
+template <typename T, size_t N>
+constexpr StringSwitchTable<T, N>
+makeStringSwitchTable(const std::pair<StringRef, T> (&Cases)[N]) {
+  return StringSwitchTable<T, N>(Cases);
+}
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_STRINGSWITCHTABLE_H
@@ -101,6 +101,15 @@ public:
   /// Returns the byte size of the table.
   constexpr size_t size() const { return Table.size(); }
 
+  /// Returns the number of strings in the table, including the empty string at
+  /// offset zero, i.e. the number of strings visited by iterating over it.
+  constexpr size_t getNumStrings() const {
+    size_t NumStrings = 0;
+    for (size_t I = 0, E = Table.size() - 1; I != E; ++I)
+      NumStrings += Table.data()[I] == '\0';
+    return NumStrings;
+  }
+
   class Iterator
       : public iterator_facade_base<Iterator, std::forward_iterator_tag,
                                     const StringRef> {
@@ -0,0 +1,106 @@
+//===- llvm/ADT/StringTableIndex.h - StringTable reverse index --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines StringTableIndex, which finds the offset of a string in a
+/// StringTable through a perfect hash built at compile time.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_STRINGTABLEINDEX_H
+#define LLVM_ADT_STRINGTABLEINDEX_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSwitchTable.h"
+#include "llvm/ADT/StringTable.h"
+#include "llvm/Support/ErrorHandling.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace llvm {
+
+/// The reverse of a StringTable with N strings: maps each string of the table
+/// to its offset.
+///
+/// Looking names up in a generated StringTable usually means building a
+/// StringMap of all its strings at startup. A StringTableIndex is instead
+/// built as a constexpr variable, so that its perfect hash is computed by the
+/// compiler and lookups need no runtime construction:
+///
+/// \code
+/// static constexpr char OpcodeNamesRaw[] = "\0add\0sub\0mul\0";
+/// static constexpr StringTable OpcodeNames = OpcodeNamesRaw;
+/// static constexpr StringTableIndex<OpcodeNames.getNumStrings()>
+///     OpcodeIndex(OpcodeNames);
+/// std::optional<StringTable::Offset> O = OpcodeIndex.lookup("mul");
+/// \endcode
+///
+/// N must be the number of strings of the table, including the empty string
+/// at offset zero, which the index maps to offset zero. When a string appears
+/// several times in the table, the index returns its first offset.
+///
+/// Like the table, the index holds no pointer but the one to the table
+/// contents: it stores a 16-bit slot per hash table entry and the 32-bit
+/// offset of each string, so it adds no dynamic relocation.
+template <size_t N> class StringTableIndex {
+  StringTable Table;
+  /// The offset of each string, in table order.
+  std::array<StringTable::Offset, N> Offsets = {};
+  detail::StringPerfectHash<N> Hash;
+
+public:
+  constexpr explicit StringTableIndex(const StringTable &Table)
+      : Table(Table) {
+    if (Table.getNumStrings() != N)
+      report_fatal_error("StringTableIndex size does not match its table");
+    // Record the offsets and lengths of the strings, walking the table once.
+    std::array<size_t, N> Lengths = {};
+    for (size_t I = 0, O = 0; I != N; ++I) {
+      Offsets[I] = O;
+      while (Table.getCString(O)[Lengths[I]] != '\0')
+        ++Lengths[I];
+      O += Lengths[I] + 1;
+    }
+    Hash.build([&](size_t I) {
+      return StringRef(Table.getCString(Offsets[I]), Lengths[I]);
+    });
+  }
+
+  /// Return the offset of \p S in the table, if \p S is one of its strings.
+  constexpr std::optional<StringTable::Offset> lookup(StringRef S) const {
+    uint16_t Idx = Hash.find(S);
+    if (Idx == Hash.NotFound)
+      return std::nullopt;
+    // Compare without computing the length of the table string: it matches
+    // if its first S.size() characters are S's and are followed by its
+    // terminator. The table ends with a null byte, so this never reads past
+    // it.
+    unsigned O = Offsets[Idx].value();
+    if (S.size() >= Table.size() - O ||
+        std::string_view(Table.getCString(O), S.size()) !=
+            std::string_view(S) ||
+        Table.getCString(O)[S.size()] != '\0')
+      return std::nullopt;
+    return Offsets[Idx];
+  }
+
+  /// Return true if \p S is one of the strings of the table.
+  constexpr bool contains(StringRef S) const { return lookup(S).has_value(); }
+
+  /// Return the indexed table.
+  constexpr const StringTable &getTable() const { return Table; }
+
+  /// Return the number of strings of the table, counting repeated strings.
+  static constexpr size_t size() { return N; }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_STRINGTABLEINDEX_H
@@ -17,10 +17,149 @@
 #define LLVM_ADT_EDIT_DISTANCE_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/bit.h"
 #include <algorithm>
+#include <cstdint>
+#include <type_traits>
 
 namespace llvm {
 
+namespace detail {
+
+/// Computes the edit distance between a fixed pattern of bytes and any number
+/// of texts, using Myers' bit-vector algorithm when replacements are allowed
+/// and the bit-vector LCS algorithm of Hyyr\"o otherwise. Each column of the
+/// dynamic-programming matrix is kept as bit vectors of ceil(m / 64) words,
+/// where m is the pattern length, so comparing against a text of length n
+/// takes O(n * ceil(m / 64)) word operations.
+class BitParallelEditDistance {
+public:
+  /// The distances from the pattern to one text.
+  struct Result {
+    /// The distance between the pattern and the whole text.
+    unsigned Distance;
+    /// The smallest distance between the pattern and any prefix of the text.
+    /// This is the smallest entry in the last row of the matrix, which bounds
+    /// from below every entry ComputeMappedEditDistance looks at.
+    unsigned MinPrefixDistance;
+  };
+
+  explicit BitParallelEditDistance(ArrayRef<uint8_t> Pattern)
+      : Length(Pattern.size()), NumBlocks((Pattern.size() + 63) / 64) {
+    // Slot 0 holds the all-zero match vector for bytes not in the pattern.
+    std::fill(std::begin(Slot), std::end(Slot), 0);
+    Peq.assign(NumBlocks, 0);
+    unsigned NumSlots = 1;
+    for (size_t I = 0; I != Length; ++I) {
+      uint8_t C = Pattern[I];
+      if (!Slot[C]) {
+        Slot[C] = NumSlots++;
+        Peq.append(NumBlocks, 0);
+      }
+      Peq[Slot[C] * NumBlocks + I / 64] |= uint64_t(1) << (I % 64);
+    }
+  }
+
+  size_t patternLength() const { return Length; }
+
+  /// Compare the pattern against the text of length \p TextLength whose I'th
+  /// byte is \p Text(I).
+  template <typename TextFn>
+  Result compute(size_t TextLength, TextFn Text, bool AllowReplacements) const {
+    if (Length == 0)
+      return {static_cast<unsigned>(TextLength), 0};
+    return AllowReplacements ? computeLevenshtein(TextLength, Text)
+                             : computeIndel(TextLength, Text);
+  }
+
+private:
+  const uint64_t *matchVector(uint8_t C) const {
+    return &Peq[Slot[C] * NumBlocks];
+  }
+
+  /// The bit of the last block that holds the last row of the matrix.
+  uint64_t lastRowBit() const { return uint64_t(1) << ((Length - 1) % 64); }
+
+  template <typename TextFn>
+  Result computeLevenshtein(size_t TextLength, TextFn Text) const {
+    // Pv and Mv hold the positive and negative vertical deltas of the current
+    // column. The first column is 0, 1, ..., m, so all deltas are +1.
+    SmallVector<uint64_t, 4> Pv(NumBlocks, ~uint64_t(0)), Mv(NumBlocks, 0);
+    const uint64_t HighBit = uint64_t(1) << 63;
+    unsigned Score = Length, MinScore = Length;
+    for (size_t X = 0; X != TextLength; ++X) {
+      const uint64_t *Eqs = matchVector(Text(X));
+      // The top row is 0, 1, ..., n, so each column starts one higher than the
+      // last. HIn carries the horizontal delta between blocks.
+      int HIn = 1;
+      for (size_t B = 0; B != NumBlocks; ++B) {
+        uint64_t Eq = Eqs[B], P = Pv[B], M = Mv[B];
+        uint64_t Xv = Eq | M;
+        if (HIn < 0)
+          Eq |= 1;
+        uint64_t Xh = (((Eq & P) + P) ^ P) | Eq;
+        uint64_t Ph = M | ~(Xh | P);
+        uint64_t Mh = P & Xh;
+        uint64_t Out = B + 1 == NumBlocks ? lastRowBit() : HighBit;
+        int HOut = (Ph & Out) ? 1 : (Mh & Out) ? -1 : 0;
+        Ph <<= 1;
+        Mh <<= 1;
+        if (HIn < 0)
+          Mh |= 1;
+        else if (HIn > 0)
+          Ph |= 1;
+        Pv[B] = Mh | ~(Xv | Ph);
+        Mv[B] = Ph & Xv;
+        HIn = HOut;
+      }
+      Score += HIn;
+      MinScore = std::min(MinScore, Score);
+    }
+    return {Score, MinScore};
+  }
+
+  template <typename TextFn>
+  Result computeIndel(size_t TextLength, TextFn Text) const {
+    // Without replacements the distance between the pattern and the first X
+    // bytes of the text is m + X - 2 * LCS, and the LCS is the number of zero
+    // bits in V.
+    SmallVector<uint64_t, 4> V(NumBlocks, ~uint64_t(0));
+    uint64_t LastMask = ~uint64_t(0) >> (63 - (Length - 1) % 64);
+    unsigned Score = Length, MinScore = Length;
+    for (size_t X = 0; X != TextLength; ++X) {
+      const uint64_t *Eqs = matchVector(Text(X));
+      uint64_t Carry = 0;
+      unsigned LCS = 0;
+      for (size_t B = 0; B != NumBlocks; ++B) {
+        uint64_t Old = V[B], U = Old & Eqs[B];
+        uint64_t Sum = Old + Carry;
+        Carry = Sum < Old;
+        Sum += U;
+        Carry |= Sum < U;
+        V[B] = Sum | (Old & ~Eqs[B]);
+        uint64_t Zeros = ~V[B];
+        if (B + 1 == NumBlocks)
+          Zeros &= LastMask;
+        LCS += llvm::popcount(Zeros);
+      }
+      Score = Length + (X + 1) - 2 * LCS;
+      MinScore = std::min(MinScore, Score);
+    }
+    return {Score, MinScore};
+  }
+
+  size_t Length;
+  size_t NumBlocks;
+  /// Maps each byte to its row of Peq.
+  uint16_t Slot[256];
+  /// For each distinct byte of the pattern, the bit vector of positions where
+  /// it occurs, NumBlocks words per byte.
+  SmallVector<uint64_t, 32> Peq;
+};
+
+} // end namespace detail
+
 /// Determine the edit distance between two sequences.
 ///
 /// \param FromArray the first sequence to compare.
@@ -69,6 +208,27 @@ unsigned ComputeMappedEditDistance(ArrayRef<T> FromArray, ArrayRef<T> ToArray,
       return MaxEditDistance + 1;
   }
 
+  // Sequences that map to bytes can use the bit-parallel algorithm, which
+  // returns the same result: the DP below gives up as soon as the smallest
+  // entry of a row exceeds MaxEditDistance, and the smallest entry of each
+  // row is at least that of the row above, so it gives up exactly when the
+  // smallest entry of the last row exceeds MaxEditDistance.
+  using MappedT = std::decay_t<std::invoke_result_t<Functor &, const T &>>;
+  if constexpr (std::is_integral_v<MappedT> && sizeof(MappedT) == 1) {
+    SmallVector<uint8_t, 64> Pattern;
+    Pattern.reserve(m);
+    for (const T &Item : FromArray)
+      Pattern.push_back(static_cast<uint8_t>(Map(Item)));
+    detail::BitParallelEditDistance::Result R =
+        detail::BitParallelEditDistance(Pattern).compute(
+            n,
+            [&](size_t I) { return static_cast<uint8_t>(Map(ToArray[I])); },
+            AllowReplacements);
+    if (MaxEditDistance && R.MinPrefixDistance > MaxEditDistance)
+      return MaxEditDistance + 1;
+    return R.Distance;
+  }
+
   SmallVector<unsigned, 64> Row(n + 1);
   for (unsigned i = 1; i < Row.size(); ++i)
     Row[i] = i;
@@ -0,0 +1,294 @@
+//===- llvm/ADT/ilist_node_pool.h - Pooled ilist node storage ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file defines ilist_node_pool, which allocates the nodes of intrusive
+/// lists in cache-line-aligned blocks, and ilist_pool_alloc_traits, the ilist
+/// allocation policy which returns erased nodes to their pool.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_ILIST_NODE_POOL_H
+#define LLVM_ADT_ILIST_NODE_POOL_H
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/ADT/ilist.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemAlloc.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace llvm {
+
+/// A pool of nodes for intrusive lists, which keeps the nodes of a list close
+/// together in memory.
+///
+/// Nodes allocated one by one with new end up scattered over the heap, so
+/// walking a long list misses the cache at almost every node. The pool carves
+/// nodes out of blocks of at least a page, aligned to their size:
+///
+///  - create() fills the slots of a block in order, so nodes created in list
+///    order are laid out in list order;
+///  - createNear() puts the new node in the block of its future neighbour, in
+///    the free slot closest to it, which keeps lists that are built by
+///    inserting in the middle mostly local;
+///  - repack() moves the nodes of a list into fresh blocks in traversal
+///    order, once edits have scattered them.
+///
+/// Every block is aligned to its size and records its pool, so a node can be
+/// freed without knowing which pool it came from, and nodes of different
+/// pools can share a list. Creating, destroying, inserting and splicing never
+/// move a node, so iterators and pointers keep the validity guarantees of
+/// ilist; only repack() moves nodes, and invalidates every iterator and
+/// pointer to the nodes of the list it repacks.
+///
+/// Destroying the pool releases its blocks without running the destructors of
+/// the nodes still in them.
+template <typename NodeTy> class ilist_node_pool {
+  static_assert(alignof(NodeTy) <= 64,
+                "Nodes must fit the cache-line alignment of the slots");
+
+  static constexpr size_t HeaderSize = 64;
+  static constexpr size_t SlotSize = alignTo(sizeof(NodeTy), alignof(NodeTy));
+  /// At least a page, and room for at least 8 nodes.
+  static constexpr size_t BlockSize =
+      std::max<size_t>(4096, NextPowerOf2(HeaderSize + 8 * SlotSize - 1));
+  static constexpr size_t NodesPerBlock = (BlockSize - HeaderSize) / SlotSize;
+  static constexpr size_t NumMaskWords = (NodesPerBlock + 63) / 64;
+
+  struct Block {
+    ilist_node_pool *Pool;
+    /// The blocks with free slots form a doubly linked list.
+    Block *PrevPartial = nullptr;
+    Block *NextPartial = nullptr;
+    unsigned NumFree = NodesPerBlock;
+    bool InPartialList = false;
+    /// A set bit for each free slot.
+    uint64_t FreeMask[NumMaskWords];
+
+    explicit Block(ilist_node_pool *Pool) : Pool(Pool) {
+      for (size_t W = 0; W != NumMaskWords; ++W) {
+        size_t Bits = std::min<size_t>(64, NodesPerBlock - 64 * W);
+        FreeMask[W] = Bits == 64 ? ~uint64_t(0) : (uint64_t(1) << Bits) - 1;
+      }
+    }
+
+    void *getSlot(size_t Idx) {
+      return reinterpret_cast<char *>(this) + HeaderSize + Idx * SlotSize;
+    }
+    size_t getSlotIndex(const void *P) const {
+      return (reinterpret_cast<const char *>(P) -
+              reinterpret_cast<const char *>(this) - HeaderSize) /
+             SlotSize;
+    }
+    bool isFree(size_t Idx) const {
+      return FreeMask[Idx / 64] & (uint64_t(1) << (Idx % 64));
+    }
+
+    /// Return the free slot closest to \p Idx, looking after it first.
+    size_t findFreeNear(size_t Idx) const {
+      assert(NumFree && "No free slot in this block");
+      for (size_t W = Idx / 64, Shift = Idx % 64; W != NumMaskWords;
+           ++W, Shift = 0)
+        if (uint64_t Bits = FreeMask[W] >> Shift << Shift)
+          return 64 * W + countr_zero(Bits);
+      for (size_t W = Idx / 64 + 1; W-- != 0;)
+        if (FreeMask[W])
+          return 64 * W + 63 - countl_zero(FreeMask[W]);
+      llvm_unreachable("NumFree is out of sync with FreeMask");
+    }
+  };
+  static_assert(sizeof(Block) <= HeaderSize, "Block header is too large");
+
+  /// Every block of this pool.
+  SmallVector<Block *, 0> Blocks;
+  /// The blocks with free slots, most recently used first.
+  Block *Partial = nullptr;
+  size_t NumNodes = 0;
+
+  static Block *getBlock(const NodeTy *N) {
+    return reinterpret_cast<Block *>(reinterpret_cast<uintptr_t>(N) &
+                                     ~uintptr_t(BlockSize - 1));
+  }
+
+  void addToPartial(Block *B) {
+    assert(!B->InPartialList);
+    B->InPartialList = true;
+    B->PrevPartial = nullptr;
+    B->NextPartial = Partial;
+    if (Partial)
+      Partial->PrevPartial = B;
+    Partial = B;
+  }
+
+  void removeFromPartial(Block *B) {
+    assert(B->InPartialList);
+    B->InPartialList = false;
+    if (B->PrevPartial)
+      B->PrevPartial->NextPartial = B->NextPartial;
+    else
+      Partial = B->NextPartial;
+    if (B->NextPartial)
+      B->NextPartial->PrevPartial = B->PrevPartial;
+  }
+
+  Block *newBlock() {
+    void *Mem = allocate_buffer(BlockSize, BlockSize);
+    Block *B = new (Mem) Block(this);
+    Blocks.push_back(B);
+    return B;
+  }
+
+  void freeBlock(Block *B) {
+    deallocate_buffer(B, BlockSize, BlockSize);
+  }
+
+  /// Take slot \p Idx of \p B.
+  void *takeSlot(Block *B, size_t Idx) {
+    assert(B->isFree(Idx) && "Slot is in use");
+    B->FreeMask[Idx / 64] &= ~(uint64_t(1) << (Idx % 64));
+    if (--B->NumFree == 0 && B->InPartialList)
+      removeFromPartial(B);
+    ++NumNodes;
+    return B->getSlot(Idx);
+  }
+
+  void *allocate() {
+    Block *B = Partial;
+    if (!B) {
+      B = newBlock();
+      addToPartial(B);
+    }
+    return takeSlot(B, B->findFreeNear(0));
+  }
+
+  void *allocateNear(const NodeTy *Hint) {
+    Block *B = getBlock(Hint);
+    if (B->Pool != this || !B->NumFree)
+      return allocate();
+    return takeSlot(B, B->findFreeNear(B->getSlotIndex(Hint) + 1));
+  }
+
+  void deallocate(NodeTy *N) {
+    Block *B = getBlock(N);
+    size_t Idx = B->getSlotIndex(N);
+    assert(!B->isFree(Idx) && "Node freed twice");
+    B->FreeMask[Idx / 64] |= uint64_t(1) << (Idx % 64);
+    if (B->NumFree++ == 0 && !B->InPartialList)
+      addToPartial(B);
+    --NumNodes;
+  }
+
+  template <class T, class... Options>
+  static void replaceNode(simple_ilist<T, Options...> &List, NodeTy &Old,
+                          NodeTy &New) {
+    List.insert(Old.getIterator(), New);
+    List.remove(Old);
+  }
+
+  template <class T, class... Options>
+  static void replaceNode(iplist<T, Options...> &List, NodeTy &Old,
+                          NodeTy &New) {
+    List.insert(Old.getIterator(), &New);
+    List.remove(&Old);
+  }
+
+public:
+  ilist_node_pool() = default;
+  ilist_node_pool(const ilist_node_pool &) = delete;
+  ilist_node_pool &operator=(const ilist_node_pool &) = delete;
+
+  ~ilist_node_pool() {
+    for (Block *B : Blocks)
+      freeBlock(B);
+  }
+
+  /// Construct a node in the first free slot of the most recently used block.
+  template <typename... ArgTs> NodeTy *create(ArgTs &&...Args) {
+    return new (allocate()) NodeTy(std::forward<ArgTs>(Args)...);
+  }
+
+  /// Construct a node in the free slot closest to \p Hint, typically the node
+  /// it is going to be inserted next to, which must have been created by an
+  /// ilist_node_pool of this type. Falls back to create() if the block of
+  /// \p Hint is full or belongs to another pool.
+  template <typename... ArgTs>
+  NodeTy *createNear(const NodeTy *Hint, ArgTs &&...Args) {
+    return new (allocateNear(Hint)) NodeTy(std::forward<ArgTs>(Args)...);
+  }
+
+  /// Destroy a node created by any ilist_node_pool of this type, which must
+  /// not be in a list.
+  static void destroy(NodeTy *N) {
+    N->~NodeTy();
+    getBlock(N)->Pool->deallocate(N);
+  }
+
+  /// Move the nodes of \p List into fresh blocks of this pool, in list order,
+  /// and free the blocks left empty. Every node must be in no list but \p List.
+  /// This invalidates all the iterators and pointers to the nodes of \p List.
+  template <typename ListT> void repack(ListT &List) {
+    Block *Fresh = nullptr;
+    size_t NextSlot = NodesPerBlock;
+    for (auto I = List.begin(), E = List.end(); I != E;) {
+      NodeTy &Old = *I++;
+      if (NextSlot == NodesPerBlock) {
+        Fresh = newBlock();
+        NextSlot = 0;
+      }
+      NodeTy *New = new (takeSlot(Fresh, NextSlot++)) NodeTy(std::move(Old));
+      replaceNode(List, Old, *New);
+      destroy(&Old);
+    }
+    if (Fresh && Fresh->NumFree)
+      addToPartial(Fresh);
+
+    // Release the blocks which no longer hold any node.
+    llvm::erase_if(Blocks, [&](Block *B) {
+      if (B->NumFree != NodesPerBlock)
+        return false;
+      if (B->InPartialList)
+        removeFromPartial(B);
+      freeBlock(B);
+      return true;
+    });
+  }
+
+  /// Return the number of live nodes allocated from this pool.
+  size_t size() const { return NumNodes; }
+
+  /// Return the number of blocks held by this pool.
+  size_t getNumBlocks() const { return Blocks.size(); }
+
+  /// Return the number of nodes a block holds.
+  static constexpr size_t getNodesPerBlock() { return NodesPerBlock; }
+};
+
+/// An ilist allocation policy for nodes created by an ilist_node_pool: erasing
+/// a node from an ilist returns it to its pool.
+///
+/// \code
+/// template <>
+/// struct ilist_alloc_traits<MyNode> : ilist_pool_alloc_traits<MyNode> {};
+/// \endcode
+///
+/// Every node of such a type that an ilist deletes must then come from a pool.
+template <typename NodeTy> struct ilist_pool_alloc_traits {
+  static void deleteNode(NodeTy *N) { ilist_node_pool<NodeTy>::destroy(N); }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_ILIST_NODE_POOL_H
@@ -13,6 +13,7 @@
 #ifndef LLVM_SUPPORT_BLOCKFREQUENCY_H
 #define LLVM_SUPPORT_BLOCKFREQUENCY_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/Support/Compiler.h"
 #include <cassert>
 #include <cstdint>
@@ -43,6 +44,13 @@ public:
   LLVM_ABI BlockFrequency &operator*=(BranchProbability Prob);
   LLVM_ABI BlockFrequency operator*(BranchProbability Prob) const;
 
+  /// Set each element of \p Freqs to this frequency multiplied by the
+  /// corresponding element of \p Probs, as when distributing a block's
+  /// frequency over its successor edges.
+  LLVM_ABI void
+  scaleByProbabilities(ArrayRef<BranchProbability> Probs,
+                       MutableArrayRef<BlockFrequency> Freqs) const;
+
   /// Divide by a non-zero branch probability using saturating
   /// arithmetic.
   LLVM_ABI BlockFrequency &operator/=(BranchProbability Prob);
@@ -14,6 +14,7 @@
 #define LLVM_SUPPORT_BRANCHPROBABILITY_H
 
 #include "llvm/ADT/ADL.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/DataTypes.h"
 #include <algorithm>
@@ -57,6 +58,13 @@ public:
   // Create a BranchProbability object from 64-bit integers.
   LLVM_ABI static BranchProbability getBranchProbability(uint64_t Numerator,
                                                          uint64_t Denominator);
+  // Set each element of Probs to getBranchProbability(Numerators[I],
+  // Denominator). Cheaper than calling getBranchProbability in a loop, since
+  // the division by Denominator is turned into a multiplication once for all
+  // of the numerators.
+  LLVM_ABI static void
+  getBranchProbabilities(ArrayRef<uint64_t> Numerators, uint64_t Denominator,
+                         MutableArrayRef<BranchProbability> Probs);
   // Create a BranchProbability from a double, which must be from 0 to 1.
   LLVM_ABI static BranchProbability getBranchProbability(double Prob);
 
@@ -72,7 +80,7 @@ public:
   }
 
   uint32_t getNumerator() const { return N; }
-  static uint32_t getDenominator() { return D; }
+  static constexpr uint32_t getDenominator() { return D; }
   double toDouble() const { return static_cast<double>(N) / D; }
 
   // Return (1 - Probability).
@@ -37,6 +37,12 @@
 /// So for example
 /// bin/opt -debug-counter=predicateinfo=47
 /// will skip renaming the first 47 uses, then rename one, then skip the rest.
+///
+/// Counters queried from several threads at once, such as from the body of a
+/// parallelFor, must be created with DEBUG_COUNTER_THREADSAFE. Their count is
+/// atomic, but the order in which the threads reach it is not, so for
+/// reproducible bisection such code should number its queries itself and use
+/// the shouldExecute overload that takes the query's index.
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_SUPPORT_DEBUGCOUNTER_H
@@ -49,6 +55,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/IntegerInclusiveInterval.h"
+#include <atomic>
 #include <string>
 
 namespace llvm {
@@ -67,15 +74,22 @@ public:
     /// Whether chunks for the counter are set (differs from Active in that
     /// -print-debug-counter uses Active=true, IsSet=false).
     bool IsSet = false;
-
-    int64_t Count = 0;
+    /// Whether the counter may be queried from several threads at once.
+    bool ThreadSafe = false;
+
+    /// The number of queries so far. Thread-safe counters update it with
+    /// atomic increments, the others with plain loads and stores.
+    std::atomic<int64_t> Count = 0;
+    /// The chunk that the next query may fall in. Thread-safe counters do
+    /// not use it, and look the chunk up instead.
     uint64_t CurrChunkIdx = 0;
     StringRef Name;
     StringRef Desc;
     IntegerInclusiveIntervalUtils::IntervalList Chunks;
 
   public:
-    CounterInfo(StringRef Name, StringRef Desc) : Name(Name), Desc(Desc) {
+    CounterInfo(StringRef Name, StringRef Desc, bool ThreadSafe = false)
+        : ThreadSafe(ThreadSafe), Name(Name), Desc(Desc) {
       DebugCounter::registerCounter(this);
     }
   };
@@ -103,13 +117,25 @@ public:
     instance().addCounter(Info);
   }
   LLVM_ABI static bool shouldExecuteImpl(CounterInfo &Counter);
+  LLVM_ABI static bool shouldExecuteImpl(CounterInfo &Counter, int64_t Index);
 
   inline static bool shouldExecute(CounterInfo &Counter) {
-    if (!Counter.Active)
+    if (LLVM_LIKELY(!Counter.Active))
       return true;
     return shouldExecuteImpl(Counter);
   }
 
+  /// Decide whether to execute the query numbered \p Index of a thread-safe
+  /// counter, rather than the next one. This still counts the query, but the
+  /// decision does not depend on the order in which threads make queries, so
+  /// an index that identifies the work item, such as the iteration of a
+  /// parallelFor, makes bisection reproducible.
+  inline static bool shouldExecute(CounterInfo &Counter, int64_t Index) {
+    if (LLVM_LIKELY(!Counter.Active))
+      return true;
+    return shouldExecuteImpl(Counter, Index);
+  }
+
   // Return true if a given counter had values set (either programatically or on
   // the command line).  This will return true even if those values are
   // currently in a state where the counter will always execute.
@@ -122,12 +148,12 @@ public:
 
   // Return the state of a counter. This only works for set counters.
   static CounterState getCounterState(CounterInfo &Info) {
-    return {Info.Count, Info.CurrChunkIdx};
+    return {Info.Count.load(std::memory_order_relaxed), Info.CurrChunkIdx};
   }
 
   // Set a registered counter to a given state.
   static void setCounterState(CounterInfo &Info, CounterState State) {
-    Info.Count = State.Count;
+    Info.Count.store(State.Count, std::memory_order_relaxed);
     Info.CurrChunkIdx = State.ChunkIdx;
   }
 
@@ -168,6 +194,8 @@ public:
 protected:
   void addCounter(CounterInfo *Info) { Counters[Info->Name] = Info; }
   bool handleCounterIncrement(CounterInfo &Info);
+  bool isInChunks(const CounterInfo &Info, int64_t Count) const;
+  void printQuery(const CounterInfo &Info, int64_t Count, bool Res) const;
 
   MapVector<StringRef, CounterInfo *> Counters;
 
@@ -181,5 +209,11 @@ protected:
 #define DEBUG_COUNTER(VARNAME, COUNTERNAME, DESC)                              \
   static DebugCounter::CounterInfo VARNAME(COUNTERNAME, DESC)
 
+/// Like DEBUG_COUNTER, but for a counter that may be queried from several
+/// threads at once.
+#define DEBUG_COUNTER_THREADSAFE(VARNAME, COUNTERNAME, DESC)                   \
+  static DebugCounter::CounterInfo VARNAME(COUNTERNAME, DESC,                  \
+                                           /*ThreadSafe=*/true)
+
 } // namespace llvm
 #endif
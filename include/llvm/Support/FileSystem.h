@@ -35,6 +35,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem/AccessHint.h"
 #include "llvm/Support/FileSystem/UniqueID.h"
 #include "llvm/Support/MD5.h"
 #include <cassert>
@@ -1311,9 +1312,10 @@ private:
   LLVM_ABI void unmapImpl();
   LLVM_ABI void dontNeedImpl();
   LLVM_ABI void willNeedImpl();
+  LLVM_ABI void adviseImpl(AccessHint Hint);
 
   LLVM_ABI std::error_code init(sys::fs::file_t FD, uint64_t Offset,
-                                mapmode Mode);
+                                mapmode Mode, AccessHint Hint);
 
 public:
   mapped_file_region() = default;
@@ -1328,8 +1330,10 @@ public:
   mapped_file_region &operator=(const mapped_file_region &) = delete;
 
   /// \param fd An open file descriptor to map. Does not take ownership of fd.
+  /// \param hint The expected access pattern of the mapping.
   LLVM_ABI mapped_file_region(sys::fs::file_t fd, mapmode mode, size_t length,
-                              uint64_t offset, std::error_code &ec);
+                              uint64_t offset, std::error_code &ec,
+                              AccessHint hint = AccessHint::Normal);
 
   ~mapped_file_region() { unmapImpl(); }
 
@@ -1344,6 +1348,10 @@ public:
   void dontNeed() { dontNeedImpl(); }
   void willNeed() { willNeedImpl(); }
 
+  /// Change the expected access pattern of an existing mapping. Populate is
+  /// treated as WillNeed, since the mapping already exists.
+  void advise(AccessHint Hint) { adviseImpl(Hint); }
+
   LLVM_ABI size_t size() const;
   LLVM_ABI char *data() const;
 
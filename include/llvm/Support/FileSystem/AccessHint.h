@@ -0,0 +1,47 @@
+//===- llvm/Support/FileSystem/AccessHint.h - Access hints ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is cut out of llvm/Support/FileSystem.h to allow AccessHint to be
+// used by MemoryBuffer without bloating the includes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_FILESYSTEM_ACCESSHINT_H
+#define LLVM_SUPPORT_FILESYSTEM_ACCESSHINT_H
+
+namespace llvm {
+namespace sys {
+namespace fs {
+
+/// The expected access pattern of a memory mapped file. The hint is passed on
+/// to the operating system to tune readahead for the mapping, and has no
+/// effect on the contents of the mapping. Hints the platform does not support
+/// are ignored.
+enum class AccessHint {
+  /// No hint; use the system default readahead.
+  Normal,
+  /// The mapping will be read mostly front to back. Read ahead aggressively
+  /// and drop pages soon after they have been accessed (MADV_SEQUENTIAL).
+  Sequential,
+  /// The mapping will be accessed in random order. Don't read ahead
+  /// (MADV_RANDOM).
+  Random,
+  /// The whole mapping will be accessed soon. Start reading it in
+  /// asynchronously (MADV_WILLNEED).
+  WillNeed,
+  /// The whole mapping will be accessed soon. Fault it in before the mapping
+  /// is returned, so later accesses don't take page faults (MAP_POPULATE).
+  /// Falls back to WillNeed where that is not available.
+  Populate,
+};
+
+} // end namespace fs
+} // end namespace sys
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_FILESYSTEM_ACCESSHINT_H
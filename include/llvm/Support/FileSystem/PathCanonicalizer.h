@@ -0,0 +1,94 @@
+//===- llvm/Support/FileSystem/PathCanonicalizer.h --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares PathCanonicalizer, which computes the same result as
+// sys::fs::real_path for many paths while sharing the work done for common
+// prefixes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_FILESYSTEM_PATHCANONICALIZER_H
+#define LLVM_SUPPORT_FILESYSTEM_PATHCANONICALIZER_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/RWMutex.h"
+#include "llvm/Support/StringSaver.h"
+#include <system_error>
+
+namespace llvm {
+class ThreadPoolInterface;
+
+namespace sys {
+namespace fs {
+
+/// Resolves paths to their canonical form, like real_path(), remembering the
+/// canonical form of every directory it has walked through. Paths that share a
+/// prefix with an earlier path only pay for the components after the prefix,
+/// and components that are not symlinks are resolved with a single lstat
+/// rather than a full realpath.
+///
+/// The results are interned, so canonicalizing the same file twice returns the
+/// same StringRef, and they stay valid for the lifetime of the canonicalizer.
+/// All member functions are thread safe.
+///
+/// The cache is never invalidated. Changes to the file system made after a
+/// directory was first resolved, such as retargeting a symlink, are not seen.
+/// Relative paths are resolved against the working directory at the time the
+/// canonicalizer was created.
+class PathCanonicalizer {
+public:
+  LLVM_ABI PathCanonicalizer();
+
+  /// Returns the canonical form of \p Path: absolute, with all symlinks
+  /// resolved and with no "." or ".." components.
+  LLVM_ABI ErrorOr<StringRef> canonicalize(const Twine &Path);
+
+  /// Canonicalizes each of \p Paths. The I'th result corresponds to the I'th
+  /// path.
+  LLVM_ABI SmallVector<ErrorOr<StringRef>, 0>
+  canonicalizeAll(ArrayRef<StringRef> Paths);
+
+  /// Canonicalizes each of \p Paths, spreading the work over \p Pool. The I'th
+  /// result corresponds to the I'th path.
+  LLVM_ABI SmallVector<ErrorOr<StringRef>, 0>
+  canonicalizeAll(ArrayRef<StringRef> Paths, ThreadPoolInterface &Pool);
+
+private:
+  struct CacheEntry {
+    StringRef Canonical;
+    /// Whether the path names a directory, or a symlink to one, so that only
+    /// directories are walked into, as real_path() does.
+    bool IsDirectory;
+  };
+
+  /// Resolve \p Path, whose parent is already canonical, and add it to the
+  /// cache.
+  ErrorOr<CacheEntry> resolveAndCache(StringRef Path);
+
+  BumpPtrAllocator Alloc;
+  StringSaver Saver;
+  /// Maps a path whose parent directory is canonical to its canonical form.
+  StringMap<CacheEntry> Cache;
+  SmartRWMutex<true> Mutex;
+  SmallString<128> WorkingDir;
+  std::error_code WorkingDirError;
+};
+
+} // end namespace fs
+} // end namespace sys
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_FILESYSTEM_PATHCANONICALIZER_H
@@ -0,0 +1,432 @@
+//===- llvm/Support/KnownBitsN.h - Fixed-width known zeros/ones -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains KnownBitsN, a KnownBits for a bit width fixed at compile
+// time, and KnownBitsNVector, which stores many of them as a structure of
+// arrays so that a transfer function can be applied to all of them at once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_KNOWNBITSN_H
+#define LLVM_SUPPORT_KNOWNBITSN_H
+
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/KnownBits.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace llvm {
+
+/// Tracks the known zeros and ones of a value of \p BitWidth bits, like
+/// KnownBits, but keeps them in plain integers rather than APInts. Nothing
+/// allocates, and the bitwise operators, add, sub and mul are written without
+/// data dependent branches, so that loops applying them to many values can be
+/// vectorized. The shifts visit each shift amount that the known bits allow.
+///
+/// The transfer functions give the same results as the KnownBits functions of
+/// the same name (without any of the nsw/nuw/exact flags) for inputs that do
+/// not have conflicting bits.
+template <unsigned BitWidth> struct KnownBitsN {
+  static_assert(BitWidth > 0 && BitWidth <= 64,
+                "KnownBitsN supports widths from 1 to 64 bits");
+
+  /// The smallest unsigned integer type that holds BitWidth bits.
+  using WordType = std::conditional_t<
+      BitWidth <= 8, uint8_t,
+      std::conditional_t<BitWidth <= 16, uint16_t,
+                         std::conditional_t<BitWidth <= 32, uint32_t,
+                                            uint64_t>>>;
+
+  /// The bits of WordType that are part of the value.
+  static constexpr WordType Mask = WordType(~uint64_t(0) >> (64 - BitWidth));
+
+  /// Bits outside of Mask are always zero in both Zero and One.
+  WordType Zero = 0;
+  WordType One = 0;
+
+  /// Create a value with no known bits.
+  constexpr KnownBitsN() = default;
+
+  /// Create a value with the known zeros \p Zero and the known ones \p One.
+  constexpr KnownBitsN(WordType Zero, WordType One)
+      : Zero(Zero & Mask), One(One & Mask) {}
+
+  /// Create a value from a KnownBits of width BitWidth.
+  explicit KnownBitsN(const KnownBits &Known)
+      : Zero(Known.Zero.getZExtValue()), One(Known.One.getZExtValue()) {
+    assert(Known.getBitWidth() == BitWidth && "Width mismatch");
+  }
+
+  /// Convert to a KnownBits.
+  KnownBits toKnownBits() const {
+    KnownBits Known(BitWidth);
+    Known.Zero = APInt(BitWidth, Zero);
+    Known.One = APInt(BitWidth, One);
+    return Known;
+  }
+
+  static constexpr unsigned getBitWidth() { return BitWidth; }
+
+  /// Create known bits from a known constant.
+  static constexpr KnownBitsN makeConstant(WordType C) {
+    return KnownBitsN(~C, C);
+  }
+
+  /// Returns true if there is conflicting information.
+  constexpr bool hasConflict() const { return (Zero & One) != 0; }
+
+  /// Returns true if we know the value of all bits.
+  constexpr bool isConstant() const { return WordType(Zero | One) == Mask; }
+
+  /// Returns the value when all bits have a known value.
+  WordType getConstant() const {
+    assert(isConstant() && "Can only get value when all bits are known");
+    return One;
+  }
+
+  /// Returns true if we don't know any bits.
+  constexpr bool isUnknown() const { return (Zero | One) == 0; }
+
+  /// Returns true if value is all zero.
+  constexpr bool isZero() const { return Zero == Mask; }
+
+  /// Returns true if value is all one bits.
+  constexpr bool isAllOnes() const { return One == Mask; }
+
+  /// Returns true if this value is known to be negative.
+  constexpr bool isNegative() const { return (One >> (BitWidth - 1)) & 1; }
+
+  /// Returns true if this value is known to be non-negative.
+  constexpr bool isNonNegative() const { return (Zero >> (BitWidth - 1)) & 1; }
+
+  /// Returns true if this value is known to be non-zero.
+  constexpr bool isNonZero() const { return One != 0; }
+
+  /// Return the minimal unsigned value possible given these KnownBits.
+  constexpr WordType getMinValue() const { return One; }
+
+  /// Return the maximal unsigned value possible given these KnownBits.
+  constexpr WordType getMaxValue() const { return WordType(~Zero & Mask); }
+
+  /// Returns the minimum number of trailing zero bits.
+  unsigned countMinTrailingZeros() const {
+    return llvm::countr_one(uint64_t(Zero));
+  }
+
+  /// Returns the minimum number of leading zero bits.
+  unsigned countMinLeadingZeros() const {
+    return llvm::countl_one(uint64_t(Zero) << (64 - BitWidth));
+  }
+
+  /// Returns the maximum number of trailing zero bits possible.
+  unsigned countMaxTrailingZeros() const {
+    return std::min<unsigned>(llvm::countr_zero(uint64_t(One)), BitWidth);
+  }
+
+  /// Returns the number of bits known to be one.
+  unsigned countMinPopulation() const { return llvm::popcount(One); }
+
+  /// Returns the number of bits that may be one.
+  unsigned countMaxPopulation() const {
+    return llvm::popcount(WordType(~Zero & Mask));
+  }
+
+  /// Returns KnownBitsN information that is known to be true for both this
+  /// and \p RHS.
+  constexpr KnownBitsN intersectWith(const KnownBitsN &RHS) const {
+    return KnownBitsN(Zero & RHS.Zero, One & RHS.One);
+  }
+
+  /// Returns KnownBitsN information that is known to be true for either this
+  /// or \p RHS or both.
+  constexpr KnownBitsN unionWith(const KnownBitsN &RHS) const {
+    return KnownBitsN(Zero | RHS.Zero, One | RHS.One);
+  }
+
+  /// Compute known bits resulting from adding LHS, RHS and a 1-bit Carry.
+  static KnownBitsN computeForAddCarry(const KnownBitsN &LHS,
+                                       const KnownBitsN &RHS,
+                                       const KnownBitsN<1> &Carry) {
+    return addCarry(LHS, RHS, Carry.Zero, Carry.One);
+  }
+
+  /// Compute known bits for LHS + RHS.
+  static KnownBitsN add(const KnownBitsN &LHS, const KnownBitsN &RHS) {
+    return addCarry(LHS, RHS, /*CarryZero=*/true, /*CarryOne=*/false);
+  }
+
+  /// Compute known bits for LHS - RHS, which is LHS + ~RHS + 1.
+  static KnownBitsN sub(const KnownBitsN &LHS, const KnownBitsN &RHS) {
+    return addCarry(LHS, KnownBitsN(RHS.One, RHS.Zero), /*CarryZero=*/false,
+                    /*CarryOne=*/true);
+  }
+
+  /// Compute known bits resulting from multiplying LHS and RHS.
+  static KnownBitsN mul(const KnownBitsN &LHS, const KnownBitsN &RHS) {
+    // This follows KnownBits::mul: the high bits are known zero if the product
+    // of the unsigned maximums does not overflow, and the low bits follow from
+    // the known low bits of each side.
+    uint64_t UMaxLHS = LHS.getMaxValue(), UMaxRHS = RHS.getMaxValue();
+    bool Overflow;
+    uint64_t UMaxResult = SaturatingMultiply(UMaxLHS, UMaxRHS, &Overflow);
+    Overflow |= UMaxResult > Mask;
+    unsigned LeadZ =
+        Overflow ? 0 : llvm::countl_zero(UMaxResult) - (64 - BitWidth);
+
+    unsigned TrailBitsKnown0 = llvm::countr_one(uint64_t(LHS.Zero | LHS.One));
+    unsigned TrailBitsKnown1 = llvm::countr_one(uint64_t(RHS.Zero | RHS.One));
+    unsigned TrailZero0 = LHS.countMinTrailingZeros();
+    unsigned TrailZero1 = RHS.countMinTrailingZeros();
+    unsigned SmallestOperand =
+        std::min(TrailBitsKnown0 - TrailZero0, TrailBitsKnown1 - TrailZero1);
+    unsigned ResultBitsKnown =
+        std::min(SmallestOperand + TrailZero0 + TrailZero1, BitWidth);
+
+    uint64_t BottomKnown = (LHS.One & maskTrailingOnes<uint64_t>(
+                                          TrailBitsKnown0)) *
+                           (RHS.One & maskTrailingOnes<uint64_t>(
+                                          TrailBitsKnown1));
+    uint64_t KnownMask = maskTrailingOnes<uint64_t>(ResultBitsKnown);
+    uint64_t HighZero = maskLeadingOnes<uint64_t>(LeadZ) >> (64 - BitWidth);
+    return KnownBitsN(HighZero | (~BottomKnown & KnownMask),
+                      BottomKnown & KnownMask);
+  }
+
+  /// Compute known bits for LHS << RHS.
+  static KnownBitsN shl(const KnownBitsN &LHS, const KnownBitsN &RHS) {
+    return shift(LHS, RHS, [](const KnownBitsN &LHS, unsigned ShiftAmt) {
+      uint64_t ShiftedIn = maskTrailingOnes<uint64_t>(ShiftAmt);
+      return KnownBitsN((uint64_t(LHS.Zero) << ShiftAmt) | ShiftedIn,
+                        uint64_t(LHS.One) << ShiftAmt);
+    });
+  }
+
+  /// Compute known bits for LHS >> RHS (logical).
+  static KnownBitsN lshr(const KnownBitsN &LHS, const KnownBitsN &RHS) {
+    return shift(LHS, RHS, [](const KnownBitsN &LHS, unsigned ShiftAmt) {
+      uint64_t ShiftedIn = ~(uint64_t(Mask) >> ShiftAmt);
+      return KnownBitsN((LHS.Zero >> ShiftAmt) | ShiftedIn,
+                        LHS.One >> ShiftAmt);
+    });
+  }
+
+  /// Compute known bits for LHS >> RHS (arithmetic).
+  static KnownBitsN ashr(const KnownBitsN &LHS, const KnownBitsN &RHS) {
+    return shift(LHS, RHS, [](const KnownBitsN &LHS, unsigned ShiftAmt) {
+      return KnownBitsN(SignExtend64<BitWidth>(LHS.Zero) >> ShiftAmt,
+                        SignExtend64<BitWidth>(LHS.One) >> ShiftAmt);
+    });
+  }
+
+  KnownBitsN &operator&=(const KnownBitsN &RHS) {
+    // Result bit is 0 if either operand bit is 0.
+    Zero |= RHS.Zero;
+    // Result bit is 1 if both operand bits are 1.
+    One &= RHS.One;
+    return *this;
+  }
+
+  KnownBitsN &operator|=(const KnownBitsN &RHS) {
+    // Result bit is 0 if both operand bits are 0.
+    Zero &= RHS.Zero;
+    // Result bit is 1 if either operand bit is 1.
+    One |= RHS.One;
+    return *this;
+  }
+
+  KnownBitsN &operator^=(const KnownBitsN &RHS) {
+    // Result bit is 0 if both operand bits are 0 or both are 1.
+    WordType Z = (Zero & RHS.Zero) | (One & RHS.One);
+    // Result bit is 1 if one operand bit is 0 and the other is 1.
+    One = (Zero & RHS.One) | (One & RHS.Zero);
+    Zero = Z;
+    return *this;
+  }
+
+  constexpr bool operator==(const KnownBitsN &Other) const {
+    return Zero == Other.Zero && One == Other.One;
+  }
+
+  constexpr bool operator!=(const KnownBitsN &Other) const {
+    return !(*this == Other);
+  }
+
+private:
+  static KnownBitsN addCarry(const KnownBitsN &LHS, const KnownBitsN &RHS,
+                             bool CarryZero, bool CarryOne) {
+    // This is ::computeForAddCarry in KnownBits.cpp.
+    WordType PossibleSumZero =
+        LHS.getMaxValue() + RHS.getMaxValue() + !CarryZero;
+    WordType PossibleSumOne =
+        LHS.getMinValue() + RHS.getMinValue() + CarryOne;
+
+    // Compute known bits of the carry.
+    WordType CarryKnownZero = ~(PossibleSumZero ^ LHS.Zero ^ RHS.Zero);
+    WordType CarryKnownOne = PossibleSumOne ^ LHS.One ^ RHS.One;
+
+    // Compute set of known bits (where all three relevant bits are known).
+    WordType Known = (LHS.Zero | LHS.One) & (RHS.Zero | RHS.One) &
+                     (CarryKnownZero | CarryKnownOne);
+    return KnownBitsN(~PossibleSumZero & Known, PossibleSumOne & Known);
+  }
+
+  /// Intersect the results of \p ShiftByConst for every shift amount below
+  /// BitWidth that \p RHS allows. Larger amounts give poison, and so does a
+  /// shift for which no amount is possible, which yields zero.
+  template <typename ShiftFn>
+  static KnownBitsN shift(const KnownBitsN &LHS, const KnownBitsN &RHS,
+                          ShiftFn ShiftByConst) {
+    KnownBitsN Known(Mask, Mask);
+    uint64_t MinShiftAmount = RHS.One;
+    if (MinShiftAmount < BitWidth) {
+      // Unknown bits above these can only form amounts of BitWidth or more.
+      uint64_t Unknown = ~(RHS.Zero | RHS.One) &
+                         maskTrailingOnes<uint64_t>(Log2_32_Ceil(BitWidth));
+      // Visit MinShiftAmount | Subset for each subset of the unknown bits, in
+      // increasing order.
+      uint64_t Subset = 0;
+      do {
+        uint64_t ShiftAmt = MinShiftAmount | Subset;
+        if (ShiftAmt >= BitWidth)
+          break;
+        Known = Known.intersectWith(ShiftByConst(LHS, ShiftAmt));
+        if (Known.isUnknown())
+          break;
+        Subset = (Subset - Unknown) & Unknown;
+      } while (Subset != 0);
+    }
+    // All shift amounts may result in poison.
+    if (Known.hasConflict())
+      return KnownBitsN(Mask, 0);
+    return Known;
+  }
+};
+
+template <unsigned BitWidth>
+inline KnownBitsN<BitWidth> operator&(KnownBitsN<BitWidth> LHS,
+                                      const KnownBitsN<BitWidth> &RHS) {
+  LHS &= RHS;
+  return LHS;
+}
+
+template <unsigned BitWidth>
+inline KnownBitsN<BitWidth> operator|(KnownBitsN<BitWidth> LHS,
+                                      const KnownBitsN<BitWidth> &RHS) {
+  LHS |= RHS;
+  return LHS;
+}
+
+template <unsigned BitWidth>
+inline KnownBitsN<BitWidth> operator^(KnownBitsN<BitWidth> LHS,
+                                      const KnownBitsN<BitWidth> &RHS) {
+  LHS ^= RHS;
+  return LHS;
+}
+
+using KnownBits64 = KnownBitsN<64>;
+
+/// A sequence of KnownBitsN values stored as a structure of arrays: all the
+/// known zero masks, then all the known one masks. Applying a transfer function
+/// elementwise with assign() then reads and writes consecutive words, which
+/// lets the compiler vectorize the loop for the branch-free transfer functions.
+template <unsigned BitWidth> class KnownBitsNVector {
+public:
+  using ValueType = KnownBitsN<BitWidth>;
+  using WordType = typename ValueType::WordType;
+
+  KnownBitsNVector() = default;
+
+  /// Create a vector of \p Size values with no known bits.
+  explicit KnownBitsNVector(size_t Size) : Zero(Size), One(Size) {}
+
+  size_t size() const { return Zero.size(); }
+  bool empty() const { return Zero.empty(); }
+
+  /// Resize to \p Size values. New values have no known bits.
+  void resize(size_t Size) {
+    Zero.resize(Size);
+    One.resize(Size);
+  }
+
+  void reserve(size_t Size) {
+    Zero.reserve(Size);
+    One.reserve(Size);
+  }
+
+  void clear() {
+    Zero.clear();
+    One.clear();
+  }
+
+  void push_back(const ValueType &Known) {
+    Zero.push_back(Known.Zero);
+    One.push_back(Known.One);
+  }
+
+  ValueType operator[](size_t I) const {
+    assert(I < size() && "Index out of range");
+    return ValueType(Zero[I], One[I]);
+  }
+
+  void set(size_t I, const ValueType &Known) {
+    assert(I < size() && "Index out of range");
+    Zero[I] = Known.Zero;
+    One[I] = Known.One;
+  }
+
+  /// The known zero masks of all values.
+  ArrayRef<WordType> zeros() const { return Zero; }
+
+  /// The known one masks of all values.
+  ArrayRef<WordType> ones() const { return One; }
+
+  /// Set this vector to Op(Src[I]) for each element of \p Src. \p Src may be
+  /// this vector.
+  template <typename OpT> void assign(const KnownBitsNVector &Src, OpT Op) {
+    resize(Src.size());
+    const WordType *SrcZero = Src.Zero.data(), *SrcOne = Src.One.data();
+    WordType *DstZero = Zero.data(), *DstOne = One.data();
+    for (size_t I = 0, E = size(); I != E; ++I) {
+      ValueType Result = Op(ValueType(SrcZero[I], SrcOne[I]));
+      DstZero[I] = Result.Zero;
+      DstOne[I] = Result.One;
+    }
+  }
+
+  /// Set this vector to Op(LHS[I], RHS[I]) for each pair of elements of \p LHS
+  /// and \p RHS, which must have the same size. Either may be this vector.
+  template <typename OpT>
+  void assign(const KnownBitsNVector &LHS, const KnownBitsNVector &RHS,
+              OpT Op) {
+    assert(LHS.size() == RHS.size() && "Operand size mismatch");
+    resize(LHS.size());
+    const WordType *LHSZero = LHS.Zero.data(), *LHSOne = LHS.One.data();
+    const WordType *RHSZero = RHS.Zero.data(), *RHSOne = RHS.One.data();
+    WordType *DstZero = Zero.data(), *DstOne = One.data();
+    for (size_t I = 0, E = size(); I != E; ++I) {
+      ValueType Result = Op(ValueType(LHSZero[I], LHSOne[I]),
+                            ValueType(RHSZero[I], RHSOne[I]));
+      DstZero[I] = Result.Zero;
+      DstOne[I] = Result.One;
+    }
+  }
+
+private:
+  SmallVector<WordType, 0> Zero;
+  SmallVector<WordType, 0> One;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_KNOWNBITSN_H
@@ -15,18 +15,23 @@
 
 #include "llvm-c/Types.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Alignment.h"
 #include "llvm/Support/CBindingWrapping.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem/AccessHint.h"
 #include "llvm/Support/MemoryBufferRef.h"
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 
 namespace llvm {
+class ThreadPoolInterface;
+
 namespace sys {
 namespace fs {
 // Duplicated from FileSystem.h to avoid a dependency.
@@ -100,10 +105,14 @@ public:
   ///
   /// \param Alignment Set to indicate that the buffer should be aligned to at
   /// least the specified alignment.
+  ///
+  /// \param Hint The expected access pattern of the buffer. This is only used
+  /// if the file ends up being memory mapped.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getFile(const Twine &Filename, bool IsText = false,
           bool RequiresNullTerminator = true, bool IsVolatile = false,
-          std::optional<Align> Alignment = std::nullopt);
+          std::optional<Align> Alignment = std::nullopt,
+          sys::fs::AccessHint Hint = sys::fs::AccessHint::Normal);
 
   /// Read all of the specified file into a MemoryBuffer as a stream
   /// (i.e. until EOF reached). This is useful for special files that
@@ -157,11 +166,40 @@ public:
                  bool RequiresNullTerminator = true,
                  std::optional<Align> Alignment = std::nullopt);
 
-  /// Map a subrange of the specified file as a MemoryBuffer.
+  /// Map a subrange of the specified file as a MemoryBuffer. \p Hint is the
+  /// expected access pattern of the buffer if it ends up being memory mapped.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getFileSlice(const Twine &Filename, uint64_t MapSize, uint64_t Offset,
                bool IsVolatile = false,
-               std::optional<Align> Alignment = std::nullopt);
+               std::optional<Align> Alignment = std::nullopt,
+               sys::fs::AccessHint Hint = sys::fs::AccessHint::Normal);
+
+  /// Callback invoked by getFiles() once per file. \p Index is the position
+  /// of the file in the input list.
+  using FileLoadedFn =
+      function_ref<void(size_t Index, ErrorOr<std::unique_ptr<MemoryBuffer>>)>;
+
+  /// Open each of the specified files as a MemoryBuffer, issuing the opens and
+  /// reads concurrently on \p Pool. This is meant for loading many small files
+  /// at once, where calling getFile() in a loop is bound by I/O latency.
+  ///
+  /// \p OnLoaded is called once for every file as soon as it has been loaded,
+  /// so results arrive in completion order rather than in input order. Calls
+  /// to \p OnLoaded are serialized but may happen on any thread of \p Pool.
+  /// This function returns once all files have been handed to \p OnLoaded.
+  ///
+  /// Every file is loaded exactly like getFile() would, including the choice
+  /// between mapping the file and reading it into memory.
+  static void getFiles(ArrayRef<StringRef> Filenames, ThreadPoolInterface &Pool,
+                       FileLoadedFn OnLoaded, bool IsText = false,
+                       bool RequiresNullTerminator = true,
+                       bool IsVolatile = false);
+
+  /// Same as above, but collect the results into a vector in input order.
+  static SmallVector<ErrorOr<std::unique_ptr<MemoryBuffer>>, 0>
+  getFiles(ArrayRef<StringRef> Filenames, ThreadPoolInterface &Pool,
+           bool IsText = false, bool RequiresNullTerminator = true,
+           bool IsVolatile = false);
 
   //===--------------------------------------------------------------------===//
   // Provided for performance analysis.
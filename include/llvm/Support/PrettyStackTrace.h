@@ -17,6 +17,8 @@
 
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Compiler.h"
+#include "llvm/Support/Format.h"
+#include <tuple>
 
 namespace llvm {
   class raw_ostream;
@@ -88,6 +90,38 @@ namespace llvm {
     void print(raw_ostream &OS) const override;
   };
 
+  namespace detail {
+  LLVM_ABI void printPrettyStackTraceFormat(raw_ostream &OS,
+                                            const format_object_base &Format);
+  } // end namespace detail
+
+  /// PrettyStackTraceDeferredFormat - Like PrettyStackTraceFormat, but this
+  /// object only copies the format string and its arguments, and formats them
+  /// if the stack trace is actually printed. Constructing it costs no more
+  /// than a PrettyStackTraceString, which suits entries made around every
+  /// function or pass. The arguments must be scalars, and anything they point
+  /// to, such as strings, must outlive the object.
+  template <typename... Ts>
+  class PrettyStackTraceDeferredFormat : public PrettyStackTraceEntry {
+    const char *Format;
+    std::tuple<Ts...> Args;
+  public:
+    PrettyStackTraceDeferredFormat(const char *Format, Ts... Args)
+        : Format(Format), Args(Args...) {}
+    void print(raw_ostream &OS) const override {
+      std::apply(
+          [&](const Ts &...Values) {
+            detail::printPrettyStackTraceFormat(
+                OS, llvm::format(Format, Values...));
+          },
+          Args);
+    }
+  };
+
+  template <typename... Ts>
+  PrettyStackTraceDeferredFormat(const char *, Ts...)
+      -> PrettyStackTraceDeferredFormat<Ts...>;
+
   /// PrettyStackTraceProgram - This object prints a specified program arguments
   /// to the stream as the stack trace when a crash occurs.
   class LLVM_ABI PrettyStackTraceProgram : public PrettyStackTraceEntry {
@@ -14,14 +14,19 @@
 #define LLVM_SUPPORT_PROGRAM_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include <chrono>
+#include <memory>
 #include <optional>
+#include <string>
 #include <system_error>
+#include <vector>
 
 namespace llvm {
 class BitVector;
@@ -232,6 +237,66 @@ LLVM_ABI ProcessInfo Wait(
     bool Polling = false ///< If true, do not kill the process on timeout.
 );
 
+/// Runs a batch of child processes, keeping at most a fixed number of them
+/// running at once, and captures their standard output and standard error in
+/// memory. This is meant for drivers that launch many short-lived
+/// subprocesses, where calling ExecuteAndWait() for each of them in turn
+/// serializes on process startup and teardown, and where redirecting output
+/// through temporary files is a measurable cost.
+///
+/// On Unix all running children are serviced by a single poll() loop over
+/// their output pipes; on Linux the loop also watches a pidfd per child, so
+/// that any finished child is reaped as soon as it exits. On Windows the
+/// output still goes through temporary files.
+class ProcessPool {
+public:
+  /// The outcome of one job.
+  struct Result {
+    /// The index of the job, in the order jobs were added.
+    size_t Index = 0;
+    /// The exit code of the job, with the same meaning as the return value of
+    /// ExecuteAndWait(): -1 if the program could not be executed, -2 if it
+    /// crashed.
+    int ReturnCode = -1;
+    /// True if the process could not be started at all.
+    bool ExecutionFailed = false;
+    /// A description of the error if ReturnCode is negative.
+    std::string ErrMsg;
+    /// Everything the job wrote to its standard output and standard error.
+    /// These are not null terminated.
+    std::unique_ptr<MemoryBuffer> Stdout;
+    std::unique_ptr<MemoryBuffer> Stderr;
+  };
+
+  /// \param MaxRunning The maximum number of children running at once. Zero
+  /// means the number of hardware threads.
+  LLVM_ABI explicit ProcessPool(unsigned MaxRunning = 0);
+  LLVM_ABI ~ProcessPool();
+
+  /// Queue a job that runs \p Program with \p Args and, if provided, the
+  /// environment \p Env. See ExecuteAndWait() for the meaning of the
+  /// arguments. The strings are copied. The job's standard input is
+  /// /dev/null (NUL on Windows). Returns the index of the job.
+  LLVM_ABI size_t addJob(StringRef Program, ArrayRef<StringRef> Args,
+                         std::optional<ArrayRef<StringRef>> Env = std::nullopt);
+
+  /// Run all jobs queued since the last call, and call \p OnFinished on the
+  /// calling thread for each job as it finishes. Jobs are started in the
+  /// order they were added but may finish in any order.
+  LLVM_ABI void run(function_ref<void(Result &)> OnFinished);
+
+private:
+  struct Job {
+    std::string Program;
+    std::vector<std::string> Args;
+    std::optional<std::vector<std::string>> Env;
+  };
+
+  unsigned MaxRunning;
+  size_t NumJobsRun = 0;
+  std::vector<Job> Jobs;
+};
+
 /// Print a command argument, and optionally quote it.
 LLVM_ABI void printArg(llvm::raw_ostream &OS, StringRef Arg, bool Quote);
 
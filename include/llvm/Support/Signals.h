@@ -65,6 +65,31 @@ LLVM_ABI void PrintStackTraceOnErrorSignal(StringRef Argv0,
 /// Disable all system dialog boxes that appear when the process crashes.
 LLVM_ABI void DisableSystemDialogsOnCrash();
 
+/// Load the function symbols of the executable and of every shared object
+/// loaded so far, so that PrintStackTrace() can symbolize frames in process
+/// instead of running llvm-symbolizer. Printing frames then only reads the
+/// resulting table, which is signal safe and fast for large binaries; frames
+/// get mangled function names, which llvm-cxxfilt demangles, but no source
+/// locations. This function is not signal safe; call it at startup, after
+/// PrintStackTraceOnErrorSignal, and again after loading more shared objects.
+/// A crash on another thread may still be reading the previous table, so each
+/// call leaks it: only reload a handful of times. Does nothing if
+/// LLVM_DISABLE_SYMBOLIZATION is set, or on platforms without ELF symbol
+/// tables.
+LLVM_ABI void PreloadStackTraceSymbols();
+
+/// Stop symbolizing frames with the table loaded by PreloadStackTraceSymbols().
+/// Like a reload, this leaks the table.
+LLVM_ABI void UnloadStackTraceSymbols();
+
+/// Print the first \p Depth addresses of \p StackTrace to \p OS, one frame per
+/// line, symbolized with the table loaded by PreloadStackTraceSymbols().
+/// Each line is formatted in a fixed buffer and passed to \p OS in a single
+/// write, so this is signal safe when \p OS is unbuffered, like errs().
+/// \returns false, without printing anything, if no table is loaded.
+LLVM_ABI bool PrintPreloadedStackTrace(raw_ostream &OS,
+                                       void *const *StackTrace, int Depth);
+
 /// Print the stack trace using the given \c raw_ostream object.
 /// \param Depth refers to the number of stackframes to print. If not
 ///        specified, the entire frame is printed.
@@ -52,6 +52,8 @@
 #undef DEBUG_TYPE
 #include "Support/Compression.cpp"
 #undef DEBUG_TYPE
+#include "Support/ConcurrentIntEqClasses.cpp"
+#undef DEBUG_TYPE
 #include "Support/ConvertEBCDIC.cpp"
 #undef DEBUG_TYPE
 #include "Support/ConvertUTF.cpp"
@@ -184,6 +186,8 @@
 #include "Support/RewriteRope.cpp"
 #undef DEBUG_TYPE
 #undef getRoot
+#include "Support/RoaringBitVector.cpp"
+#undef DEBUG_TYPE
 #include "Support/SHA1.cpp"
 #undef DEBUG_TYPE
 #include "Support/SHA256.cpp"
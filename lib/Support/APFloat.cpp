@@ -20,11 +20,14 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/bit.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
+#include <cfloat>
+#include <cmath>
 #include <cstring>
 #include <limits.h>
 
@@ -2113,6 +2116,170 @@ void IEEEFloat::changeSign() {
   sign = !sign;
 }
 
+// Arithmetic on native floating point types.
+//
+// Most constant folding is done on IEEE single and double precision values,
+// and for those the host's float and double arithmetic computes the same
+// correctly rounded results as the generic code, far faster. The generic code
+// also reports whether the result is exact, and reading that back from the
+// floating point environment would be slow and unreliable, so instead the
+// rounding error is computed exactly with an error-free transformation: when
+// it is zero the operation was exact.
+//
+// That only works if the error is itself representable, which holds when all
+// operands are normal and their exponents are within MaxExponent of zero. The
+// results are then far from overflowing or underflowing; their exponents are
+// still checked before they are used, so that nothing near the limits of the
+// format is ever handled here. Everything else, as well as other rounding
+// modes, takes the generic path.
+//
+// x87 arithmetic keeps excess precision and rounds twice, so this is disabled
+// unless float and double expressions are evaluated in their own types.
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define APFLOAT_NATIVE_ARITHMETIC 1
+#else
+#define APFLOAT_NATIVE_ARITHMETIC 0
+#endif
+
+namespace {
+
+template <typename T> struct NativeFloatTraits;
+
+template <> struct NativeFloatTraits<float> {
+  using BitsType = uint32_t;
+};
+
+template <> struct NativeFloatTraits<double> {
+  using BitsType = uint64_t;
+};
+
+/// The result of a native operation, and whether it had to be rounded.
+template <typename T> struct NativeResult {
+  T Value;
+  bool Inexact;
+};
+
+/// Returns the rounding error of S = A + B, which is always exact (Knuth's
+/// TwoSum).
+template <typename T> T twoSumError(T A, T B, T S) {
+  T BVirtual = S - A;
+  T AVirtual = S - BVirtual;
+  return (A - AVirtual) + (B - BVirtual);
+}
+
+/// Returns true if the exact sum of \p Terms is zero. The terms are summed
+/// into a nonoverlapping expansion (Shewchuk's Grow-Expansion), which is zero
+/// only if all of its components are.
+template <typename T, size_t N> bool isExactSumZero(const T (&Terms)[N]) {
+  T Expansion[N];
+  size_t Length = 0;
+  for (T Q : Terms) {
+    for (size_t I = 0; I != Length; ++I) {
+      T Sum = Q + Expansion[I];
+      Expansion[I] = twoSumError(Q, Expansion[I], Sum);
+      Q = Sum;
+    }
+    Expansion[Length++] = Q;
+  }
+  return llvm::all_of(Expansion, [](T Component) { return Component == 0; });
+}
+
+struct NativeAddOrSubtract {
+  bool Subtract;
+  template <typename T> NativeResult<T> operator()(T L, T R, T) const {
+    if (Subtract)
+      R = -R;
+    T Sum = L + R;
+    return {Sum, twoSumError(L, R, Sum) != 0};
+  }
+};
+
+struct NativeMultiply {
+  template <typename T> NativeResult<T> operator()(T L, T R, T) const {
+    T Product = L * R;
+    return {Product, std::fma(L, R, -Product) != 0};
+  }
+};
+
+struct NativeDivide {
+  template <typename T> NativeResult<T> operator()(T L, T R, T) const {
+    T Quotient = L / R;
+    return {Quotient, std::fma(-Quotient, R, L) != 0};
+  }
+};
+
+struct NativeFusedMultiplyAdd {
+  template <typename T> NativeResult<T> operator()(T L, T R, T A) const {
+    T Result = std::fma(L, R, A);
+    T Product = L * R;
+    T ProductError = std::fma(L, R, -Product);
+    return {Result, !isExactSumZero({Product, ProductError, A, -Result})};
+  }
+};
+
+} // namespace
+
+template <typename OpFn>
+bool IEEEFloat::computeNative(OpFn Op, const IEEEFloat &rhs,
+                              const IEEEFloat *addend, opStatus &fs) {
+#if APFLOAT_NATIVE_ARITHMETIC
+  auto Compute = [&](auto Zero, const fltSemantics &S) {
+    using T = decltype(Zero);
+    using BitsType = typename NativeFloatTraits<T>::BitsType;
+    const unsigned SignShift = S.sizeInBits - 1;
+    const unsigned ExponentShift = S.precision - 1;
+    const BitsType IntegerBit = BitsType(1) << ExponentShift;
+    const BitsType ExponentMask =
+        (BitsType(1) << (SignShift - ExponentShift)) - 1;
+    const ExponentType Bias = S.maxExponent;
+    // The error of a product is a multiple of 2^(eL + eR - 2 * precision + 2),
+    // and the remainder of a quotient one of 2^(eL - 2 * precision + 1). This
+    // keeps both above the smallest denormal, so they are representable.
+    const ExponentType MaxExponent = (-S.minExponent - S.precision) / 2 - 1;
+
+    auto InRange = [&](const IEEEFloat &F) {
+      return F.category == fcNormal && F.exponent >= -MaxExponent &&
+             F.exponent <= MaxExponent;
+    };
+    auto ToNative = [&](const IEEEFloat &F) {
+      BitsType Bits = (BitsType(F.sign) << SignShift) |
+                      (BitsType(F.exponent + Bias) << ExponentShift) |
+                      (BitsType(*F.significandParts()) & (IntegerBit - 1));
+      return llvm::bit_cast<T>(Bits);
+    };
+
+    if (!InRange(*this) || !InRange(rhs) || (addend && !InRange(*addend)))
+      return false;
+    NativeResult<T> Result =
+        Op(ToNative(*this), ToNative(rhs), addend ? ToNative(*addend) : Zero);
+
+    if (Result.Value == 0) {
+      makeZero(std::signbit(Result.Value));
+    } else {
+      BitsType Bits = llvm::bit_cast<BitsType>(Result.Value);
+      ExponentType Exponent =
+          ExponentType((Bits >> ExponentShift) & ExponentMask) - Bias;
+      // Leave anything close to underflowing or overflowing to the generic
+      // code, which knows how to round it.
+      if (Exponent <= S.minExponent || Exponent >= S.maxExponent)
+        return false;
+      category = fcNormal;
+      sign = Bits >> SignShift;
+      exponent = Exponent;
+      *significandParts() = (Bits & (IntegerBit - 1)) | IntegerBit;
+    }
+    fs = Result.Inexact ? opInexact : opOK;
+    return true;
+  };
+
+  if (semantics == &APFloatBase::semIEEEdouble)
+    return Compute(0.0, APFloatBase::semIEEEdouble);
+  if (semantics == &APFloatBase::semIEEEsingle)
+    return Compute(0.0f, APFloatBase::semIEEEsingle);
+#endif
+  return false;
+}
+
 /* Normalized addition or subtraction.  */
 APFloat::opStatus IEEEFloat::addOrSubtract(const IEEEFloat &rhs,
                                            roundingMode rounding_mode,
@@ -2149,12 +2316,20 @@ APFloat::opStatus IEEEFloat::addOrSubtract(const IEEEFloat &rhs,
 /* Normalized addition.  */
 APFloat::opStatus IEEEFloat::add(const IEEEFloat &rhs,
                                  roundingMode rounding_mode) {
+  opStatus fs;
+  if (rounding_mode == rmNearestTiesToEven &&
+      computeNative(NativeAddOrSubtract{false}, rhs, nullptr, fs))
+    return fs;
   return addOrSubtract(rhs, rounding_mode, false);
 }
 
 /* Normalized subtraction.  */
 APFloat::opStatus IEEEFloat::subtract(const IEEEFloat &rhs,
                                       roundingMode rounding_mode) {
+  opStatus fs;
+  if (rounding_mode == rmNearestTiesToEven &&
+      computeNative(NativeAddOrSubtract{true}, rhs, nullptr, fs))
+    return fs;
   return addOrSubtract(rhs, rounding_mode, true);
 }
 
@@ -2162,6 +2337,15 @@ APFloat::opStatus IEEEFloat::subtract(const IEEEFloat &rhs,
 APFloat::opStatus IEEEFloat::multiply(const IEEEFloat &rhs,
                                       roundingMode rounding_mode) {
   opStatus fs;
+  if (rounding_mode == rmNearestTiesToEven &&
+      computeNative(NativeMultiply{}, rhs, nullptr, fs))
+    return fs;
+  return multiplyGeneric(rhs, rounding_mode);
+}
+
+APFloat::opStatus IEEEFloat::multiplyGeneric(const IEEEFloat &rhs,
+                                             roundingMode rounding_mode) {
+  opStatus fs;
 
   sign ^= rhs.sign;
   fs = multiplySpecials(rhs);
@@ -2182,6 +2366,15 @@ APFloat::opStatus IEEEFloat::multiply(const IEEEFloat &rhs,
 APFloat::opStatus IEEEFloat::divide(const IEEEFloat &rhs,
                                     roundingMode rounding_mode) {
   opStatus fs;
+  if (rounding_mode == rmNearestTiesToEven &&
+      computeNative(NativeDivide{}, rhs, nullptr, fs))
+    return fs;
+  return divideGeneric(rhs, rounding_mode);
+}
+
+APFloat::opStatus IEEEFloat::divideGeneric(const IEEEFloat &rhs,
+                                           roundingMode rounding_mode) {
+  opStatus fs;
 
   sign ^= rhs.sign;
   fs = divideSpecials(rhs);
@@ -2351,6 +2544,17 @@ APFloat::opStatus IEEEFloat::fusedMultiplyAdd(const IEEEFloat &multiplicand,
                                               const IEEEFloat &addend,
                                               roundingMode rounding_mode) {
   opStatus fs;
+  if (rounding_mode == rmNearestTiesToEven &&
+      computeNative(NativeFusedMultiplyAdd{}, multiplicand, &addend, fs))
+    return fs;
+  return fusedMultiplyAddGeneric(multiplicand, addend, rounding_mode);
+}
+
+APFloat::opStatus
+IEEEFloat::fusedMultiplyAddGeneric(const IEEEFloat &multiplicand,
+                                   const IEEEFloat &addend,
+                                   roundingMode rounding_mode) {
+  opStatus fs;
 
   /* Post-multiplication sign, before addition.  */
   sign ^= multiplicand.sign;
@@ -29,6 +29,27 @@ BlockFrequency BlockFrequency::operator*(BranchProbability Prob) const {
   return Freq;
 }
 
+void BlockFrequency::scaleByProbabilities(
+    ArrayRef<BranchProbability> Probs,
+    MutableArrayRef<BlockFrequency> Freqs) const {
+  assert(Probs.size() == Freqs.size() && "mismatched array sizes");
+#ifdef __SIZEOF_INT128__
+  // The denominator is a power of two, so each product is a single widening
+  // multiply and a shift, with no data-dependent branches.
+  constexpr uint32_t D = BranchProbability::getDenominator();
+  static_assert(isPowerOf2_32(D), "expected a power-of-two denominator");
+  constexpr unsigned Shift = ConstantLog2<D>();
+  for (size_t I = 0, E = Probs.size(); I != E; ++I) {
+    unsigned __int128 Product =
+        (unsigned __int128)Frequency * Probs[I].getNumerator() >> Shift;
+    Freqs[I] = BlockFrequency(Product >> 64 ? UINT64_MAX : uint64_t(Product));
+  }
+#else
+  for (size_t I = 0, E = Probs.size(); I != E; ++I)
+    Freqs[I] = BlockFrequency(Probs[I].scale(Frequency));
+#endif
+}
+
 BlockFrequency &BlockFrequency::operator/=(BranchProbability Prob) {
   Frequency = Prob.scaleByInverse(Frequency);
   return *this;
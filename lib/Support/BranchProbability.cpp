@@ -14,6 +14,7 @@
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 #include <cmath>
@@ -60,6 +61,47 @@ BranchProbability::getBranchProbability(uint64_t Numerator,
   return BranchProbability(Numerator >> Scale, Denominator);
 }
 
+void BranchProbability::getBranchProbabilities(
+    ArrayRef<uint64_t> Numerators, uint64_t Denominator,
+    MutableArrayRef<BranchProbability> Probs) {
+  assert(Numerators.size() == Probs.size() && "mismatched array sizes");
+  assert(Denominator > 0 && "Denominator cannot be 0!");
+  // Scale down Denominator to fit in a 32-bit integer.
+  int Scale = 0;
+  while (Denominator > UINT32_MAX) {
+    Denominator >>= 1;
+    Scale++;
+  }
+  if (Denominator == D) {
+    for (size_t I = 0, E = Numerators.size(); I != E; ++I) {
+      assert(Numerators[I] >> Scale <= D && "Probability cannot exceed 1!");
+      Probs[I] = BranchProbability(Numerators[I] >> Scale);
+    }
+    return;
+  }
+#ifdef __SIZEOF_INT128__
+  // The constructor computes (N * D + Denominator / 2) / Denominator, whose
+  // dividend is below 2^63. For dividends of that width, multiplying by
+  // M = ceil(2^(63 + L) / Denominator) and shifting right by 63 + L, where
+  // L = ceil(log2(Denominator)), gives exactly the quotient (Granlund and
+  // Montgomery, "Division by Invariant Integers using Multiplication").
+  unsigned L = Log2_64_Ceil(Denominator);
+  unsigned __int128 Pow = (unsigned __int128)1 << (63 + L);
+  uint64_t M = uint64_t(Pow / Denominator + (Pow % Denominator != 0));
+  for (size_t I = 0, E = Numerators.size(); I != E; ++I) {
+    uint64_t Numerator = Numerators[I] >> Scale;
+    assert(Numerator <= Denominator && "Probability cannot exceed 1!");
+    uint64_t Dividend = Numerator * D + Denominator / 2;
+    Probs[I] = BranchProbability(
+        uint32_t((unsigned __int128)Dividend * M >> (63 + L)));
+  }
+#else
+  for (size_t I = 0, E = Numerators.size(); I != E; ++I)
+    Probs[I] = BranchProbability(uint32_t(Numerators[I] >> Scale),
+                                 uint32_t(Denominator));
+#endif
+}
+
 BranchProbability BranchProbability::getBranchProbability(double Prob) {
   assert(0 <= Prob && Prob <= 1 && "Probability must be between 0 and 1!");
   return BranchProbability(std::round(Prob * D), D);
@@ -0,0 +1,88 @@
+//===-- ConcurrentIntEqClasses.cpp - Concurrent Equivalence Classes -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Equivalence classes for small integers that can be joined concurrently.
+//
+// Each integer points to a smaller member of its class, so the links never
+// form a cycle and the root of each tree is its smallest member. A root is
+// linked below another root with a compare-and-swap that fails if it has
+// stopped being a root in the meantime, in which case the join is retried.
+// Lookups move each integer they pass up to its grandparent (path halving),
+// which keeps the trees shallow without any locking: the new parent is an
+// ancestor, so racing updates can only ever shorten a path.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ConcurrentIntEqClasses.h"
+#include "llvm/Support/Parallel.h"
+
+using namespace llvm;
+
+ConcurrentIntEqClasses::ConcurrentIntEqClasses(unsigned N)
+    : EC(new std::atomic<unsigned>[N]), Size(N) {
+  for (unsigned i = 0; i != N; ++i)
+    EC[i].store(i, std::memory_order_relaxed);
+}
+
+unsigned ConcurrentIntEqClasses::findLeader(unsigned a) const {
+  assert(NumClasses == 0 && "findLeader() called after compress().");
+  unsigned Parent = EC[a].load(std::memory_order_relaxed);
+  while (Parent != a) {
+    unsigned GrandParent = EC[Parent].load(std::memory_order_relaxed);
+    // Skip a level. If another thread got there first, it has stored an
+    // ancestor that is at least as good.
+    if (GrandParent != Parent)
+      EC[a].compare_exchange_weak(Parent, GrandParent,
+                                  std::memory_order_relaxed);
+    a = GrandParent;
+    Parent = EC[a].load(std::memory_order_relaxed);
+  }
+  return a;
+}
+
+unsigned ConcurrentIntEqClasses::join(unsigned a, unsigned b) {
+  assert(NumClasses == 0 && "join() called after compress().");
+  for (;;) {
+    a = findLeader(a);
+    b = findLeader(b);
+    if (a == b)
+      return a;
+    if (a > b)
+      std::swap(a, b);
+    // Link the larger leader below the smaller one, unless it has been linked
+    // elsewhere since we found it.
+    unsigned Expected = b;
+    if (EC[b].compare_exchange_strong(Expected, a, std::memory_order_acq_rel))
+      return a;
+  }
+}
+
+void ConcurrentIntEqClasses::joinAll(
+    ArrayRef<std::pair<unsigned, unsigned>> Pairs) {
+  parallelFor(0, Pairs.size(),
+              [&](size_t I) { join(Pairs[I].first, Pairs[I].second); });
+}
+
+void ConcurrentIntEqClasses::compress() {
+  if (NumClasses)
+    return;
+  // Point everything straight at its leader first; the map stays a valid
+  // union-find while doing so.
+  for (unsigned i = 0; i != Size; ++i)
+    EC[i].store(findLeader(i), std::memory_order_relaxed);
+  // The leader of i's class is smaller than i, or i itself, so it has been
+  // numbered by the time i is reached.
+  unsigned Classes = 0;
+  for (unsigned i = 0; i != Size; ++i) {
+    unsigned Leader = EC[i].load(std::memory_order_relaxed);
+    EC[i].store(Leader == i ? Classes++
+                            : EC[Leader].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+  }
+  NumClasses = Classes;
+}
@@ -66,6 +66,8 @@
 #include <stdio.h>
 #endif
 #include <assert.h>
+#include <stdint.h>
+#include <string.h>
 
 /*
  * This code extensively uses fall-through switches.
@@ -146,6 +148,79 @@ static const UTF8 firstByteMark[7] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC
 
 /* --------------------------------------------------------------------- */
 
+/*
+ * ASCII fast paths. Text is mostly ASCII, and ASCII code units convert one
+ * to one without any checks, so the conversions below first copy runs of
+ * ASCII in bulk, testing eight bytes at a time with a single load and mask.
+ * The copy loops are simple enough for the compiler to vectorize. Anything
+ * that is not ASCII goes through the general code, so the results, including
+ * error reporting and where the pointers stop, are unchanged.
+ */
+
+/* Returns the number of leading ASCII bytes in source[0, max). */
+static size_t countASCIIPrefixUTF8(const UTF8 *source, size_t max) {
+    size_t n = 0;
+    for (; max - n >= 8; n += 8) {
+        uint64_t word;
+        memcpy(&word, source + n, sizeof(word));
+        if (word & 0x8080808080808080ULL)
+            break;
+    }
+    while (n < max && source[n] < 0x80)
+        ++n;
+    return n;
+}
+
+/* Returns the number of leading ASCII code units in source[0, max). */
+static size_t countASCIIPrefixUTF16(const UTF16 *source, size_t max) {
+    size_t n = 0;
+    for (; max - n >= 4; n += 4) {
+        uint64_t word;
+        memcpy(&word, source + n, sizeof(word));
+        if (word & 0xFF80FF80FF80FF80ULL)
+            break;
+    }
+    while (n < max && source[n] < 0x80)
+        ++n;
+    return n;
+}
+
+static size_t minSize(size_t a, size_t b) { return a < b ? a : b; }
+
+/*
+ * Decodes the UTF-8 sequence at source if it is a well-formed two- or
+ * three-byte sequence, which covers the rest of the BMP, and returns its
+ * length. Returns 0 for anything else, which is left to the general code.
+ * The checks are those isLegalUTF8 makes for these lengths; the results are
+ * never surrogates.
+ */
+static unsigned decodeBMPUTF8(const UTF8 *source, const UTF8 *sourceEnd,
+                              UTF32 *ch) {
+    ptrdiff_t avail = sourceEnd - source;
+    UTF8 b0 = source[0], b1, b2;
+    if (b0 >= 0xC2 && b0 <= 0xDF && avail >= 2) {
+        b1 = source[1];
+        if ((b1 & 0xC0) != 0x80)
+            return 0;
+        *ch = ((UTF32)(b0 & 0x1F) << 6) | (b1 & 0x3F);
+        return 2;
+    }
+    if (b0 >= 0xE0 && b0 <= 0xEF && avail >= 3) {
+        b1 = source[1];
+        b2 = source[2];
+        if ((b1 & 0xC0) != 0x80 || (b2 & 0xC0) != 0x80)
+            return 0;
+        if ((b0 == 0xE0 && b1 < 0xA0) || (b0 == 0xED && b1 > 0x9F))
+            return 0;
+        *ch = ((UTF32)(b0 & 0x0F) << 12) | ((UTF32)(b1 & 0x3F) << 6) |
+              (b2 & 0x3F);
+        return 3;
+    }
+    return 0;
+}
+
+/* --------------------------------------------------------------------- */
+
 /* The interface converts a whole buffer to avoid function-call overhead.
  * Constants have been gathered. Loops & conditionals have been removed as
  * much as possible for efficiency, in favor of drop-through switches.
@@ -271,7 +346,37 @@ ConversionResult ConvertUTF16toUTF8 (
         unsigned short bytesToWrite = 0;
         const UTF32 byteMask = 0xBF;
         const UTF32 byteMark = 0x80;
-        const UTF16* oldSource = source; /* In case we have to back up because of target overflow. */
+        const UTF16* oldSource; /* In case we have to back up because of target overflow. */
+        if (*source < 0x80) {
+            size_t n = countASCIIPrefixUTF16(
+                source, minSize(sourceEnd - source, targetEnd - target));
+            for (size_t i = 0; i < n; ++i)
+                target[i] = (UTF8)source[i];
+            source += n;
+            target += n;
+            if (source == sourceEnd)
+                break;
+        }
+        /* Fast path for the rest of the BMP, other than surrogates. */
+        ch = *source;
+        if (ch >= 0x80 && (ch < UNI_SUR_HIGH_START || ch > UNI_SUR_LOW_END)) {
+            if (ch < 0x800 && targetEnd - target >= 2) {
+                target[0] = (UTF8)(0xC0 | (ch >> 6));
+                target[1] = (UTF8)(0x80 | (ch & 0x3F));
+                target += 2;
+                ++source;
+                continue;
+            }
+            if (ch >= 0x800 && targetEnd - target >= 3) {
+                target[0] = (UTF8)(0xE0 | (ch >> 12));
+                target[1] = (UTF8)(0x80 | ((ch >> 6) & 0x3F));
+                target[2] = (UTF8)(0x80 | (ch & 0x3F));
+                target += 3;
+                ++source;
+                continue;
+            }
+        }
+        oldSource = source;
         ch = *source++;
         /* If we have a surrogate pair, convert to UTF32 first. */
         if (ch >= UNI_SUR_HIGH_START && ch <= UNI_SUR_HIGH_END) {
@@ -572,7 +677,25 @@ ConversionResult ConvertUTF8toUTF16 (
     UTF16* target = *targetStart;
     while (source < sourceEnd) {
         UTF32 ch = 0;
-        unsigned short extraBytesToRead = trailingBytesForUTF8[*source];
+        unsigned short extraBytesToRead;
+        unsigned length;
+        if (*source < 0x80) {
+            size_t n = countASCIIPrefixUTF8(
+                source, minSize(sourceEnd - source, targetEnd - target));
+            for (size_t i = 0; i < n; ++i)
+                target[i] = source[i];
+            source += n;
+            target += n;
+            if (source == sourceEnd)
+                break;
+        }
+        if (target < targetEnd &&
+            (length = decodeBMPUTF8(source, sourceEnd, &ch)) != 0) {
+            *target++ = (UTF16)ch;
+            source += length;
+            continue;
+        }
+        extraBytesToRead = trailingBytesForUTF8[*source];
         if (extraBytesToRead >= sourceEnd - source) {
             result = sourceExhausted; break;
         }
@@ -646,7 +769,25 @@ static ConversionResult ConvertUTF8toUTF32Impl(
     UTF32* target = *targetStart;
     while (source < sourceEnd) {
         UTF32 ch = 0;
-        unsigned short extraBytesToRead = trailingBytesForUTF8[*source];
+        unsigned short extraBytesToRead;
+        unsigned length;
+        if (*source < 0x80) {
+            size_t n = countASCIIPrefixUTF8(
+                source, minSize(sourceEnd - source, targetEnd - target));
+            for (size_t i = 0; i < n; ++i)
+                target[i] = source[i];
+            source += n;
+            target += n;
+            if (source == sourceEnd)
+                break;
+        }
+        if (target < targetEnd &&
+            (length = decodeBMPUTF8(source, sourceEnd, &ch)) != 0) {
+            *target++ = ch;
+            source += length;
+            continue;
+        }
+        extraBytesToRead = trailingBytesForUTF8[*source];
         if (extraBytesToRead >= sourceEnd - source) {
             if (flags == strictConversion || InputIsPartial) {
                 result = sourceExhausted;
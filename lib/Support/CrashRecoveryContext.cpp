@@ -31,22 +31,44 @@ struct CrashRecoveryContextImpl {
   const CrashRecoveryContextImpl *Next;
 
   CrashRecoveryContext *CRC;
+#if defined(_WIN32)
   ::jmp_buf JumpBuffer;
+#else
+  // Jumping back does not restore the signal mask, which setjmp saves with a
+  // system call on some platforms; the signal handler unblocks the signal.
+  ::sigjmp_buf JumpBuffer;
+#endif
   volatile unsigned Failed : 1;
   unsigned SwitchedThread : 1;
   unsigned ValidJumpBuffer : 1;
 
 public:
-  CrashRecoveryContextImpl(CrashRecoveryContext *CRC) noexcept
-      : CRC(CRC), Failed(false), SwitchedThread(false), ValidJumpBuffer(false) {
+  CrashRecoveryContextImpl(CrashRecoveryContext *CRC) noexcept {
+    activate(CRC);
+  }
+
+  /// Make this the current context of \p CRC on this thread.
+  void activate(CrashRecoveryContext *NewCRC) {
+    CRC = NewCRC;
+    Failed = false;
+    SwitchedThread = false;
+    ValidJumpBuffer = false;
     Next = CurrentContext;
     CurrentContext = this;
   }
-  ~CrashRecoveryContextImpl() {
+
+  /// Stop being the current context, when the CrashRecoveryContext is done.
+  void deactivate() {
     if (!SwitchedThread)
       CurrentContext = Next;
   }
 
+  /// Return a context for \p CRC, reusing the one the thread released last.
+  static CrashRecoveryContextImpl *create(CrashRecoveryContext *CRC);
+
+  /// Deactivate \p CRCI and keep it for the next RunSafely on this thread.
+  static void release(CrashRecoveryContextImpl *CRCI);
+
   /// Called when the separate crash-recovery thread was finished, to
   /// indicate that we don't need to clear the thread-local CurrentContext.
   void setSwitchedThread() {
@@ -73,8 +95,13 @@ public:
     CRC->RetCode = RetCode;
 
     // Jump back to the RunSafely we were called under.
-    if (ValidJumpBuffer)
+    if (ValidJumpBuffer) {
+#if defined(_WIN32)
       longjmp(JumpBuffer, 1);
+#else
+      siglongjmp(JumpBuffer, 1);
+#endif
+    }
 
     // Otherwise let the caller decide of the outcome of the crash. Currently
     // this occurs when using SEH on Windows with MSVC or clang-cl.
@@ -90,6 +117,29 @@ static bool gCrashRecoveryEnabled = false;
 
 static LLVM_THREAD_LOCAL const CrashRecoveryContext *IsRecoveringFromCrash;
 
+// Each thread keeps the last context it released, so that running many small
+// operations safely does not allocate a new one every time. The spare context
+// of a thread that exits is not freed.
+static LLVM_THREAD_LOCAL CrashRecoveryContextImpl *SpareContext;
+
+CrashRecoveryContextImpl *
+CrashRecoveryContextImpl::create(CrashRecoveryContext *CRC) {
+  CrashRecoveryContextImpl *CRCI = SpareContext;
+  if (!CRCI)
+    return new CrashRecoveryContextImpl(CRC);
+  SpareContext = nullptr;
+  CRCI->activate(CRC);
+  return CRCI;
+}
+
+void CrashRecoveryContextImpl::release(CrashRecoveryContextImpl *CRCI) {
+  CRCI->deactivate();
+  if (SpareContext)
+    delete CRCI;
+  else
+    SpareContext = CRCI;
+}
+
 } // namespace
 
 static void installExceptionOrSignalHandlers();
@@ -118,8 +168,8 @@ CrashRecoveryContext::~CrashRecoveryContext() {
   }
   IsRecoveringFromCrash = PC;
 
-  CrashRecoveryContextImpl *CRCI = (CrashRecoveryContextImpl *) Impl;
-  delete CRCI;
+  if (CrashRecoveryContextImpl *CRCI = (CrashRecoveryContextImpl *)Impl)
+    CrashRecoveryContextImpl::release(CRCI);
 }
 
 bool CrashRecoveryContext::isRecoveringFromCrash() {
@@ -230,7 +280,7 @@ bool CrashRecoveryContext::RunSafely(function_ref<void()> Fn) {
     return true;
   }
   assert(!Impl && "Crash recovery context already initialized!");
-  Impl = new CrashRecoveryContextImpl(this);
+  Impl = CrashRecoveryContextImpl::create(this);
   __try {
     Fn();
   } __except (ExceptionFilter(GetExceptionInformation())) {
@@ -414,11 +464,15 @@ bool CrashRecoveryContext::RunSafely(function_ref<void()> Fn) {
   // If crash recovery is disabled, do nothing.
   if (gCrashRecoveryEnabled) {
     assert(!Impl && "Crash recovery context already initialized!");
-    CrashRecoveryContextImpl *CRCI = new CrashRecoveryContextImpl(this);
+    CrashRecoveryContextImpl *CRCI = CrashRecoveryContextImpl::create(this);
     Impl = CRCI;
 
     CRCI->ValidJumpBuffer = true;
+#if defined(_WIN32)
     if (setjmp(CRCI->JumpBuffer) != 0) {
+#else
+    if (sigsetjmp(CRCI->JumpBuffer, /*savesigs=*/0) != 0) {
+#endif
       return false;
     }
   }
@@ -31,12 +31,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/DAGDeltaAlgorithm.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/DeltaAlgorithm.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cassert>
 #include <map>
+#include <mutex>
 using namespace llvm;
 
 #define DEBUG_TYPE "dag-delta"
@@ -60,13 +64,26 @@ private:
 
   DAGDeltaAlgorithm &DDA;
 
+  /// The pool tests are run on, if running in parallel.
+  ThreadPoolInterface *Pool;
+
   std::vector<change_ty> Roots;
 
+  /// All of the changes in increasing order, and the position of each. The
+  /// extended change sets which are tested are kept as bit vectors over these
+  /// positions.
+  std::vector<change_ty> ChangeList;
+  DenseMap<change_ty, unsigned> ChangeIndex;
+
+  /// For each change, by position, the change and its predecessor closure.
+  std::vector<BitVector> PredClosureBits;
+
   /// Cache of failed test results. Successful test results are never cached
   /// since we always reduce following a success. We maintain an independent
   /// cache from that used by the individual delta passes because we may get
   /// hits across multiple individual delta invocations.
-  mutable std::set<changeset_ty> FailedTestsCache;
+  DenseSet<BitVector> FailedTestsCache;
+  std::mutex FailedTestsCacheMutex;
 
   // FIXME: Gross.
   std::map<change_ty, std::vector<change_ty> > Predecessors;
@@ -134,7 +151,8 @@ private:
 
 public:
   DAGDeltaAlgorithmImpl(DAGDeltaAlgorithm &DDA, const changeset_ty &Changes,
-                        const std::vector<edge_ty> &Dependencies);
+                        const std::vector<edge_ty> &Dependencies,
+                        ThreadPoolInterface *Pool);
 
   changeset_ty Run();
 
@@ -146,6 +164,8 @@ public:
   /// \param Required - The set of changes which have previously been
   /// established to be required.
   /// \return - The test result.
+  ///
+  /// When running in parallel this is called from several threads at once.
   bool GetTestResult(const changeset_ty &Changes, const changeset_ty &Required);
 };
 
@@ -176,8 +196,8 @@ public:
 
 DAGDeltaAlgorithmImpl::DAGDeltaAlgorithmImpl(
     DAGDeltaAlgorithm &DDA, const changeset_ty &Changes,
-    const std::vector<edge_ty> &Dependencies)
-    : DDA(DDA) {
+    const std::vector<edge_ty> &Dependencies, ThreadPoolInterface *Pool)
+    : DDA(DDA), Pool(Pool) {
   for (change_ty Change : Changes) {
     Predecessors.try_emplace(Change);
     Successors.try_emplace(Change);
@@ -217,6 +237,16 @@ DAGDeltaAlgorithmImpl::DAGDeltaAlgorithmImpl(
          it2 != ie2; ++it2)
       PredClosure[*it2].insert(Change);
 
+  ChangeList.assign(Changes.begin(), Changes.end());
+  for (unsigned I = 0, E = ChangeList.size(); I != E; ++I)
+    ChangeIndex[ChangeList[I]] = I;
+  PredClosureBits.assign(ChangeList.size(), BitVector(ChangeList.size()));
+  for (unsigned I = 0, E = ChangeList.size(); I != E; ++I) {
+    PredClosureBits[I].set(I);
+    for (change_ty Pred : PredClosure[ChangeList[I]])
+      PredClosureBits[I].set(ChangeIndex[Pred]);
+  }
+
   // Dump useful debug info.
   LLVM_DEBUG({
     llvm::errs() << "-- DAGDeltaAlgorithmImpl --\n";
@@ -282,17 +312,26 @@ DAGDeltaAlgorithmImpl::DAGDeltaAlgorithmImpl(
 
 bool DAGDeltaAlgorithmImpl::GetTestResult(const changeset_ty &Changes,
                                           const changeset_ty &Required) {
-  changeset_ty Extended(Required);
-  Extended.insert(Changes.begin(), Changes.end());
+  BitVector Extended(ChangeList.size());
+  for (change_ty Change : Required)
+    Extended.set(ChangeIndex.find(Change)->second);
   for (change_ty Change : Changes)
-    Extended.insert(pred_closure_begin(Change), pred_closure_end(Change));
+    Extended |= PredClosureBits[ChangeIndex.find(Change)->second];
 
-  if (FailedTestsCache.count(Extended))
-    return false;
+  {
+    std::lock_guard<std::mutex> Lock(FailedTestsCacheMutex);
+    if (FailedTestsCache.count(Extended))
+      return false;
+  }
 
-  bool Result = ExecuteOneTest(Extended);
-  if (!Result)
-    FailedTestsCache.insert(Extended);
+  changeset_ty ExtendedSet;
+  for (unsigned Idx : Extended.set_bits())
+    ExtendedSet.insert(ExtendedSet.end(), ChangeList[Idx]);
+  bool Result = ExecuteOneTest(ExtendedSet);
+  if (!Result) {
+    std::lock_guard<std::mutex> Lock(FailedTestsCacheMutex);
+    FailedTestsCache.insert(std::move(Extended));
+  }
 
   return Result;
 }
@@ -318,7 +357,8 @@ DAGDeltaAlgorithmImpl::Run() {
 
     // Minimize the current set of changes.
     DeltaActiveSetHelper Helper(*this, Required);
-    changeset_ty CurrentMinSet = Helper.Run(CurrentSet);
+    changeset_ty CurrentMinSet =
+        Pool ? Helper.Run(CurrentSet, *Pool) : Helper.Run(CurrentSet);
 
     // Update the set of required changes. Since
     //   CurrentMinSet subset CurrentSet
@@ -348,5 +388,12 @@ void DAGDeltaAlgorithm::anchor() {
 DAGDeltaAlgorithm::changeset_ty
 DAGDeltaAlgorithm::Run(const changeset_ty &Changes,
                        const std::vector<edge_ty> &Dependencies) {
-  return DAGDeltaAlgorithmImpl(*this, Changes, Dependencies).Run();
+  return DAGDeltaAlgorithmImpl(*this, Changes, Dependencies, nullptr).Run();
+}
+
+DAGDeltaAlgorithm::changeset_ty
+DAGDeltaAlgorithm::Run(const changeset_ty &Changes,
+                       const std::vector<edge_ty> &Dependencies,
+                       ThreadPoolInterface &Pool) {
+  return DAGDeltaAlgorithmImpl(*this, Changes, Dependencies, &Pool).Run();
 }
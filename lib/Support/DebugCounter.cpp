@@ -5,6 +5,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/ManagedStatic.h"
+#include <mutex>
 
 using namespace llvm;
 
@@ -152,14 +153,16 @@ void DebugCounter::print(raw_ostream &OS) const {
   OS << "Counters and values:\n";
   for (StringRef CounterName : CounterNames) {
     const CounterInfo *C = getCounterInfo(CounterName);
-    OS << left_justify(C->Name, 32) << ": {" << C->Count << ",";
+    OS << left_justify(C->Name, 32) << ": {"
+       << C->Count.load(std::memory_order_relaxed) << ",";
     printChunks(OS, C->Chunks);
     OS << "}\n";
   }
 }
 
 bool DebugCounter::handleCounterIncrement(CounterInfo &Info) {
-  int64_t CurrCount = Info.Count++;
+  int64_t CurrCount = Info.Count.load(std::memory_order_relaxed);
+  Info.Count.store(CurrCount + 1, std::memory_order_relaxed);
   uint64_t CurrIdx = Info.CurrChunkIdx;
 
   if (Info.Chunks.empty())
@@ -183,13 +186,57 @@ bool DebugCounter::handleCounterIncrement(CounterInfo &Info) {
   return Res;
 }
 
+bool DebugCounter::isInChunks(const CounterInfo &Info, int64_t Count) const {
+  if (Info.Chunks.empty())
+    return true;
+  // The chunks are in increasing order and do not overlap.
+  auto It = partition_point(Info.Chunks,
+                            [&](const IntegerInclusiveInterval &Chunk) {
+                              return Chunk.getEnd() < Count;
+                            });
+  if (It == Info.Chunks.end())
+    return false;
+  if (BreakOnLast && It == Info.Chunks.end() - 1 && Count == It->getEnd()) {
+    LLVM_BUILTIN_DEBUGTRAP;
+  }
+  return It->contains(Count);
+}
+
+void DebugCounter::printQuery(const CounterInfo &Info, int64_t Count,
+                              bool Res) const {
+  if (!ShouldPrintCounterQueries || !Info.IsSet)
+    return;
+  // Keep the lines of concurrent queries apart.
+  static std::mutex PrintMutex;
+  std::unique_lock<std::mutex> Lock(PrintMutex, std::defer_lock);
+  if (Info.ThreadSafe)
+    Lock.lock();
+  dbgs() << "DebugCounter " << Info.Name << "=" << Count
+         << (Res ? " execute" : " skip") << "\n";
+}
+
 bool DebugCounter::shouldExecuteImpl(CounterInfo &Counter) {
   auto &Us = instance();
-  bool Res = Us.handleCounterIncrement(Counter);
-  if (Us.ShouldPrintCounterQueries && Counter.IsSet) {
-    dbgs() << "DebugCounter " << Counter.Name << "=" << (Counter.Count - 1)
-           << (Res ? " execute" : " skip") << "\n";
+  int64_t CurrCount;
+  bool Res;
+  if (Counter.ThreadSafe) {
+    CurrCount = Counter.Count.fetch_add(1, std::memory_order_relaxed);
+    Res = Us.isInChunks(Counter, CurrCount);
+  } else {
+    CurrCount = Counter.Count.load(std::memory_order_relaxed);
+    Res = Us.handleCounterIncrement(Counter);
   }
+  Us.printQuery(Counter, CurrCount, Res);
+  return Res;
+}
+
+bool DebugCounter::shouldExecuteImpl(CounterInfo &Counter, int64_t Index) {
+  assert(Counter.ThreadSafe &&
+         "indexed queries need a counter made with DEBUG_COUNTER_THREADSAFE");
+  auto &Us = instance();
+  Counter.Count.fetch_add(1, std::memory_order_relaxed);
+  bool Res = Us.isInChunks(Counter, Index);
+  Us.printQuery(Counter, Index, Res);
   return Res;
 }
 
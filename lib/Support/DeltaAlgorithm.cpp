@@ -6,56 +6,104 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/DeltaAlgorithm.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
-#include <iterator>
+#include <atomic>
 using namespace llvm;
 
 DeltaAlgorithm::~DeltaAlgorithm() = default;
 
-bool DeltaAlgorithm::GetTestResult(const changeset_ty &Changes) {
+DeltaAlgorithm::changeset_ty
+DeltaAlgorithm::ToChangeSet(const BitVector &Changes) const {
+  changeset_ty Res;
+  for (unsigned Idx : Changes.set_bits())
+    Res.insert(Res.end(), Universe[Idx]);
+  return Res;
+}
+
+bool DeltaAlgorithm::GetTestResult(const BitVector &Changes) {
   if (FailedTestsCache.count(Changes))
     return false;
 
-  bool Result = ExecuteOneTest(Changes);
+  bool Result = ExecuteOneTest(ToChangeSet(Changes));
   if (!Result)
     FailedTestsCache.insert(Changes);
 
   return Result;
 }
 
-void DeltaAlgorithm::Split(const changeset_ty &S, changesetlist_ty &Res) {
-  // FIXME: Allow clients to provide heuristics for improved splitting.
+unsigned
+DeltaAlgorithm::FindFirstPassing(const std::vector<BitVector> &Candidates) {
+  unsigned NumCandidates = Candidates.size();
+  if (!Pool) {
+    for (unsigned I = 0; I != NumCandidates; ++I)
+      if (GetTestResult(Candidates[I]))
+        return I;
+    return NumCandidates;
+  }
 
-  // FIXME: This is really slow.
-  changeset_ty LHS, RHS;
-  unsigned idx = 0, N = S.size() / 2;
-  for (changeset_ty::const_iterator it = S.begin(),
-         ie = S.end(); it != ie; ++it, ++idx)
-    ((idx < N) ? LHS : RHS).insert(*it);
-  if (!LHS.empty())
-    Res.push_back(LHS);
-  if (!RHS.empty())
-    Res.push_back(RHS);
+  // Test every candidate which is not known to fail. Once one passes, the
+  // ones after it can no longer be the first, so those not yet started are
+  // skipped. Those before it are always tested, which makes the answer the
+  // same as that of the sequential search.
+  std::atomic<unsigned> First(NumCandidates);
+  std::vector<char> Failed(NumCandidates, false);
+  ThreadPoolTaskGroup Group(*Pool);
+  for (unsigned I = 0; I != NumCandidates; ++I) {
+    if (FailedTestsCache.count(Candidates[I]))
+      continue;
+    Group.async([&, I] {
+      if (I > First.load())
+        return;
+      if (!ExecuteOneTest(ToChangeSet(Candidates[I]))) {
+        Failed[I] = true;
+        return;
+      }
+      unsigned Current = First.load();
+      while (I < Current && !First.compare_exchange_weak(Current, I))
+        ;
+    });
+  }
+  Group.wait();
+
+  for (unsigned I = 0; I != NumCandidates; ++I)
+    if (Failed[I])
+      FailedTestsCache.insert(Candidates[I]);
+  return First.load();
 }
 
-DeltaAlgorithm::changeset_ty
-DeltaAlgorithm::Delta(const changeset_ty &Changes,
-                      const changesetlist_ty &Sets) {
+void DeltaAlgorithm::Split(const BitVector &S, std::vector<BitVector> &Res) {
+  // FIXME: Allow clients to provide heuristics for improved splitting.
+  BitVector LHS(S.size()), RHS(S.size());
+  unsigned idx = 0, N = S.count() / 2;
+  for (unsigned Change : S.set_bits())
+    ((idx++ < N) ? LHS : RHS).set(Change);
+  if (LHS.any())
+    Res.push_back(std::move(LHS));
+  if (RHS.any())
+    Res.push_back(std::move(RHS));
+}
+
+BitVector DeltaAlgorithm::Delta(const BitVector &Changes,
+                                const std::vector<BitVector> &Sets) {
   // Invariant: union(Res) == Changes
-  UpdatedSearchState(Changes, Sets);
+  changesetlist_ty SetList;
+  for (const BitVector &Set : Sets)
+    SetList.push_back(ToChangeSet(Set));
+  UpdatedSearchState(ToChangeSet(Changes), SetList);
 
   // If there is nothing left we can remove, we are done.
   if (Sets.size() <= 1)
     return Changes;
 
   // Look for a passing subset.
-  changeset_ty Res;
+  BitVector Res;
   if (Search(Changes, Sets, Res))
     return Res;
 
   // Otherwise, partition the sets if possible; if not we are done.
-  changesetlist_ty SplitSets;
-  for (const changeset_ty &Set : Sets)
+  std::vector<BitVector> SplitSets;
+  for (const BitVector &Set : Sets)
     Split(Set, SplitSets);
   if (SplitSets.size() == Sets.size())
     return Changes;
@@ -63,49 +111,68 @@ DeltaAlgorithm::Delta(const changeset_ty &Changes,
   return Delta(Changes, SplitSets);
 }
 
-bool DeltaAlgorithm::Search(const changeset_ty &Changes,
-                            const changesetlist_ty &Sets,
-                            changeset_ty &Res) {
-  // FIXME: Parallelize.
-  for (changesetlist_ty::const_iterator it = Sets.begin(),
-         ie = Sets.end(); it != ie; ++it) {
-    // If the test passes on this subset alone, recurse.
-    if (GetTestResult(*it)) {
-      changesetlist_ty Sets;
-      Split(*it, Sets);
-      Res = Delta(*it, Sets);
-      return true;
+bool DeltaAlgorithm::Search(const BitVector &Changes,
+                            const std::vector<BitVector> &Sets,
+                            BitVector &Res) {
+  // Try each subset alone and, if we have more than two sets, its complement,
+  // in that order.
+  bool TryComplements = Sets.size() > 2;
+  std::vector<BitVector> Candidates;
+  for (const BitVector &Set : Sets) {
+    Candidates.push_back(Set);
+    if (TryComplements) {
+      Candidates.push_back(Changes);
+      Candidates.back().reset(Set);
     }
+  }
 
-    // Otherwise, if we have more than two sets, see if test passes on the
-    // complement.
-    if (Sets.size() > 2) {
-      // FIXME: This is really slow.
-      changeset_ty Complement;
-      std::set_difference(Changes.begin(), Changes.end(), it->begin(),
-                          it->end(),
-                          std::inserter(Complement, Complement.begin()));
-      if (GetTestResult(Complement)) {
-        changesetlist_ty ComplementSets;
-        ComplementSets.insert(ComplementSets.end(), Sets.begin(), it);
-        ComplementSets.insert(ComplementSets.end(), it + 1, Sets.end());
-        Res = Delta(Complement, ComplementSets);
-        return true;
-      }
-    }
+  unsigned Passing = FindFirstPassing(Candidates);
+  if (Passing == Candidates.size())
+    return false;
+
+  unsigned SetIdx = TryComplements ? Passing / 2 : Passing;
+  if (!TryComplements || Passing % 2 == 0) {
+    // The test passes on this subset alone, recurse.
+    std::vector<BitVector> SubSets;
+    Split(Sets[SetIdx], SubSets);
+    Res = Delta(Sets[SetIdx], SubSets);
+    return true;
   }
 
-  return false;
+  // The test passes on the complement.
+  std::vector<BitVector> ComplementSets;
+  ComplementSets.insert(ComplementSets.end(), Sets.begin(),
+                        Sets.begin() + SetIdx);
+  ComplementSets.insert(ComplementSets.end(), Sets.begin() + SetIdx + 1,
+                        Sets.end());
+  Res = Delta(Candidates[Passing], ComplementSets);
+  return true;
 }
 
 DeltaAlgorithm::changeset_ty DeltaAlgorithm::Run(const changeset_ty &Changes) {
+  // Failed tests are remembered across runs over the same changes.
+  if (!std::equal(Universe.begin(), Universe.end(), Changes.begin(),
+                  Changes.end())) {
+    Universe.assign(Changes.begin(), Changes.end());
+    FailedTestsCache.clear();
+  }
+
   // Check empty set first to quickly find poor test functions.
-  if (GetTestResult(changeset_ty()))
+  BitVector All(Universe.size(), true);
+  if (GetTestResult(BitVector(Universe.size())))
     return changeset_ty();
 
   // Otherwise run the real delta algorithm.
-  changesetlist_ty Sets;
-  Split(Changes, Sets);
+  std::vector<BitVector> Sets;
+  Split(All, Sets);
+
+  return ToChangeSet(Delta(All, Sets));
+}
 
-  return Delta(Changes, Sets);
+DeltaAlgorithm::changeset_ty DeltaAlgorithm::Run(const changeset_ty &Changes,
+                                                 ThreadPoolInterface &Pool) {
+  this->Pool = &Pool;
+  changeset_ty Res = Run(Changes);
+  this->Pool = nullptr;
+  return Res;
 }
@@ -14,6 +14,114 @@
 
 using namespace llvm;
 
+static uint64_t getWidthMask(unsigned BitWidth) {
+  return BitWidth == 64 ? UINT64_MAX : (UINT64_C(1) << BitWidth) - 1;
+}
+
+/// The same computation as SignedDivisionByConstantInfo::get for a divisor
+/// of at most 64 bits, done in a uint64_t. Every intermediate value is reduced
+/// modulo 2^BitWidth, just as APInt would, so the results are identical.
+static SignedDivisionByConstantInfo getSignedMagic64(uint64_t D,
+                                                     unsigned BitWidth) {
+  uint64_t Mask = getWidthMask(BitWidth);
+  uint64_t SignedMin = UINT64_C(1) << (BitWidth - 1);
+  bool IsNegative = D & SignedMin;
+
+  uint64_t AD = IsNegative ? -D & Mask : D;
+  uint64_t T = SignedMin + (D >> (BitWidth - 1));
+  uint64_t ANC = (T - 1 - T % AD) & Mask;
+  unsigned P = BitWidth - 1;
+  uint64_t Q1 = SignedMin / ANC, R1 = SignedMin % ANC;
+  uint64_t Q2 = SignedMin / AD, R2 = SignedMin % AD;
+  uint64_t Delta;
+  do {
+    P = P + 1;
+    Q1 = (Q1 << 1) & Mask;
+    R1 = (R1 << 1) & Mask;
+    if (R1 >= ANC) {
+      Q1 = (Q1 + 1) & Mask;
+      R1 = (R1 - ANC) & Mask;
+    }
+    Q2 = (Q2 << 1) & Mask;
+    R2 = (R2 << 1) & Mask;
+    if (R2 >= AD) {
+      Q2 = (Q2 + 1) & Mask;
+      R2 = (R2 - AD) & Mask;
+    }
+    Delta = (AD - R2) & Mask;
+  } while (Q1 < Delta || (Q1 == Delta && R1 == 0));
+
+  uint64_t Magic = (Q2 + 1) & Mask;
+  if (IsNegative)
+    Magic = -Magic & Mask;
+  SignedDivisionByConstantInfo Retval;
+  Retval.Magic = APInt(BitWidth, Magic);
+  Retval.ShiftAmount = P - BitWidth;
+  return Retval;
+}
+
+/// The same computation as UnsignedDivisionByConstantInfo::get for a divisor
+/// of at most 64 bits, done in a uint64_t.
+static UnsignedDivisionByConstantInfo
+getUnsignedMagic64(uint64_t D, unsigned BitWidth, unsigned LeadingZeros,
+                   bool AllowEvenDivisorOptimization) {
+  uint64_t Mask = getWidthMask(BitWidth);
+  uint64_t AllOnes = getWidthMask(BitWidth - LeadingZeros);
+  uint64_t SignedMin = UINT64_C(1) << (BitWidth - 1);
+  uint64_t SignedMax = Mask >> 1;
+  bool IsAdd = false;
+
+  uint64_t NC = (AllOnes - ((AllOnes + 1 - D) & Mask) % D) & Mask;
+  assert(NC % D == D - 1 && "Unexpected NC value");
+  unsigned P = BitWidth - 1;
+  uint64_t Q1 = SignedMin / NC, R1 = SignedMin % NC;
+  uint64_t Q2 = SignedMax / D, R2 = SignedMax % D;
+  uint64_t Delta;
+  do {
+    P = P + 1;
+    if (R1 >= ((NC - R1) & Mask)) {
+      Q1 = ((Q1 << 1) + 1) & Mask;
+      R1 = ((R1 << 1) - NC) & Mask;
+    } else {
+      Q1 = (Q1 << 1) & Mask;
+      R1 = (R1 << 1) & Mask;
+    }
+    if (((R2 + 1) & Mask) >= ((D - R2) & Mask)) {
+      if (Q2 >= SignedMax)
+        IsAdd = true;
+      Q2 = ((Q2 << 1) + 1) & Mask;
+      R2 = ((R2 << 1) + 1 - D) & Mask;
+    } else {
+      if (Q2 >= SignedMin)
+        IsAdd = true;
+      Q2 = (Q2 << 1) & Mask;
+      R2 = ((R2 << 1) + 1) & Mask;
+    }
+    Delta = (D - 1 - R2) & Mask;
+  } while (P < BitWidth * 2 && (Q1 < Delta || (Q1 == Delta && R1 == 0)));
+
+  UnsignedDivisionByConstantInfo Retval;
+  if (IsAdd && !(D & 1) && AllowEvenDivisorOptimization) {
+    unsigned PreShift = llvm::countr_zero(D);
+    Retval = getUnsignedMagic64(D >> PreShift, BitWidth,
+                                LeadingZeros + PreShift, true);
+    assert(Retval.IsAdd == 0 && Retval.PreShift == 0);
+    Retval.PreShift = PreShift;
+    return Retval;
+  }
+
+  Retval.Magic = APInt(BitWidth, (Q2 + 1) & Mask);
+  Retval.IsAdd = IsAdd;
+  Retval.PostShift = P - BitWidth;
+  // Reduce shift amount for IsAdd.
+  if (Retval.IsAdd) {
+    assert(Retval.PostShift > 0 && "Unexpected shift");
+    Retval.PostShift -= 1;
+  }
+  Retval.PreShift = 0;
+  return Retval;
+}
+
 /// Calculate the magic numbers required to implement a signed integer division
 /// by a constant as a sequence of multiplies, adds and shifts.  Requires that
 /// the divisor not be 0, 1, or -1.  Taken from "Hacker's Delight", Henry S.
@@ -24,6 +132,9 @@ SignedDivisionByConstantInfo SignedDivisionByConstantInfo::get(const APInt &D) {
   // We'd be endlessly stuck in the loop.
   assert(D.getBitWidth() >= 3 && "Does not work at smaller bitwidths.");
 
+  if (D.getBitWidth() <= 64)
+    return getSignedMagic64(D.getZExtValue(), D.getBitWidth());
+
   APInt Delta;
   APInt SignedMin = APInt::getSignedMinValue(D.getBitWidth());
   struct SignedDivisionByConstantInfo Retval;
@@ -76,6 +187,10 @@ UnsignedDivisionByConstantInfo::get(const APInt &D, unsigned LeadingZeros,
   assert(!D.isZero() && !D.isOne() && "Precondition violation.");
   assert(D.getBitWidth() > 1 && "Does not work at smaller bitwidths.");
 
+  if (D.getBitWidth() <= 64)
+    return getUnsignedMagic64(D.getZExtValue(), D.getBitWidth(), LeadingZeros,
+                              AllowEvenDivisorOptimization);
+
   APInt Delta;
   struct UnsignedDivisionByConstantInfo Retval;
   Retval.IsAdd = false; // initialize "add" indicator
@@ -24,9 +24,12 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
+#include <mutex>
 #include <new>
 #include <sys/types.h>
 #include <system_error>
@@ -122,7 +125,7 @@ template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getFileAux(const Twine &Filename, uint64_t MapSize, uint64_t Offset,
            bool IsText, bool RequiresNullTerminator, bool IsVolatile,
-           std::optional<Align> Alignment);
+           std::optional<Align> Alignment, sys::fs::AccessHint Hint);
 
 std::unique_ptr<MemoryBuffer>
 MemoryBuffer::getMemBuffer(StringRef InputData, StringRef BufferName,
@@ -176,12 +179,13 @@ MemoryBuffer::getFileOrSTDIN(const Twine &Filename, bool IsText,
 ErrorOr<std::unique_ptr<MemoryBuffer>>
 MemoryBuffer::getFileSlice(const Twine &FilePath, uint64_t MapSize,
                            uint64_t Offset, bool IsVolatile,
-                           std::optional<Align> Alignment) {
+                           std::optional<Align> Alignment,
+                           sys::fs::AccessHint Hint) {
   sys::sandbox::violationIfEnabled();
 
   return getFileAux<MemoryBuffer>(FilePath, MapSize, Offset, /*IsText=*/false,
                                   /*RequiresNullTerminator=*/false, IsVolatile,
-                                  Alignment);
+                                  Alignment, Hint);
 }
 
 //===----------------------------------------------------------------------===//
@@ -224,9 +228,10 @@ class MemoryBufferMMapFile : public MB {
 
 public:
   MemoryBufferMMapFile(bool RequiresNullTerminator, sys::fs::file_t FD, uint64_t Len,
-                       uint64_t Offset, std::error_code &EC)
+                       uint64_t Offset, std::error_code &EC,
+                       sys::fs::AccessHint Hint = sys::fs::AccessHint::Normal)
       : MFR(FD, Mapmode<MB>, getLegalMapSize(Len, Offset),
-            getLegalMapOffset(Offset), EC) {
+            getLegalMapOffset(Offset), EC, Hint) {
     if (!EC) {
       const char *Start = getStart(Len, Offset);
       MemoryBuffer::init(Start, Start + Len, RequiresNullTerminator);
@@ -263,32 +268,82 @@ getMemoryBufferForStream(sys::fs::file_t FD, const Twine &BufferName) {
 ErrorOr<std::unique_ptr<MemoryBuffer>>
 MemoryBuffer::getFile(const Twine &Filename, bool IsText,
                       bool RequiresNullTerminator, bool IsVolatile,
-                      std::optional<Align> Alignment) {
+                      std::optional<Align> Alignment,
+                      sys::fs::AccessHint Hint) {
   sys::sandbox::violationIfEnabled();
 
   return getFileAux<MemoryBuffer>(Filename, /*MapSize=*/-1, /*Offset=*/0,
                                   IsText, RequiresNullTerminator, IsVolatile,
-                                  Alignment);
+                                  Alignment, Hint);
+}
+
+void MemoryBuffer::getFiles(ArrayRef<StringRef> Filenames,
+                            ThreadPoolInterface &Pool, FileLoadedFn OnLoaded,
+                            bool IsText, bool RequiresNullTerminator,
+                            bool IsVolatile) {
+  sys::sandbox::violationIfEnabled();
+
+  // Rather than queueing one task per file, start one worker per thread of the
+  // pool and let the workers pull files off a shared counter. With thousands
+  // of tiny files this keeps the queueing overhead out of the picture.
+  std::atomic<size_t> NextIndex(0);
+  std::mutex CallbackLock;
+  auto Worker = [&]() {
+    for (size_t I = NextIndex++; I < Filenames.size(); I = NextIndex++) {
+      ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = getFileAux<MemoryBuffer>(
+          Filenames[I], /*MapSize=*/-1, /*Offset=*/0, IsText,
+          RequiresNullTerminator, IsVolatile, /*Alignment=*/std::nullopt,
+          sys::fs::AccessHint::Normal);
+      std::lock_guard<std::mutex> Lock(CallbackLock);
+      OnLoaded(I, std::move(Buf));
+    }
+  };
+
+  size_t NumWorkers =
+      std::min<size_t>(Filenames.size(), std::max(1u, Pool.getMaxConcurrency()));
+  ThreadPoolTaskGroup Group(Pool);
+  for (size_t I = 0; I != NumWorkers; ++I)
+    Group.async(Worker);
+  Group.wait();
+}
+
+SmallVector<ErrorOr<std::unique_ptr<MemoryBuffer>>, 0>
+MemoryBuffer::getFiles(ArrayRef<StringRef> Filenames, ThreadPoolInterface &Pool,
+                       bool IsText, bool RequiresNullTerminator,
+                       bool IsVolatile) {
+  SmallVector<ErrorOr<std::unique_ptr<MemoryBuffer>>, 0> Result;
+  Result.reserve(Filenames.size());
+  for (size_t I = 0, E = Filenames.size(); I != E; ++I)
+    Result.emplace_back(std::make_error_code(std::errc::operation_canceled));
+  getFiles(
+      Filenames, Pool,
+      [&](size_t Index, ErrorOr<std::unique_ptr<MemoryBuffer>> Buf) {
+        Result[Index] = std::move(Buf);
+      },
+      IsText, RequiresNullTerminator, IsVolatile);
+  return Result;
 }
 
 template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getOpenFileImpl(sys::fs::file_t FD, const Twine &Filename, uint64_t FileSize,
                 uint64_t MapSize, int64_t Offset, bool RequiresNullTerminator,
-                bool IsVolatile, std::optional<Align> Alignment);
+                bool IsVolatile, std::optional<Align> Alignment,
+                sys::fs::AccessHint Hint);
 
 template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getFileAux(const Twine &Filename, uint64_t MapSize, uint64_t Offset,
            bool IsText, bool RequiresNullTerminator, bool IsVolatile,
-           std::optional<Align> Alignment) {
+           std::optional<Align> Alignment, sys::fs::AccessHint Hint) {
   Expected<sys::fs::file_t> FDOrErr = sys::fs::openNativeFileForRead(
       Filename, IsText ? sys::fs::OF_TextWithCRLF : sys::fs::OF_None);
   if (!FDOrErr)
     return errorToErrorCode(FDOrErr.takeError());
   sys::fs::file_t FD = *FDOrErr;
   auto Ret = getOpenFileImpl<MB>(FD, Filename, /*FileSize=*/-1, MapSize, Offset,
-                                 RequiresNullTerminator, IsVolatile, Alignment);
+                                 RequiresNullTerminator, IsVolatile, Alignment,
+                                 Hint);
   sys::fs::closeFile(FD);
   return Ret;
 }
@@ -300,7 +355,8 @@ WritableMemoryBuffer::getFile(const Twine &Filename, bool IsVolatile,
 
   return getFileAux<WritableMemoryBuffer>(
       Filename, /*MapSize=*/-1, /*Offset=*/0, /*IsText=*/false,
-      /*RequiresNullTerminator=*/false, IsVolatile, Alignment);
+      /*RequiresNullTerminator=*/false, IsVolatile, Alignment,
+      sys::fs::AccessHint::Normal);
 }
 
 ErrorOr<std::unique_ptr<WritableMemoryBuffer>>
@@ -311,7 +367,8 @@ WritableMemoryBuffer::getFileSlice(const Twine &Filename, uint64_t MapSize,
 
   return getFileAux<WritableMemoryBuffer>(
       Filename, MapSize, Offset, /*IsText=*/false,
-      /*RequiresNullTerminator=*/false, IsVolatile, Alignment);
+      /*RequiresNullTerminator=*/false, IsVolatile, Alignment,
+      sys::fs::AccessHint::Normal);
 }
 
 std::unique_ptr<WritableMemoryBuffer>
@@ -485,7 +542,8 @@ template <typename MB>
 static ErrorOr<std::unique_ptr<MB>>
 getOpenFileImpl(sys::fs::file_t FD, const Twine &Filename, uint64_t FileSize,
                 uint64_t MapSize, int64_t Offset, bool RequiresNullTerminator,
-                bool IsVolatile, std::optional<Align> Alignment) {
+                bool IsVolatile, std::optional<Align> Alignment,
+                sys::fs::AccessHint Hint) {
   static int PageSize = sys::Process::getPageSizeEstimate();
 
   // Default is to map the full file.
@@ -516,7 +574,7 @@ getOpenFileImpl(sys::fs::file_t FD, const Twine &Filename, uint64_t FileSize,
     std::error_code EC;
     std::unique_ptr<MB> Result(
         new (NamedBufferAlloc(Filename)) MemoryBufferMMapFile<MB>(
-            RequiresNullTerminator, FD, MapSize, Offset, EC));
+            RequiresNullTerminator, FD, MapSize, Offset, EC, Hint));
     if (!EC) {
       // On at least Linux, and possibly on other systems, mmap may return pages
       // from the page cache that are not properly filled with trailing zeroes,
@@ -574,7 +632,7 @@ MemoryBuffer::getOpenFile(sys::fs::file_t FD, const Twine &Filename,
 
   return getOpenFileImpl<MemoryBuffer>(FD, Filename, FileSize, FileSize, 0,
                                        RequiresNullTerminator, IsVolatile,
-                                       Alignment);
+                                       Alignment, sys::fs::AccessHint::Normal);
 }
 
 ErrorOr<std::unique_ptr<MemoryBuffer>> MemoryBuffer::getOpenFileSlice(
@@ -585,7 +643,8 @@ ErrorOr<std::unique_ptr<MemoryBuffer>> MemoryBuffer::getOpenFileSlice(
   sys::sandbox::violationIfEnabled();
 
   return getOpenFileImpl<MemoryBuffer>(FD, Filename, -1, MapSize, Offset, false,
-                                       IsVolatile, Alignment);
+                                       IsVolatile, Alignment,
+                                       sys::fs::AccessHint::Normal);
 }
 
 ErrorOr<std::unique_ptr<MemoryBuffer>> MemoryBuffer::getSTDIN() {
@@ -19,10 +19,14 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileSystem/PathCanonicalizer.h"
 #include "llvm/Support/IOSandbox.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
+#include <atomic>
 #include <cctype>
+#include <optional>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -1215,6 +1219,139 @@ Error readNativeFileToEOF(file_t FileHandle, SmallVectorImpl<char> &Buffer,
   }
 }
 
+PathCanonicalizer::PathCanonicalizer() : Saver(Alloc) {
+  WorkingDirError = current_path(WorkingDir);
+}
+
+ErrorOr<PathCanonicalizer::CacheEntry>
+PathCanonicalizer::resolveAndCache(StringRef Path) {
+  SmallString<256> Real;
+  StringRef Canonical = Path;
+  file_status Status;
+#ifdef _WIN32
+  // Canonical paths on Windows also normalize the case of each component,
+  // which needs the full lookup even for regular files and directories.
+  if (std::error_code EC = real_path(Path, Real))
+    return EC;
+  Canonical = Real;
+  if (std::error_code EC = status(Real, Status))
+    return EC;
+#else
+  // The parent of Path is canonical, so Path is canonical too unless it is a
+  // symlink.
+  if (std::error_code EC = status(Path, Status, /*Follow=*/false))
+    return EC;
+  if (is_symlink_file(Status)) {
+    if (std::error_code EC = real_path(Path, Real))
+      return EC;
+    Canonical = Real;
+    if (std::error_code EC = status(Real, Status))
+      return EC;
+  }
+#endif
+
+  SmartScopedWriter<true> Lock(Mutex);
+  auto [It, Inserted] = Cache.try_emplace(Path);
+  if (Inserted)
+    It->second = {Saver.save(Canonical), is_directory(Status)};
+  return It->second;
+}
+
+ErrorOr<StringRef> PathCanonicalizer::canonicalize(const Twine &Path) {
+  sandbox::violationIfEnabled();
+
+  SmallString<256> Absolute;
+  Path.toVector(Absolute);
+  if (Absolute.empty())
+    return StringRef();
+  if (!path::is_absolute(Absolute)) {
+    if (WorkingDirError)
+      return WorkingDirError;
+    path::make_absolute(WorkingDir, Absolute);
+  }
+
+  // Walk the path one component at a time, keeping Resolved canonical. Each
+  // step looks up the canonical parent plus the next component, so paths that
+  // reach the same directory through different spellings share cache entries.
+  SmallString<256> Resolved = path::root_path(Absolute);
+  StringRef Interned;
+  // Like real_path(), reject any component, even "." or "..", that follows
+  // something other than a directory.
+  bool IsDirectory = true;
+  StringRef Relative = path::relative_path(Absolute);
+  for (auto I = path::begin(Relative), E = path::end(Relative); I != E; ++I) {
+    StringRef Component = *I;
+    if (!IsDirectory)
+      return make_error_code(errc::not_a_directory);
+    if (Component == ".")
+      continue;
+    Interned = StringRef();
+    if (Component == "..") {
+      // ".." is applied after resolving symlinks, as the kernel does.
+      if (path::has_relative_path(Resolved))
+        path::remove_filename(Resolved);
+      continue;
+    }
+    path::append(Resolved, Component);
+    std::optional<CacheEntry> Entry;
+    {
+      SmartScopedReader<true> Lock(Mutex);
+      auto It = Cache.find(Resolved);
+      if (It != Cache.end())
+        Entry = It->second;
+    }
+    if (!Entry) {
+      ErrorOr<CacheEntry> Resolution = resolveAndCache(Resolved);
+      if (!Resolution)
+        return Resolution.getError();
+      Entry = *Resolution;
+    }
+    Interned = Entry->Canonical;
+    IsDirectory = Entry->IsDirectory;
+    Resolved = Interned;
+  }
+  if (!Interned.empty())
+    return Interned;
+
+  // The path ended in the root or in a ".." component; intern the directory it
+  // names. Its parent is canonical, so this is only an extra lookup on Windows.
+  ErrorOr<CacheEntry> Root = resolveAndCache(Resolved);
+  if (!Root)
+    return Root.getError();
+  return Root->Canonical;
+}
+
+SmallVector<ErrorOr<StringRef>, 0>
+PathCanonicalizer::canonicalizeAll(ArrayRef<StringRef> Paths) {
+  SmallVector<ErrorOr<StringRef>, 0> Result;
+  Result.reserve(Paths.size());
+  for (StringRef P : Paths)
+    Result.push_back(canonicalize(P));
+  return Result;
+}
+
+SmallVector<ErrorOr<StringRef>, 0>
+PathCanonicalizer::canonicalizeAll(ArrayRef<StringRef> Paths,
+                                   ThreadPoolInterface &Pool) {
+  SmallVector<ErrorOr<StringRef>, 0> Result(
+      Paths.size(), std::make_error_code(std::errc::operation_canceled));
+
+  // As in MemoryBuffer::getFiles, start one worker per thread of the pool and
+  // let them pull paths off a shared counter.
+  std::atomic<size_t> NextIndex(0);
+  auto Worker = [&]() {
+    for (size_t I = NextIndex++; I < Paths.size(); I = NextIndex++)
+      Result[I] = canonicalize(Paths[I]);
+  };
+  size_t NumWorkers =
+      std::min<size_t>(Paths.size(), std::max(1u, Pool.getMaxConcurrency()));
+  ThreadPoolTaskGroup Group(Pool);
+  for (size_t I = 0; I != NumWorkers; ++I)
+    Group.async(Worker);
+  Group.wait();
+  return Result;
+}
+
 } // end namespace fs
 } // end namespace sys
 } // end namespace llvm
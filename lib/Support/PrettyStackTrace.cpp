@@ -265,6 +265,11 @@ PrettyStackTraceFormat::PrettyStackTraceFormat(const char *Format, ...) {
 
 void PrettyStackTraceFormat::print(raw_ostream &OS) const { OS << Str << "\n"; }
 
+void llvm::detail::printPrettyStackTraceFormat(
+    raw_ostream &OS, const format_object_base &Format) {
+  OS << Format << '\n';
+}
+
 void PrettyStackTraceProgram::print(raw_ostream &OS) const {
   OS << "Program arguments: ";
   // Print the argument list.
@@ -13,6 +13,7 @@
 #include "llvm/Support/Program.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 using namespace llvm;
 using namespace sys;
@@ -72,6 +73,26 @@ ProcessInfo sys::ExecuteNoWait(StringRef Program, ArrayRef<StringRef> Args,
   return PI;
 }
 
+ProcessPool::ProcessPool(unsigned MaxRunning)
+    : MaxRunning(MaxRunning ? MaxRunning
+                            : hardware_concurrency().compute_thread_count()) {}
+
+ProcessPool::~ProcessPool() = default;
+
+size_t ProcessPool::addJob(StringRef Program, ArrayRef<StringRef> Args,
+                           std::optional<ArrayRef<StringRef>> Env) {
+  Job &J = Jobs.emplace_back();
+  J.Program = Program.str();
+  for (StringRef Arg : Args)
+    J.Args.push_back(Arg.str());
+  if (Env) {
+    J.Env.emplace();
+    for (StringRef Var : *Env)
+      J.Env->push_back(Var.str());
+  }
+  return NumJobsRun + Jobs.size() - 1;
+}
+
 bool sys::commandLineFitsWithinSystemLimits(StringRef Program,
                                             ArrayRef<const char *> Args) {
   SmallVector<StringRef, 8> StringRefArgs(Args);
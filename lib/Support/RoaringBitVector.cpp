@@ -0,0 +1,1088 @@
+//===- RoaringBitVector.cpp - A roaring bitmap ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the containers of RoaringBitVector and the operations
+// between them.
+//
+// Array and bitmap containers are kept canonical: a block with at most
+// MaxArraySize members is an array, a denser one is a bitmap. Run containers
+// are only made on request, and any operation that cannot cheaply keep a run
+// container works on a bitmap and converts the result back to an array if it
+// is small enough.
+//
+// The bitmap loops work on whole 64-bit words over fixed-size arrays, which
+// compilers turn into vector code where the target has it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/RoaringBitVector.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/bit.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Errc.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace llvm;
+using namespace llvm::support;
+
+static constexpr unsigned MaxArraySize = RoaringBitVector::MaxArraySize;
+static constexpr unsigned BitmapWords = RoaringBitVector::BitmapWords;
+/// A run container needs more memory than a bitmap beyond this many runs.
+static constexpr unsigned MaxRuns = BitmapWords * 2;
+
+template <typename VectorT> static void releaseMemory(VectorT &V) {
+  VectorT().swap(V);
+}
+
+static uint32_t countWords(const uint64_t *Words) {
+  uint32_t Count = 0;
+  for (unsigned I = 0; I != BitmapWords; ++I)
+    Count += llvm::popcount(Words[I]);
+  return Count;
+}
+
+/// Set the bits in [Start, Last] of a bitmap.
+static void setWordRange(uint64_t *Words, unsigned Start, unsigned Last) {
+  unsigned FirstWord = Start / 64, LastWord = Last / 64;
+  uint64_t FirstMask = ~uint64_t(0) << (Start % 64);
+  uint64_t LastMask = ~uint64_t(0) >> (63 - Last % 64);
+  if (FirstWord == LastWord) {
+    Words[FirstWord] |= FirstMask & LastMask;
+    return;
+  }
+  Words[FirstWord] |= FirstMask;
+  for (unsigned I = FirstWord + 1; I != LastWord; ++I)
+    Words[I] = ~uint64_t(0);
+  Words[LastWord] |= LastMask;
+}
+
+/// Append the run [Start, Last] to \p Runs, merging it into the last run if
+/// they overlap or touch. Runs must be appended in order of their start.
+static void appendRun(SmallVectorImpl<uint16_t> &Runs, unsigned Start,
+                      unsigned Last) {
+  if (!Runs.empty() && Start <= unsigned(Runs.back()) + 1) {
+    Runs.back() = std::max<unsigned>(Runs.back(), Last);
+    return;
+  }
+  Runs.push_back(Start);
+  Runs.push_back(Last);
+}
+
+static uint32_t countRuns(ArrayRef<uint16_t> Runs) {
+  uint32_t Count = 0;
+  for (unsigned I = 0; I != Runs.size(); I += 2)
+    Count += Runs[I + 1] - Runs[I] + 1;
+  return Count;
+}
+
+unsigned RoaringBitVector::Container::findRun(unsigned Low) const {
+  unsigned Lo = 0, Hi = getNumRuns();
+  while (Lo != Hi) {
+    unsigned Mid = (Lo + Hi) / 2;
+    if (runLast(Mid) < Low)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  return Lo;
+}
+
+unsigned RoaringBitVector::Container::getRunCount() const {
+  switch (Kind) {
+  case ArrayContainer: {
+    unsigned Runs = 1;
+    for (unsigned I = 1; I != Values.size(); ++I)
+      Runs += Values[I] != Values[I - 1] + 1;
+    return Runs;
+  }
+  case BitmapContainer: {
+    // A run starts at each set bit whose predecessor is clear.
+    unsigned Runs = 0;
+    uint64_t Carry = 0;
+    for (unsigned I = 0; I != BitmapWords; ++I) {
+      uint64_t W = Words[I];
+      Runs += llvm::popcount(W & ~((W << 1) | Carry));
+      Carry = W >> 63;
+    }
+    return Runs;
+  }
+  case RunContainer:
+    return getNumRuns();
+  }
+  llvm_unreachable("bad container kind");
+}
+
+bool RoaringBitVector::Container::test(uint16_t Low) const {
+  switch (Kind) {
+  case ArrayContainer:
+    return std::binary_search(Values.begin(), Values.end(), Low);
+  case BitmapContainer:
+    return (Words[Low / 64] >> (Low % 64)) & 1;
+  case RunContainer: {
+    unsigned I = findRun(Low);
+    return I != getNumRuns() && runStart(I) <= Low;
+  }
+  }
+  llvm_unreachable("bad container kind");
+}
+
+bool RoaringBitVector::Container::set(uint16_t Low) {
+  switch (Kind) {
+  case ArrayContainer: {
+    auto I = std::lower_bound(Values.begin(), Values.end(), Low);
+    if (I != Values.end() && *I == Low)
+      return false;
+    if (Cardinality < MaxArraySize) {
+      Values.insert(I, Low);
+      ++Cardinality;
+      return true;
+    }
+    makeBitmap();
+    [[fallthrough]];
+  }
+  case BitmapContainer: {
+    uint64_t Mask = uint64_t(1) << (Low % 64);
+    if (Words[Low / 64] & Mask)
+      return false;
+    Words[Low / 64] |= Mask;
+    ++Cardinality;
+    return true;
+  }
+  case RunContainer: {
+    unsigned I = findRun(Low), NumRuns = getNumRuns();
+    if (I != NumRuns && runStart(I) <= Low)
+      return false;
+    bool JoinPrev = I != 0 && runLast(I - 1) + 1 == Low;
+    bool JoinNext = I != NumRuns && runStart(I) == Low + 1;
+    if (JoinPrev && JoinNext) {
+      Values[2 * I - 1] = runLast(I);
+      Values.erase(Values.begin() + 2 * I, Values.begin() + 2 * I + 2);
+    } else if (JoinPrev) {
+      Values[2 * I - 1] = Low;
+    } else if (JoinNext) {
+      Values[2 * I] = Low;
+    } else {
+      uint16_t Run[] = {Low, Low};
+      Values.insert(Values.begin() + 2 * I, std::begin(Run), std::end(Run));
+    }
+    ++Cardinality;
+    if (getNumRuns() > MaxRuns)
+      makeArrayOrBitmap();
+    return true;
+  }
+  }
+  llvm_unreachable("bad container kind");
+}
+
+bool RoaringBitVector::Container::reset(uint16_t Low) {
+  switch (Kind) {
+  case ArrayContainer: {
+    auto I = std::lower_bound(Values.begin(), Values.end(), Low);
+    if (I == Values.end() || *I != Low)
+      return false;
+    Values.erase(I);
+    --Cardinality;
+    return true;
+  }
+  case BitmapContainer: {
+    uint64_t Mask = uint64_t(1) << (Low % 64);
+    if (!(Words[Low / 64] & Mask))
+      return false;
+    Words[Low / 64] &= ~Mask;
+    --Cardinality;
+    shrinkBitmap();
+    return true;
+  }
+  case RunContainer: {
+    unsigned I = findRun(Low);
+    if (I == getNumRuns() || runStart(I) > Low)
+      return false;
+    uint16_t Start = runStart(I), Last = runLast(I);
+    if (Start == Last) {
+      Values.erase(Values.begin() + 2 * I, Values.begin() + 2 * I + 2);
+    } else if (Start == Low) {
+      Values[2 * I] = Low + 1;
+    } else if (Last == Low) {
+      Values[2 * I + 1] = Low - 1;
+    } else {
+      Values[2 * I + 1] = Low - 1;
+      uint16_t Run[] = {uint16_t(Low + 1), Last};
+      Values.insert(Values.begin() + 2 * I + 2, std::begin(Run),
+                    std::end(Run));
+    }
+    --Cardinality;
+    if (getNumRuns() > MaxRuns)
+      makeArrayOrBitmap();
+    return true;
+  }
+  }
+  llvm_unreachable("bad container kind");
+}
+
+int RoaringBitVector::Container::findFirst() const {
+  switch (Kind) {
+  case ArrayContainer:
+  case RunContainer:
+    return Values.front();
+  case BitmapContainer:
+    return findNext(0);
+  }
+  llvm_unreachable("bad container kind");
+}
+
+int RoaringBitVector::Container::findLast() const {
+  switch (Kind) {
+  case ArrayContainer:
+  case RunContainer:
+    return Values.back();
+  case BitmapContainer:
+    for (unsigned I = BitmapWords; I != 0; --I)
+      if (Words[I - 1])
+        return (I - 1) * 64 + 63 - llvm::countl_zero(Words[I - 1]);
+    return -1;
+  }
+  llvm_unreachable("bad container kind");
+}
+
+int RoaringBitVector::Container::findNext(unsigned From) const {
+  if (From >= BlockSize)
+    return -1;
+  switch (Kind) {
+  case ArrayContainer: {
+    auto I = std::lower_bound(Values.begin(), Values.end(), From);
+    return I == Values.end() ? -1 : *I;
+  }
+  case BitmapContainer: {
+    unsigned WordIdx = From / 64;
+    uint64_t W = Words[WordIdx] & (~uint64_t(0) << (From % 64));
+    while (!W) {
+      if (++WordIdx == BitmapWords)
+        return -1;
+      W = Words[WordIdx];
+    }
+    return WordIdx * 64 + llvm::countr_zero(W);
+  }
+  case RunContainer: {
+    unsigned I = findRun(From);
+    if (I == getNumRuns())
+      return -1;
+    return std::max<unsigned>(runStart(I), From);
+  }
+  }
+  llvm_unreachable("bad container kind");
+}
+
+void RoaringBitVector::Container::toWords(uint64_t *Out) const {
+  if (Kind == BitmapContainer) {
+    std::memcpy(Out, Words.data(), BitmapWords * sizeof(uint64_t));
+    return;
+  }
+  std::memset(Out, 0, BitmapWords * sizeof(uint64_t));
+  if (Kind == ArrayContainer) {
+    for (uint16_t Low : Values)
+      Out[Low / 64] |= uint64_t(1) << (Low % 64);
+    return;
+  }
+  for (unsigned I = 0, E = getNumRuns(); I != E; ++I)
+    setWordRange(Out, runStart(I), runLast(I));
+}
+
+void RoaringBitVector::Container::makeBitmap() {
+  if (Kind == BitmapContainer)
+    return;
+  Words.resize_for_overwrite(BitmapWords);
+  toWords(Words.data());
+  releaseMemory(Values);
+  Kind = BitmapContainer;
+}
+
+void RoaringBitVector::Container::shrinkBitmap() {
+  assert(Kind == BitmapContainer && "not a bitmap");
+  if (Cardinality > MaxArraySize)
+    return;
+  Values.reserve(Cardinality);
+  for (unsigned I = 0; I != BitmapWords; ++I)
+    for (uint64_t W = Words[I]; W; W &= W - 1)
+      Values.push_back(I * 64 + llvm::countr_zero(W));
+  releaseMemory(Words);
+  Kind = ArrayContainer;
+}
+
+void RoaringBitVector::Container::makeArrayOrBitmap() {
+  if (Kind != RunContainer)
+    return;
+  if (Cardinality > MaxArraySize) {
+    makeBitmap();
+    return;
+  }
+  SmallVector<uint16_t, 0> Array;
+  Array.reserve(Cardinality);
+  for (unsigned I = 0, E = getNumRuns(); I != E; ++I)
+    for (unsigned Low = runStart(I), Last = runLast(I); Low <= Last; ++Low)
+      Array.push_back(Low);
+  Values = std::move(Array);
+  Kind = ArrayContainer;
+}
+
+bool RoaringBitVector::Container::runOptimize() {
+  unsigned RunBytes = getRunCount() * 2 * sizeof(uint16_t);
+  unsigned OtherBytes = Cardinality <= MaxArraySize
+                            ? Cardinality * sizeof(uint16_t)
+                            : BitmapWords * sizeof(uint64_t);
+  if (RunBytes >= OtherBytes) {
+    if (Kind != RunContainer)
+      return false;
+    makeArrayOrBitmap();
+    return true;
+  }
+  if (Kind == RunContainer)
+    return false;
+
+  SmallVector<uint16_t, 0> Runs;
+  Runs.reserve(RunBytes / sizeof(uint16_t));
+  for (int Start = findFirst(); Start != -1;) {
+    // Find the end of the run that begins at Start.
+    unsigned Last = Start;
+    if (Kind == ArrayContainer) {
+      const uint16_t *I = llvm::lower_bound(Values, Start);
+      while (I + 1 != Values.end() && I[1] == I[0] + 1)
+        ++I;
+      Last = *I;
+    } else {
+      while (Last + 1 < BlockSize && test(Last + 1))
+        ++Last;
+    }
+    appendRun(Runs, Start, Last);
+    Start = findNext(Last + 1);
+  }
+  Values = std::move(Runs);
+  releaseMemory(Words);
+  Kind = RunContainer;
+  return true;
+}
+
+bool RoaringBitVector::Container::unionWith(const Container &RHS) {
+  uint32_t OldCardinality = Cardinality;
+  if (Cardinality == BlockSize)
+    return false;
+  if (RHS.Cardinality == BlockSize) {
+    *this = RHS;
+    return true;
+  }
+
+  if (Kind == ArrayContainer &&
+      RHS.Kind == ArrayContainer &&
+      Cardinality + RHS.Cardinality <= MaxArraySize) {
+    SmallVector<uint16_t, 0> Union;
+    Union.reserve(Cardinality + RHS.Cardinality);
+    std::set_union(Values.begin(), Values.end(), RHS.Values.begin(),
+                   RHS.Values.end(), std::back_inserter(Union));
+    Values = std::move(Union);
+    Cardinality = Values.size();
+    return Cardinality != OldCardinality;
+  }
+
+  if (Kind == RunContainer &&
+      RHS.Kind == RunContainer) {
+    SmallVector<uint16_t, 0> Union;
+    unsigned I = 0, J = 0, NumRuns = getNumRuns(),
+             RHSNumRuns = RHS.getNumRuns();
+    while (I != NumRuns || J != RHSNumRuns) {
+      if (J == RHSNumRuns ||
+          (I != NumRuns && runStart(I) <= RHS.runStart(J))) {
+        appendRun(Union, runStart(I), runLast(I));
+        ++I;
+      } else {
+        appendRun(Union, RHS.runStart(J), RHS.runLast(J));
+        ++J;
+      }
+    }
+    Values = std::move(Union);
+    Cardinality = countRuns(Values);
+    if (getNumRuns() > MaxRuns)
+      makeArrayOrBitmap();
+    return Cardinality != OldCardinality;
+  }
+
+  makeBitmap();
+  switch (RHS.Kind) {
+  case ArrayContainer:
+    for (uint16_t Low : RHS.Values)
+      Words[Low / 64] |= uint64_t(1) << (Low % 64);
+    break;
+  case BitmapContainer:
+    for (unsigned I = 0; I != BitmapWords; ++I)
+      Words[I] |= RHS.Words[I];
+    break;
+  case RunContainer:
+    for (unsigned I = 0, E = RHS.getNumRuns(); I != E; ++I)
+      setWordRange(Words.data(), RHS.runStart(I), RHS.runLast(I));
+    break;
+  }
+  Cardinality = countWords(Words.data());
+  shrinkBitmap();
+  return Cardinality != OldCardinality;
+}
+
+bool RoaringBitVector::Container::intersectWith(const Container &RHS) {
+  uint32_t OldCardinality = Cardinality;
+  if (RHS.Cardinality == BlockSize)
+    return false;
+  if (Cardinality == BlockSize) {
+    *this = RHS;
+    return true;
+  }
+
+  if (Kind == ArrayContainer) {
+    if (RHS.Kind == ArrayContainer) {
+      auto *Out = Values.begin();
+      const uint16_t *R = RHS.Values.begin(), *RE = RHS.Values.end();
+      for (uint16_t Low : Values) {
+        while (R != RE && *R < Low)
+          ++R;
+        if (R == RE)
+          break;
+        if (*R == Low)
+          *Out++ = Low;
+      }
+      Values.erase(Out, Values.end());
+    } else {
+      llvm::erase_if(Values, [&](uint16_t Low) { return !RHS.test(Low); });
+    }
+    Cardinality = Values.size();
+    return Cardinality != OldCardinality;
+  }
+
+  if (RHS.Kind == ArrayContainer) {
+    SmallVector<uint16_t, 0> Array;
+    for (uint16_t Low : RHS.Values)
+      if (test(Low))
+        Array.push_back(Low);
+    Values = std::move(Array);
+    releaseMemory(Words);
+    Kind = ArrayContainer;
+    Cardinality = Values.size();
+    return Cardinality != OldCardinality;
+  }
+
+  if (Kind == RunContainer &&
+      RHS.Kind == RunContainer) {
+    SmallVector<uint16_t, 0> Intersection;
+    unsigned I = 0, J = 0, NumRuns = getNumRuns(),
+             RHSNumRuns = RHS.getNumRuns();
+    while (I != NumRuns && J != RHSNumRuns) {
+      unsigned Start = std::max(runStart(I), RHS.runStart(J));
+      unsigned Last = std::min(runLast(I), RHS.runLast(J));
+      if (Start <= Last)
+        appendRun(Intersection, Start, Last);
+      if (runLast(I) < RHS.runLast(J))
+        ++I;
+      else
+        ++J;
+    }
+    Values = std::move(Intersection);
+    Cardinality = countRuns(Values);
+    if (getNumRuns() > MaxRuns)
+      makeArrayOrBitmap();
+    return Cardinality != OldCardinality;
+  }
+
+  makeBitmap();
+  if (RHS.Kind == BitmapContainer) {
+    for (unsigned I = 0; I != BitmapWords; ++I)
+      Words[I] &= RHS.Words[I];
+  } else {
+    uint64_t RHSWords[BitmapWords];
+    RHS.toWords(RHSWords);
+    for (unsigned I = 0; I != BitmapWords; ++I)
+      Words[I] &= RHSWords[I];
+  }
+  Cardinality = countWords(Words.data());
+  shrinkBitmap();
+  return Cardinality != OldCardinality;
+}
+
+bool RoaringBitVector::Container::intersectWithComplement(
+    const Container &RHS) {
+  uint32_t OldCardinality = Cardinality;
+  if (Kind == ArrayContainer) {
+    llvm::erase_if(Values, [&](uint16_t Low) { return RHS.test(Low); });
+    Cardinality = Values.size();
+    return Cardinality != OldCardinality;
+  }
+
+  if (RHS.Cardinality == BlockSize) {
+    Values.clear();
+    Cardinality = 0;
+    return true;
+  }
+
+  makeBitmap();
+  switch (RHS.Kind) {
+  case ArrayContainer:
+    for (uint16_t Low : RHS.Values)
+      Words[Low / 64] &= ~(uint64_t(1) << (Low % 64));
+    break;
+  case BitmapContainer:
+    for (unsigned I = 0; I != BitmapWords; ++I)
+      Words[I] &= ~RHS.Words[I];
+    break;
+  case RunContainer: {
+    uint64_t RHSWords[BitmapWords];
+    RHS.toWords(RHSWords);
+    for (unsigned I = 0; I != BitmapWords; ++I)
+      Words[I] &= ~RHSWords[I];
+    break;
+  }
+  }
+  Cardinality = countWords(Words.data());
+  shrinkBitmap();
+  return Cardinality != OldCardinality;
+}
+
+bool RoaringBitVector::Container::intersects(const Container &RHS) const {
+  if (Kind == ArrayContainer)
+    return llvm::any_of(Values, [&](uint16_t Low) { return RHS.test(Low); });
+  if (RHS.Kind == ArrayContainer)
+    return RHS.intersects(*this);
+
+  if (Kind == RunContainer &&
+      RHS.Kind == RunContainer) {
+    unsigned I = 0, J = 0, NumRuns = getNumRuns(),
+             RHSNumRuns = RHS.getNumRuns();
+    while (I != NumRuns && J != RHSNumRuns) {
+      if (std::max(runStart(I), RHS.runStart(J)) <=
+          std::min(runLast(I), RHS.runLast(J)))
+        return true;
+      if (runLast(I) < RHS.runLast(J))
+        ++I;
+      else
+        ++J;
+    }
+    return false;
+  }
+
+  uint64_t LHSWords[BitmapWords], RHSWords[BitmapWords];
+  const uint64_t *L = Words.data(), *R = RHS.Words.data();
+  if (Kind != BitmapContainer) {
+    toWords(LHSWords);
+    L = LHSWords;
+  }
+  if (RHS.Kind != BitmapContainer) {
+    RHS.toWords(RHSWords);
+    R = RHSWords;
+  }
+  uint64_t Any = 0;
+  for (unsigned I = 0; I != BitmapWords; ++I)
+    Any |= L[I] & R[I];
+  return Any != 0;
+}
+
+bool RoaringBitVector::Container::operator==(const Container &RHS) const {
+  if (Key != RHS.Key || Cardinality != RHS.Cardinality)
+    return false;
+  if (Kind == RHS.Kind)
+    return Kind == BitmapContainer ? Words == RHS.Words
+                                                     : Values == RHS.Values;
+  uint64_t LHSWords[BitmapWords], RHSWords[BitmapWords];
+  toWords(LHSWords);
+  RHS.toWords(RHSWords);
+  return std::equal(std::begin(LHSWords), std::end(LHSWords), RHSWords);
+}
+
+RoaringBitVector::Container *RoaringBitVector::findContainer(uint16_t Key) {
+  return llvm::partition_point(
+      Containers, [Key](const Container &C) { return C.Key < Key; });
+}
+
+bool RoaringBitVector::test(unsigned Idx) const {
+  const Container *C = findContainer(Idx >> 16);
+  return C != Containers.end() && C->Key == Idx >> 16 && C->test(Idx);
+}
+
+void RoaringBitVector::reset(unsigned Idx) {
+  Container *C = findContainer(Idx >> 16);
+  if (C == Containers.end() || C->Key != Idx >> 16)
+    return;
+  // When the container is emptied, delete it.
+  if (C->reset(Idx) && C->Cardinality == 0)
+    Containers.erase(C);
+}
+
+bool RoaringBitVector::test_and_set(unsigned Idx) {
+  uint16_t Key = Idx >> 16;
+  Container *C = findContainer(Key);
+  if (C == Containers.end() || C->Key != Key)
+    C = Containers.insert(C, Container(Key, ArrayContainer));
+  return C->set(Idx);
+}
+
+void RoaringBitVector::set(unsigned Begin, unsigned End) {
+  if (Begin >= End)
+    return;
+  unsigned Last = End - 1;
+  for (unsigned Key = Begin >> 16, LastKey = Last >> 16; Key <= LastKey;
+       ++Key) {
+    Container Run(Key, RunContainer);
+    uint16_t Start = Key == Begin >> 16 ? Begin : 0;
+    uint16_t RunLast = Key == LastKey ? Last : BlockSize - 1;
+    Run.Values = {Start, RunLast};
+    Run.Cardinality = RunLast - Start + 1;
+
+    Container *C = findContainer(Key);
+    if (C == Containers.end() || C->Key != Key)
+      Containers.insert(C, std::move(Run));
+    else
+      C->unionWith(Run);
+  }
+}
+
+bool RoaringBitVector::operator==(const RoaringBitVector &RHS) const {
+  return Containers == RHS.Containers;
+}
+
+bool RoaringBitVector::operator|=(const RoaringBitVector &RHS) {
+  if (this == &RHS || RHS.empty())
+    return false;
+
+  bool Changed = false;
+  SmallVector<Container, 0> Result;
+  Result.reserve(Containers.size() + RHS.Containers.size());
+  unsigned I = 0, J = 0, N = Containers.size(), M = RHS.Containers.size();
+  while (I != N || J != M) {
+    if (J == M || (I != N && Containers[I].Key < RHS.Containers[J].Key)) {
+      Result.push_back(std::move(Containers[I++]));
+    } else if (I == N || RHS.Containers[J].Key < Containers[I].Key) {
+      Result.push_back(RHS.Containers[J++]);
+      Changed = true;
+    } else {
+      Changed |= Containers[I].unionWith(RHS.Containers[J++]);
+      Result.push_back(std::move(Containers[I++]));
+    }
+  }
+  Containers = std::move(Result);
+  return Changed;
+}
+
+bool RoaringBitVector::operator&=(const RoaringBitVector &RHS) {
+  if (this == &RHS)
+    return false;
+
+  bool Changed = false;
+  unsigned Out = 0, J = 0, M = RHS.Containers.size();
+  for (Container &C : Containers) {
+    while (J != M && RHS.Containers[J].Key < C.Key)
+      ++J;
+    if (J == M || RHS.Containers[J].Key != C.Key) {
+      Changed = true;
+      continue;
+    }
+    Changed |= C.intersectWith(RHS.Containers[J]);
+    if (C.Cardinality == 0)
+      continue;
+    if (&C != &Containers[Out])
+      Containers[Out] = std::move(C);
+    ++Out;
+  }
+  Containers.truncate(Out);
+  return Changed;
+}
+
+bool RoaringBitVector::intersectWithComplement(const RoaringBitVector &RHS) {
+  if (this == &RHS) {
+    if (!empty()) {
+      clear();
+      return true;
+    }
+    return false;
+  }
+
+  bool Changed = false;
+  unsigned Out = 0, J = 0, M = RHS.Containers.size();
+  for (Container &C : Containers) {
+    while (J != M && RHS.Containers[J].Key < C.Key)
+      ++J;
+    if (J != M && RHS.Containers[J].Key == C.Key) {
+      Changed |= C.intersectWithComplement(RHS.Containers[J]);
+      if (C.Cardinality == 0)
+        continue;
+    }
+    if (&C != &Containers[Out])
+      Containers[Out] = std::move(C);
+    ++Out;
+  }
+  Containers.truncate(Out);
+  return Changed;
+}
+
+void RoaringBitVector::intersectWithComplement(const RoaringBitVector &RHS1,
+                                               const RoaringBitVector &RHS2) {
+  if (this == &RHS2) {
+    RoaringBitVector RHS2Copy(RHS2);
+    intersectWithComplement(RHS1, RHS2Copy);
+    return;
+  }
+  if (this != &RHS1)
+    *this = RHS1;
+  intersectWithComplement(RHS2);
+}
+
+bool RoaringBitVector::intersects(const RoaringBitVector &RHS) const {
+  unsigned I = 0, J = 0, N = Containers.size(), M = RHS.Containers.size();
+  while (I != N && J != M) {
+    if (Containers[I].Key < RHS.Containers[J].Key) {
+      ++I;
+    } else if (RHS.Containers[J].Key < Containers[I].Key) {
+      ++J;
+    } else {
+      if (Containers[I].intersects(RHS.Containers[J]))
+        return true;
+      ++I;
+      ++J;
+    }
+  }
+  return false;
+}
+
+bool RoaringBitVector::contains(const RoaringBitVector &RHS) const {
+  for (const Container &R : RHS.Containers) {
+    const Container *C = findContainer(R.Key);
+    if (C == Containers.end() || C->Key != R.Key ||
+        C->Cardinality < R.Cardinality)
+      return false;
+    Container Rest(R);
+    Rest.intersectWithComplement(*C);
+    if (Rest.Cardinality != 0)
+      return false;
+  }
+  return true;
+}
+
+int64_t RoaringBitVector::find_first() const {
+  if (Containers.empty())
+    return -1;
+  const Container &First = Containers.front();
+  return (int64_t(First.Key) << 16) | First.findFirst();
+}
+
+int64_t RoaringBitVector::find_last() const {
+  if (Containers.empty())
+    return -1;
+  const Container &Last = Containers.back();
+  return (int64_t(Last.Key) << 16) | Last.findLast();
+}
+
+bool RoaringBitVector::runOptimize() {
+  bool Changed = false;
+  for (Container &C : Containers)
+    Changed |= C.runOptimize();
+  return Changed;
+}
+
+unsigned RoaringBitVector::getNumContainers(ContainerKind Kind) const {
+  return llvm::count_if(Containers,
+                        [Kind](const Container &C) { return C.Kind == Kind; });
+}
+
+void RoaringBitVector::iterator::settle() {
+  if (ContainerIdx == BV->Containers.size())
+    return;
+  const Container &C = BV->Containers[ContainerIdx];
+  Pos = 0;
+  Value = (unsigned(C.Key) << 16) | C.findFirst();
+}
+
+void RoaringBitVector::iterator::advance() {
+  const Container &C = BV->Containers[ContainerIdx];
+  unsigned Low = Value & 0xffff;
+  int Next = -1;
+  switch (C.Kind) {
+  case ArrayContainer:
+    if (++Pos < C.Values.size())
+      Next = C.Values[Pos];
+    break;
+  case BitmapContainer:
+    Next = C.findNext(Low + 1);
+    break;
+  case RunContainer:
+    if (Low < C.runLast(Pos))
+      Next = Low + 1;
+    else if (++Pos < C.getNumRuns())
+      Next = C.runStart(Pos);
+    break;
+  }
+  if (Next != -1) {
+    Value = (Value & ~0xffffu) | Next;
+    return;
+  }
+  ++ContainerIdx;
+  settle();
+}
+
+//===----------------------------------------------------------------------===//
+// Serialization
+//===----------------------------------------------------------------------===//
+//
+// The flat form is little-endian throughout:
+//
+//   uint32_t Magic;            "RBV1"
+//   uint32_t NumContainers;
+//   struct {
+//     uint16_t Key;
+//     uint8_t Kind;
+//     uint8_t Reserved;        0
+//     uint32_t Cardinality;
+//     uint32_t Offset;         from the start of the buffer, 8-byte aligned
+//     uint32_t Size;           in uint16_t values, or uint64_t words
+//   } Containers[NumContainers];
+//
+// followed by the payload of each container: the members of an array, the
+// Start and Last of each run, or the words of a bitmap.
+
+static constexpr uint32_t SerializedMagic = 0x31564252; // "RBV1"
+static constexpr size_t HeaderSize = 8;
+static constexpr size_t DescriptorSize = 16;
+
+size_t RoaringBitVector::Container::getPayloadBytes() const {
+  return Kind == BitmapContainer ? BitmapWords * sizeof(uint64_t)
+                                 : Values.size() * sizeof(uint16_t);
+}
+
+size_t RoaringBitVector::getSerializedSize() const {
+  size_t Size = HeaderSize + Containers.size() * DescriptorSize;
+  for (const Container &C : Containers)
+    Size = alignTo(Size, 8) + C.getPayloadBytes();
+  return Size;
+}
+
+void RoaringBitVector::serialize(SmallVectorImpl<char> &Out) const {
+  size_t Start = Out.size();
+  Out.resize(Start + getSerializedSize(), 0);
+  char *Buffer = Out.data() + Start;
+  endian::write32le(Buffer, SerializedMagic);
+  endian::write32le(Buffer + 4, Containers.size());
+
+  char *Descriptor = Buffer + HeaderSize;
+  size_t Offset = HeaderSize + Containers.size() * DescriptorSize;
+  for (const Container &C : Containers) {
+    Offset = alignTo(Offset, 8);
+    bool IsBitmap = C.Kind == BitmapContainer;
+    endian::write16le(Descriptor, C.Key);
+    Descriptor[2] = C.Kind;
+    endian::write32le(Descriptor + 4, C.Cardinality);
+    endian::write32le(Descriptor + 8, Offset);
+    endian::write32le(Descriptor + 12,
+                      IsBitmap ? C.Words.size() : C.Values.size());
+    Descriptor += DescriptorSize;
+
+    char *Payload = Buffer + Offset;
+    if (IsBitmap) {
+      for (uint64_t W : C.Words) {
+        endian::write64le(Payload, W);
+        Payload += sizeof(uint64_t);
+      }
+    } else {
+      for (uint16_t V : C.Values) {
+        endian::write16le(Payload, V);
+        Payload += sizeof(uint16_t);
+      }
+    }
+    Offset += C.getPayloadBytes();
+  }
+}
+
+static Error createMalformedError(const Twine &Msg) {
+  return createStringError(errc::invalid_argument,
+                           "malformed roaring bitmap: " + Msg);
+}
+
+Expected<RoaringBitVector> RoaringBitVector::deserialize(StringRef Buffer) {
+  Expected<RoaringBitVectorView> View = RoaringBitVectorView::create(Buffer);
+  if (!View)
+    return View.takeError();
+
+  RoaringBitVector BV;
+  BV.Containers.reserve(View->NumContainers);
+  for (unsigned I = 0; I != View->NumContainers; ++I) {
+    Container &C =
+        BV.Containers.emplace_back(View->getKey(I), View->getKind(I));
+    C.Cardinality = View->getCardinality(I);
+    const char *Payload = View->getPayload(I);
+    uint32_t Size = View->getPayloadSize(I);
+
+    if (C.Kind == BitmapContainer) {
+      C.Words.resize_for_overwrite(Size);
+      for (unsigned W = 0; W != Size; ++W)
+        C.Words[W] = endian::read64le(Payload + W * sizeof(uint64_t));
+      if (countWords(C.Words.data()) != C.Cardinality)
+        return createMalformedError("wrong bitmap cardinality");
+      C.shrinkBitmap();
+      continue;
+    }
+
+    C.Values.resize_for_overwrite(Size);
+    for (unsigned V = 0; V != Size; ++V)
+      C.Values[V] = endian::read16le(Payload + V * sizeof(uint16_t));
+    if (C.Kind == ArrayContainer) {
+      for (unsigned V = 1; V < Size; ++V)
+        if (C.Values[V - 1] >= C.Values[V])
+          return createMalformedError("unsorted array container");
+      continue;
+    }
+    for (unsigned R = 0, E = C.getNumRuns(); R != E; ++R)
+      if (C.runStart(R) > C.runLast(R) ||
+          (R != 0 && C.runStart(R) <= unsigned(C.runLast(R - 1)) + 1))
+        return createMalformedError("unsorted run container");
+    if (countRuns(C.Values) != C.Cardinality)
+      return createMalformedError("wrong run cardinality");
+    // Convert run containers with more runs than set() and reset() allow.
+    if (C.getNumRuns() > MaxRuns)
+      C.makeArrayOrBitmap();
+  }
+  return BV;
+}
+
+Expected<RoaringBitVectorView> RoaringBitVectorView::create(StringRef Buffer) {
+  if (Buffer.size() < HeaderSize ||
+      endian::read32le(Buffer.data()) != SerializedMagic)
+    return createMalformedError("bad header");
+  uint32_t NumContainers = endian::read32le(Buffer.data() + 4);
+  if ((Buffer.size() - HeaderSize) / DescriptorSize < NumContainers)
+    return createMalformedError("truncated container list");
+
+  RoaringBitVectorView View(Buffer, NumContainers);
+  for (unsigned I = 0; I != NumContainers; ++I) {
+    if (I != 0 && View.getKey(I - 1) >= View.getKey(I))
+      return createMalformedError("unsorted container keys");
+    uint8_t Kind = View.getKind(I);
+    uint32_t Cardinality = View.getCardinality(I);
+    uint64_t Size = View.getPayloadSize(I);
+    if (Cardinality == 0 || Cardinality > RoaringBitVector::BlockSize)
+      return createMalformedError("bad container cardinality");
+
+    uint64_t Bytes;
+    switch (Kind) {
+    case RoaringBitVector::ArrayContainer:
+      if (Size != Cardinality || Cardinality > MaxArraySize)
+        return createMalformedError("bad array container size");
+      Bytes = Size * sizeof(uint16_t);
+      break;
+    case RoaringBitVector::BitmapContainer:
+      if (Size != BitmapWords)
+        return createMalformedError("bad bitmap container size");
+      Bytes = Size * sizeof(uint64_t);
+      break;
+    case RoaringBitVector::RunContainer:
+      if (Size == 0 || Size % 2 != 0)
+        return createMalformedError("bad run container size");
+      Bytes = Size * sizeof(uint16_t);
+      break;
+    default:
+      return createMalformedError("bad container kind");
+    }
+    uint64_t Offset = endian::read32le(Buffer.data() + HeaderSize +
+                                       I * DescriptorSize + 8);
+    if (Offset + Bytes > Buffer.size())
+      return createMalformedError("truncated container");
+  }
+  return View;
+}
+
+uint16_t RoaringBitVectorView::getKey(unsigned I) const {
+  return endian::read16le(Buffer.data() + HeaderSize + I * DescriptorSize);
+}
+
+RoaringBitVector::ContainerKind
+RoaringBitVectorView::getKind(unsigned I) const {
+  return RoaringBitVector::ContainerKind(
+      Buffer[HeaderSize + I * DescriptorSize + 2]);
+}
+
+uint32_t RoaringBitVectorView::getCardinality(unsigned I) const {
+  return endian::read32le(Buffer.data() + HeaderSize + I * DescriptorSize +
+                          4);
+}
+
+const char *RoaringBitVectorView::getPayload(unsigned I) const {
+  return Buffer.data() + endian::read32le(Buffer.data() + HeaderSize +
+                                          I * DescriptorSize + 8);
+}
+
+uint32_t RoaringBitVectorView::getPayloadSize(unsigned I) const {
+  return endian::read32le(Buffer.data() + HeaderSize + I * DescriptorSize +
+                          12);
+}
+
+bool RoaringBitVectorView::test(unsigned Idx) const {
+  uint16_t Key = Idx >> 16, Low = Idx;
+  unsigned Lo = 0, Hi = NumContainers;
+  while (Lo != Hi) {
+    unsigned Mid = (Lo + Hi) / 2;
+    if (getKey(Mid) < Key)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  if (Lo == NumContainers || getKey(Lo) != Key)
+    return false;
+
+  const char *Payload = getPayload(Lo);
+  uint32_t Size = getPayloadSize(Lo);
+  auto ValueAt = [Payload](unsigned I) {
+    return endian::read16le(Payload + I * sizeof(uint16_t));
+  };
+  switch (getKind(Lo)) {
+  case RoaringBitVector::ArrayContainer: {
+    unsigned L = 0, H = Size;
+    while (L != H) {
+      unsigned Mid = (L + H) / 2;
+      if (ValueAt(Mid) < Low)
+        L = Mid + 1;
+      else
+        H = Mid;
+    }
+    return L != Size && ValueAt(L) == Low;
+  }
+  case RoaringBitVector::BitmapContainer:
+    return (endian::read64le(Payload + Low / 64 * sizeof(uint64_t)) >>
+            (Low % 64)) &
+           1;
+  case RoaringBitVector::RunContainer: {
+    // Find the first run whose last member is not below Low.
+    unsigned L = 0, H = Size / 2;
+    while (L != H) {
+      unsigned Mid = (L + H) / 2;
+      if (ValueAt(2 * Mid + 1) < Low)
+        L = Mid + 1;
+      else
+        H = Mid;
+    }
+    return L != Size / 2 && ValueAt(2 * L) <= Low;
+  }
+  }
+  llvm_unreachable("bad container kind");
+}
+
+uint64_t RoaringBitVectorView::count() const {
+  uint64_t BitCount = 0;
+  for (unsigned I = 0; I != NumContainers; ++I)
+    BitCount += getCardinality(I);
+  return BitCount;
+}
+
+void llvm::dump(const RoaringBitVector &LHS, raw_ostream &out) {
+  out << "[";
+  ListSeparator LS(" ");
+  for (unsigned Idx : LHS)
+    out << LS << Idx;
+  out << "]\n";
+}
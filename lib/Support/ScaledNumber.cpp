@@ -21,6 +21,10 @@ using namespace llvm::ScaledNumbers;
 
 std::pair<uint64_t, int16_t> ScaledNumbers::multiply64(uint64_t LHS,
                                                        uint64_t RHS) {
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 Product = (unsigned __int128)LHS * RHS;
+  uint64_t Upper = Product >> 64, Lower = uint64_t(Product);
+#else
   // Separate into two 32-bit digits (U.L).
   auto getU = [](uint64_t N) { return N >> 32; };
   auto getL = [](uint64_t N) { return N & UINT32_MAX; };
@@ -38,6 +42,7 @@ std::pair<uint64_t, int16_t> ScaledNumbers::multiply64(uint64_t LHS,
   };
   addWithCarry(P2);
   addWithCarry(P3);
+#endif
 
   // Check whether the upper digit is empty.
   if (!Upper)
@@ -101,6 +106,20 @@ std::pair<uint64_t, int16_t> ScaledNumbers::divide64(uint64_t Dividend,
 
   // Start with the result of a divide.
   uint64_t Quotient = Dividend / Divisor;
+#ifdef __SIZEOF_INT128__
+  // Divisor is odd, so unless it divides Dividend the remainder never becomes
+  // zero, and the long division below would produce exactly as many more
+  // quotient bits as Quotient has leading zeros. Get them all at once.
+  if (Dividend % Divisor) {
+    int Zeros = llvm::countl_zero(Quotient);
+    unsigned __int128 Wide = (unsigned __int128)Dividend << Zeros;
+    Quotient = uint64_t(Wide / Divisor);
+    Dividend = uint64_t(Wide % Divisor);
+    Shift -= Zeros;
+  } else {
+    Dividend = 0;
+  }
+#else
   Dividend %= Divisor;
 
   // Continue building the quotient with long division.
@@ -117,6 +136,7 @@ std::pair<uint64_t, int16_t> ScaledNumbers::divide64(uint64_t Dividend,
       Dividend -= Divisor;
     }
   }
+#endif
 
   return getRounded(Quotient, Shift, Dividend >= getHalf(Divisor));
 }
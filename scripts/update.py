@@ -522,6 +522,13 @@ src_files = [
     "Support/xxhash.cpp",
 ]
 
+# Sources that exist only in this repository. They are amalgamated with the
+# ones above, but not copied from LLVM.
+local_src_files = [
+    "Support/ConcurrentIntEqClasses.cpp",
+    "Support/RoaringBitVector.cpp",
+]
+
 test_files = [
     "ADT/APFixedPointTest.cpp",
     "ADT/APFloatTest.cpp",
@@ -765,8 +772,9 @@ if __name__ == "__main__":
 
     # Amalgamate lib sources
     print("Amalgamating lib sources")
+    amalgamated_files = sorted(src_files + local_src_files)
     with open(src_dir / "Support.cpp", "w") as f:
-        for file in src_files:
+        for file in amalgamated_files:
             if not file.endswith(".cpp"):
                 continue
 
@@ -782,7 +790,7 @@ if __name__ == "__main__":
                     f.write(f"#undef {name}\n")
 
     with open(src_dir / "Support.c", "w") as f:
-        for file in src_files:
+        for file in amalgamated_files:
             if not file.endswith(".c"):
                 continue
 
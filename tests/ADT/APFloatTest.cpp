@@ -18,6 +18,7 @@
 #include <cmath>
 #include <limits>
 #include <ostream>
+#include <random>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -76,6 +77,47 @@ public:
     EXPECT_EQ(lhs.exponent, expectedExponent);
     EXPECT_EQ(lhs.significand.part, expectedSignificand);
   }
+
+  enum class Operation { Add, Subtract, Multiply, Divide, FusedMultiplyAdd };
+
+  // Compute \p Op with the public entry point, which may use native
+  // arithmetic, and with the generic code, and check that they agree.
+  static void checkNativeArithmetic(Operation Op, const fltSemantics &Sem,
+                                    const APInt &L, const APInt &R,
+                                    const APInt &A) {
+    IEEEFloat Native(Sem, L), Generic(Sem, L);
+    IEEEFloat RHS(Sem, R), Addend(Sem, A);
+    opStatus NativeStatus, GenericStatus;
+    switch (Op) {
+    case Operation::Add:
+      NativeStatus = Native.add(RHS, rmNearestTiesToEven);
+      GenericStatus = Generic.addOrSubtract(RHS, rmNearestTiesToEven, false);
+      break;
+    case Operation::Subtract:
+      NativeStatus = Native.subtract(RHS, rmNearestTiesToEven);
+      GenericStatus = Generic.addOrSubtract(RHS, rmNearestTiesToEven, true);
+      break;
+    case Operation::Multiply:
+      NativeStatus = Native.multiply(RHS, rmNearestTiesToEven);
+      GenericStatus = Generic.multiplyGeneric(RHS, rmNearestTiesToEven);
+      break;
+    case Operation::Divide:
+      NativeStatus = Native.divide(RHS, rmNearestTiesToEven);
+      GenericStatus = Generic.divideGeneric(RHS, rmNearestTiesToEven);
+      break;
+    case Operation::FusedMultiplyAdd:
+      NativeStatus = Native.fusedMultiplyAdd(RHS, Addend, rmNearestTiesToEven);
+      GenericStatus =
+          Generic.fusedMultiplyAddGeneric(RHS, Addend, rmNearestTiesToEven);
+      break;
+    }
+    EXPECT_EQ(Generic.bitcastToAPInt(), Native.bitcastToAPInt())
+        << "op " << int(Op) << " on 0x" << toString(L, 16, false) << ", 0x"
+        << toString(R, 16, false) << ", 0x" << toString(A, 16, false);
+    EXPECT_EQ(GenericStatus, NativeStatus)
+        << "op " << int(Op) << " on 0x" << toString(L, 16, false) << ", 0x"
+        << toString(R, 16, false) << ", 0x" << toString(A, 16, false);
+  }
 };
 } // namespace detail
 } // namespace llvm
@@ -10167,6 +10209,91 @@ TEST(APFloatTest, AddOrSubtractSignificand) {
                   lfLessThanHalf);
 }
 
+// Returns random operands for NativeArithmeticMatchesGeneric. The exponents
+// are mostly near the limits of the native fast path or of the format, and
+// the significands often have few bits set, so that exact results, cancelling
+// sums and results that overflow or underflow are all common.
+static APInt randomNativeOperand(std::mt19937_64 &Rng,
+                                 const fltSemantics &Sem) {
+  unsigned Precision = APFloat::semanticsPrecision(Sem);
+  int Bias = APFloat::semanticsMaxExponent(Sem);
+  int FastPathLimit =
+      (-APFloat::semanticsMinExponent(Sem) - int(Precision)) / 2 - 1;
+  uint64_t Significand = Rng() & ((uint64_t(1) << (Precision - 1)) - 1);
+  Significand &= ~uint64_t(0) << (Rng() % Precision);
+  int Exponent;
+  switch (Rng() % 5) {
+  case 0:
+    Exponent = Rng() % (2 * Bias + 2);
+    break;
+  case 1:
+    Exponent = Bias + int(Rng() % 16) - 8;
+    break;
+  case 2:
+    Exponent = Bias + FastPathLimit + int(Rng() % 5) - 2;
+    break;
+  case 3:
+    Exponent = Bias - FastPathLimit + int(Rng() % 5) - 2;
+    break;
+  default:
+    Exponent = Rng() % 2 ? Rng() % 3 : 2 * Bias + 1 - Rng() % 3;
+    break;
+  }
+  unsigned SizeInBits = APFloat::semanticsSizeInBits(Sem);
+  uint64_t Bits = Significand | (uint64_t(Exponent) << (Precision - 1)) |
+                  (uint64_t(Rng() % 2) << (SizeInBits - 1));
+  return APInt(SizeInBits, Bits);
+}
+
+TEST(APFloatTest, NativeArithmeticMatchesGeneric) {
+  using Helper = detail::IEEEFloatUnitTestHelper;
+  using Operation = Helper::Operation;
+  std::mt19937_64 Rng(0);
+  for (const fltSemantics *Sem :
+       {&APFloat::IEEEsingle(), &APFloat::IEEEdouble()}) {
+    for (int I = 0; I != 20000; ++I) {
+      APInt L = randomNativeOperand(Rng, *Sem);
+      APInt R = randomNativeOperand(Rng, *Sem);
+      APInt A = randomNativeOperand(Rng, *Sem);
+      Helper::checkNativeArithmetic(Operation::Add, *Sem, L, R, A);
+      Helper::checkNativeArithmetic(Operation::Subtract, *Sem, L, R, A);
+      Helper::checkNativeArithmetic(Operation::Multiply, *Sem, L, R, A);
+      Helper::checkNativeArithmetic(Operation::Divide, *Sem, L, R, A);
+      Helper::checkNativeArithmetic(Operation::FusedMultiplyAdd, *Sem, L, R,
+                                    A);
+
+      // Sums that cancel exactly or nearly so.
+      APInt Near = L ^ (Rng() % 4);
+      Helper::checkNativeArithmetic(Operation::Subtract, *Sem, L, Near, A);
+      Near.flipBit(Near.getBitWidth() - 1);
+      Helper::checkNativeArithmetic(Operation::Add, *Sem, L, Near, A);
+
+      // Fused multiply-adds whose product is cancelled by the addend.
+      APFloat Product(*Sem, L);
+      Product.multiply(APFloat(*Sem, R), APFloat::rmNearestTiesToEven);
+      APInt Cancel = Product.bitcastToAPInt() ^ (Rng() % 4);
+      Cancel.flipBit(Cancel.getBitWidth() - 1);
+      Helper::checkNativeArithmetic(Operation::FusedMultiplyAdd, *Sem, L, R,
+                                    Cancel);
+    }
+
+    // A fused multiply-add of the smallest operands the fast path takes,
+    // whose result is the tiny rounding error of the product.
+    int FastPathLimit = (-APFloat::semanticsMinExponent(*Sem) -
+                         int(APFloat::semanticsPrecision(*Sem))) /
+                            2 -
+                        1;
+    APFloat X = APFloat::getOne(*Sem);
+    X.next(false);
+    X = scalbn(X, -FastPathLimit / 2, APFloat::rmNearestTiesToEven);
+    APFloat Square = X * X;
+    Square.changeSign();
+    Helper::checkNativeArithmetic(
+        Operation::FusedMultiplyAdd, *Sem, X.bitcastToAPInt(),
+        X.bitcastToAPInt(), Square.bitcastToAPInt());
+  }
+}
+
 TEST(APFloatTest, hasSignBitInMSB) {
   EXPECT_TRUE(APFloat::hasSignBitInMSB(APFloat::IEEEsingle()));
   EXPECT_TRUE(APFloat::hasSignBitInMSB(APFloat::x87DoubleExtended()));
@@ -0,0 +1,120 @@
+//===- llvm/unittest/ADT/CallableArenaTest.cpp ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/CallableArena.h"
+#include "CountCopyAndMove.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(CallableArenaTest, Basic) {
+  CallableArena<void(std::vector<int> &)> Arena;
+  EXPECT_TRUE(Arena.empty());
+  std::vector<int> Out;
+  Arena.invokeAll(Out);
+  EXPECT_TRUE(Out.empty());
+
+  long Big[16] = {};
+  Big[15] = 3;
+  Arena.push_back([](std::vector<int> &Out) { Out.push_back(1); });
+  Arena.push_back([X = 2](std::vector<int> &Out) { Out.push_back(X); });
+  Arena.push_back([Big](std::vector<int> &Out) { Out.push_back(Big[15]); });
+  Arena.push_back([Count = 4](std::vector<int> &Out) mutable {
+    Out.push_back(Count++);
+  });
+  EXPECT_EQ(4u, Arena.size());
+
+  Arena.invokeAll(Out);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), Out);
+  // The callables stay pending, with their state.
+  Arena.invokeAll(Out);
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 1, 2, 3, 5}), Out);
+
+  Arena.clear();
+  EXPECT_TRUE(Arena.empty());
+  Out.clear();
+  Arena.invokeAll(Out);
+  EXPECT_TRUE(Out.empty());
+
+  // The arena can be reused.
+  Arena.push_back([](std::vector<int> &Out) { Out.push_back(7); });
+  Arena.invokeAll(Out);
+  EXPECT_EQ((std::vector<int>{7}), Out);
+}
+
+TEST(CallableArenaTest, Destruction) {
+  CountCopyAndMove::ResetCounts();
+  int Sum = 0;
+  {
+    CallableArena<void()> Arena;
+    for (int I = 0; I < 100; ++I) {
+      auto Ptr = std::make_unique<int>(I);
+      Arena.push_back([Counter = CountCopyAndMove{}, Ptr = std::move(Ptr),
+                       &Sum] { Sum += *Ptr; });
+      Arena.push_back([I, &Sum] { Sum += I; });
+    }
+    Arena.invokeAll();
+    Arena.clear();
+    EXPECT_EQ(CountCopyAndMove::TotalConstructions(),
+              CountCopyAndMove::Destructions);
+
+    Arena.push_back([Counter = CountCopyAndMove{}] {});
+    // The destructor releases what is still pending.
+  }
+  EXPECT_EQ(2 * 4950, Sum);
+  EXPECT_EQ(CountCopyAndMove::TotalConstructions(),
+            CountCopyAndMove::Destructions);
+}
+
+TEST(CallableArenaTest, Alignment) {
+  struct alignas(64) Aligned {
+    int Value;
+  };
+  CallableArena<void(int &)> Arena;
+  for (int I = 0; I < 10; ++I) {
+    Arena.push_back([A = Aligned{I}](int &Sum) {
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(&A) % 64);
+      Sum += A.Value;
+    });
+    Arena.push_back([](int &Sum) { Sum += 100; });
+  }
+  int Sum = 0;
+  Arena.invokeAll(Sum);
+  EXPECT_EQ(45 + 1000, Sum);
+}
+
+TEST(CallableArenaTest, Move) {
+  CountCopyAndMove::ResetCounts();
+  {
+    CallableArena<int(int)> Arena;
+    Arena.push_back([Counter = CountCopyAndMove{}](int X) { return X; });
+    CallableArena<int(int)> Moved(std::move(Arena));
+    EXPECT_TRUE(Arena.empty());
+    EXPECT_EQ(1u, Moved.size());
+
+    int Calls = 0;
+    Moved.push_back([&Calls](int) { return ++Calls; });
+    Moved.invokeAll(0);
+    EXPECT_EQ(1, Calls);
+
+    Arena = std::move(Moved);
+    EXPECT_TRUE(Moved.empty());
+    Arena.invokeAll(0);
+    EXPECT_EQ(2, Calls);
+  }
+  EXPECT_EQ(CountCopyAndMove::TotalConstructions(),
+            CountCopyAndMove::Destructions);
+}
+
+} // anonymous namespace
@@ -0,0 +1,126 @@
+//===- ADT/ConcurrentIntEqClassesTest.cpp - ConcurrentIntEqClasses tests --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ConcurrentIntEqClasses.h"
+#include "llvm/ADT/IntEqClasses.h"
+#include "llvm/Support/Parallel.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentIntEqClasses, Simple) {
+  ConcurrentIntEqClasses ec(10);
+
+  EXPECT_EQ(0u, ec.join(1, 0));
+  EXPECT_EQ(2u, ec.join(3, 2));
+  ec.join(4, 5);
+  ec.join(7, 6);
+
+  EXPECT_EQ(0u, ec.findLeader(1));
+  EXPECT_EQ(2u, ec.findLeader(3));
+  EXPECT_EQ(4u, ec.findLeader(5));
+  EXPECT_EQ(6u, ec.findLeader(7));
+  EXPECT_EQ(8u, ec.findLeader(8));
+
+  // join two non-leaders.
+  EXPECT_EQ(0u, ec.join(3, 1));
+  EXPECT_EQ(0u, ec.findLeader(2));
+  EXPECT_EQ(0u, ec.findLeader(3));
+
+  // join two leaders, and two members of one class.
+  EXPECT_EQ(4u, ec.join(6, 4));
+  EXPECT_EQ(4u, ec.join(7, 5));
+
+  ec.compress();
+  EXPECT_EQ(4u, ec.getNumClasses());
+  EXPECT_EQ(0u, ec[0]);
+  EXPECT_EQ(0u, ec[1]);
+  EXPECT_EQ(0u, ec[2]);
+  EXPECT_EQ(0u, ec[3]);
+  EXPECT_EQ(1u, ec[4]);
+  EXPECT_EQ(1u, ec[5]);
+  EXPECT_EQ(1u, ec[6]);
+  EXPECT_EQ(1u, ec[7]);
+  EXPECT_EQ(2u, ec[8]);
+  EXPECT_EQ(3u, ec[9]);
+}
+
+TEST(ConcurrentIntEqClasses, JoinAllMatchesIntEqClasses) {
+  const unsigned N = 20000;
+  std::mt19937 Rng(0);
+  std::vector<std::pair<unsigned, unsigned>> Pairs;
+  for (unsigned I = 0; I < N / 2; ++I)
+    Pairs.push_back({Rng() % N, Rng() % N});
+
+  ConcurrentIntEqClasses CEC(N);
+  CEC.joinAll(Pairs);
+  IntEqClasses EC(N);
+  for (auto [A, B] : Pairs)
+    EC.join(A, B);
+
+  for (unsigned I = 0; I < N; ++I)
+    ASSERT_EQ(EC.findLeader(I), CEC.findLeader(I)) << I;
+
+  CEC.compress();
+  EC.compress();
+  ASSERT_EQ(EC.getNumClasses(), CEC.getNumClasses());
+  for (unsigned I = 0; I < N; ++I)
+    ASSERT_EQ(EC[I], CEC[I]) << I;
+}
+
+TEST(ConcurrentIntEqClasses, ConcurrentJoinAndFind) {
+  // Join a chain from both ends at once while other threads look up leaders.
+  const unsigned N = 4096;
+  ConcurrentIntEqClasses CEC(N);
+  parallelFor(0, 4 * N, [&](size_t I) {
+    unsigned K = I / 4;
+    switch (I % 4) {
+    case 0:
+      if (K + 1 < N)
+        CEC.join(K, K + 1);
+      break;
+    case 1:
+      if (K + 1 < N)
+        CEC.join(N - 1 - K, N - 2 - K);
+      break;
+    default:
+      EXPECT_LE(CEC.findLeader(K), K);
+      break;
+    }
+  });
+  for (unsigned I = 0; I < N; ++I)
+    ASSERT_EQ(0u, CEC.findLeader(I));
+}
+
+TEST(ConcurrentIntEqClasses, ToEquivalenceClasses) {
+  ConcurrentIntEqClasses CEC(6);
+  CEC.join(5, 1);
+  CEC.join(3, 5);
+  CEC.join(4, 2);
+  CEC.compress();
+
+  const char *Names[] = {"a", "b", "c", "d", "e", "f"};
+  EquivalenceClasses<const char *> EC =
+      CEC.toEquivalenceClasses(ArrayRef<const char *>(Names));
+  EXPECT_EQ(3u, EC.getNumClasses());
+  EXPECT_EQ(Names[1], EC.getLeaderValue(Names[3]));
+  EXPECT_EQ(Names[1], EC.getLeaderValue(Names[5]));
+  EXPECT_EQ(Names[2], EC.getLeaderValue(Names[4]));
+  EXPECT_EQ(Names[0], EC.getLeaderValue(Names[0]));
+
+  std::vector<const char *> Members(EC.member_begin(EC.insert(Names[1])),
+                                    EC.member_end());
+  EXPECT_EQ((std::vector<const char *>{Names[1], Names[3], Names[5]}),
+            Members);
+}
+
+} // end anonymous namespace
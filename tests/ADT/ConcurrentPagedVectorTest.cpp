@@ -0,0 +1,157 @@
+//===- llvm/unittest/ADT/ConcurrentPagedVectorTest.cpp --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// ConcurrentPagedVector unit tests.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ConcurrentPagedVector.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/PerThreadBumpPtrAllocator.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+TEST(ConcurrentPagedVectorTest, EmptyTest) {
+  ConcurrentPagedVector<int, 10> V;
+  EXPECT_TRUE(V.empty());
+  EXPECT_EQ(V.size(), 0ULL);
+  EXPECT_EQ(V.materialized_begin().getIndex(), 0ULL);
+  EXPECT_EQ(V.materialized_end().getIndex(), 0ULL);
+  EXPECT_EQ(std::distance(V.materialized_begin(), V.materialized_end()), 0LL);
+
+#if GTEST_HAS_DEATH_TEST && !defined(NDEBUG)
+  EXPECT_DEATH(V[0], "Index < size()");
+#endif
+}
+
+TEST(ConcurrentPagedVectorTest, GrowAndAccess) {
+  ConcurrentPagedVector<int, 10> V;
+  V.grow_to_at_least(25);
+  EXPECT_EQ(V.size(), 25ULL);
+  V.grow_to_at_least(5);
+  EXPECT_EQ(V.size(), 25ULL);
+  EXPECT_EQ(V.grow_by(10), 25ULL);
+  EXPECT_EQ(V.size(), 35ULL);
+  EXPECT_EQ(std::distance(V.materialized_begin(), V.materialized_end()), 0LL);
+
+  // Touching one element materializes its whole page.
+  V[12] = 42;
+  EXPECT_FALSE(V.isMaterialized(9));
+  EXPECT_TRUE(V.isMaterialized(10));
+  EXPECT_TRUE(V.isMaterialized(19));
+  EXPECT_FALSE(V.isMaterialized(20));
+  EXPECT_EQ(V.materialized_begin().getIndex(), 10ULL);
+  EXPECT_EQ(std::distance(V.materialized_begin(), V.materialized_end()), 10LL);
+
+  V[34] = 7;
+  std::vector<int> Values(V.materialized_begin(), V.materialized_end());
+  std::vector<int> Expected(15, 0);
+  Expected[2] = 42;
+  Expected[14] = 7;
+  EXPECT_EQ(Values, Expected);
+
+  V.clear();
+  EXPECT_TRUE(V.empty());
+  EXPECT_FALSE(V.isMaterialized(12));
+  V.grow_to_at_least(20);
+  EXPECT_EQ(V[12], 0);
+}
+
+TEST(ConcurrentPagedVectorTest, FarIndices) {
+  // Pages far apart live in different segments of the page directory.
+  ConcurrentPagedVector<uint64_t, 4> V;
+  V.grow_to_at_least(size_t(1) << 24);
+  size_t Indices[] = {0, 3, 4, 1000, 12345678, (size_t(1) << 24) - 1};
+  for (size_t Idx : Indices)
+    V[Idx] = Idx;
+  for (size_t Idx : Indices)
+    EXPECT_EQ(V[Idx], Idx);
+  EXPECT_EQ(std::distance(V.materialized_begin(), V.materialized_end()),
+            5 * 4LL);
+}
+
+TEST(ConcurrentPagedVectorTest, ConcurrentAccess) {
+  // Every thread writes its own elements, which share pages with elements
+  // written by other threads.
+  const size_t N = 100000;
+  ConcurrentPagedVector<size_t, 64> V;
+  V.grow_to_at_least(4 * N);
+  parallelFor(0, N, [&](size_t I) { V[(I * 7919) % (4 * N)] = I + 1; });
+
+  size_t NumSet = 0;
+  for (size_t I = 0; I < N; ++I) {
+    ASSERT_EQ(V[(I * 7919) % (4 * N)], I + 1);
+    ++NumSet;
+  }
+  EXPECT_EQ(NumSet, N);
+}
+
+TEST(ConcurrentPagedVectorTest, RacingMaterialization) {
+  // All threads race to materialize the same pages; every increment must land
+  // in the page that won.
+  const unsigned NumThreads = 8, N = 4096, Rounds = 4;
+  ConcurrentPagedVector<std::atomic<unsigned>, 16> V;
+  V.grow_to_at_least(N);
+  std::atomic<bool> Start(false);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T < NumThreads; ++T)
+    Threads.emplace_back([&] {
+      while (!Start.load())
+        std::this_thread::yield();
+      for (unsigned R = 0; R < Rounds; ++R)
+        for (unsigned I = 0; I < N; ++I)
+          V[I].fetch_add(1, std::memory_order_relaxed);
+    });
+  Start = true;
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned I = 0; I < N; ++I)
+    ASSERT_EQ(V[I].load(), NumThreads * Rounds) << I;
+}
+
+TEST(ConcurrentPagedVectorTest, ConcurrentGrowBy) {
+  // Parallel loaders claim slots with grow_by() and fill them in.
+  const size_t N = 20000;
+  ConcurrentPagedVector<std::atomic<unsigned>, 32,
+                        parallel::PerThreadBumpPtrAllocator>
+      V;
+  parallelFor(0, N, [&](size_t I) {
+    size_t Idx = V.grow_by(1);
+    V[Idx].store(I + 1, std::memory_order_relaxed);
+  });
+  EXPECT_EQ(V.size(), N);
+
+  std::vector<bool> Seen(N + 1);
+  for (size_t Idx = 0; Idx < N; ++Idx) {
+    unsigned Val = V[Idx].load(std::memory_order_relaxed);
+    ASSERT_TRUE(Val >= 1 && Val <= N);
+    ASSERT_FALSE(Seen[Val]);
+    Seen[Val] = true;
+  }
+}
+
+TEST(ConcurrentPagedVectorTest, ExternalAllocator) {
+  ThreadSafeAllocator<BumpPtrAllocator> Allocator;
+  {
+    ConcurrentPagedVector<int, 16> V(Allocator);
+    V.grow_to_at_least(64);
+    V[3] = 1;
+    V[40] = 2;
+    EXPECT_EQ(std::distance(V.materialized_begin(), V.materialized_end()),
+              32LL);
+  }
+  size_t Bytes = Allocator.applyLocked(
+      [](BumpPtrAllocator &A) { return A.getBytesAllocated(); });
+  EXPECT_EQ(Bytes, 2 * 16 * sizeof(int));
+}
+} // namespace llvm
@@ -8,7 +8,9 @@
 
 #include "llvm/ADT/DAGDeltaAlgorithm.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/ThreadPool.h"
 #include "gtest/gtest.h"
+#include <atomic>
 #include <cstdarg>
 using namespace llvm;
 
@@ -18,7 +20,7 @@ using edge_ty = DAGDeltaAlgorithm::edge_ty;
 
 class FixedDAGDeltaAlgorithm : public DAGDeltaAlgorithm {
   changeset_ty FailingSet;
-  unsigned NumTests;
+  std::atomic<unsigned> NumTests;
 
 protected:
   bool ExecuteOneTest(const changeset_ty &Changes) override {
@@ -99,4 +101,29 @@ TEST(DAGDeltaAlgorithmTest, Basic) {
   EXPECT_GE(6U, FDA3.getNumTests());
 }
 
+TEST(DAGDeltaAlgorithmTest, Parallel) {
+  DefaultThreadPool Pool(hardware_concurrency(4));
+  std::vector<edge_ty> Deps;
+
+  // Dependencies:
+  //  1 - 3
+  Deps.push_back(std::make_pair(3, 1));
+  FixedDAGDeltaAlgorithm FDA(fixed_set(3, 3, 5, 7));
+  EXPECT_EQ(fixed_set(4, 1, 3, 5, 7), FDA.Run(range(20), Deps, Pool));
+
+  // Dependencies:
+  // 0 - 1
+  //  \- 2 - 3
+  //  \- 4
+  Deps.clear();
+  Deps.push_back(std::make_pair(1, 0));
+  Deps.push_back(std::make_pair(2, 0));
+  Deps.push_back(std::make_pair(4, 0));
+  Deps.push_back(std::make_pair(3, 2));
+  FixedDAGDeltaAlgorithm FDA2(fixed_set(2, 1, 3));
+  EXPECT_EQ(fixed_set(4, 0, 1, 2, 3), FDA2.Run(range(5), Deps, Pool));
+  FixedDAGDeltaAlgorithm FDA3(fixed_set(1, 4));
+  EXPECT_EQ(fixed_set(2, 0, 4), FDA3.Run(range(5), Deps, Pool));
+}
+
 }
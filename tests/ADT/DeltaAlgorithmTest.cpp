@@ -8,8 +8,11 @@
 
 #include "llvm/ADT/DeltaAlgorithm.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/ThreadPool.h"
 #include "gtest/gtest.h"
+#include <atomic>
 #include <cstdarg>
+#include <random>
 using namespace llvm;
 
 namespace std {
@@ -49,6 +52,24 @@ public:
   unsigned getNumTests() const { return NumTests; }
 };
 
+// As FixedDeltaAlgorithm, but safe to run on a thread pool.
+class ConcurrentFixedDeltaAlgorithm final : public DeltaAlgorithm {
+  changeset_ty FailingSet;
+  std::atomic<unsigned> NumTests{0};
+
+protected:
+  bool ExecuteOneTest(const changeset_ty &Changes) override {
+    ++NumTests;
+    return llvm::includes(Changes, FailingSet);
+  }
+
+public:
+  ConcurrentFixedDeltaAlgorithm(const changeset_ty &FailingSet)
+      : FailingSet(FailingSet) {}
+
+  unsigned getNumTests() const { return NumTests; }
+};
+
 std::set<unsigned> fixed_set(unsigned N, ...) {
   std::set<unsigned> S;
   va_list ap;
@@ -94,4 +115,28 @@ TEST(DeltaAlgorithmTest, Basic) {
   EXPECT_EQ(11U, FDA.getNumTests());
 }
 
+TEST(DeltaAlgorithmTest, Parallel) {
+  DefaultThreadPool Pool(hardware_concurrency(4));
+
+  ConcurrentFixedDeltaAlgorithm CFDA(fixed_set(3, 3, 5, 7));
+  EXPECT_EQ(fixed_set(3, 3, 5, 7), CFDA.Run(range(20), Pool));
+  EXPECT_EQ(range(10, 20), CFDA.Run(range(10, 20), Pool));
+
+  // Tests which can no longer affect the result may be skipped, but every
+  // test that the sequential search runs is also run in parallel, so the
+  // results must agree.
+  std::mt19937 Rng(0);
+  for (int I = 0; I < 50; ++I) {
+    std::set<unsigned> Fails;
+    for (unsigned N = Rng() % 6 + 1; Fails.size() < N;)
+      Fails.insert(Rng() % 64);
+    FixedDeltaAlgorithm FDA(Fails);
+    ConcurrentFixedDeltaAlgorithm CFDA(Fails);
+    std::set<unsigned> Expected = FDA.Run(range(64));
+    EXPECT_EQ(Fails, Expected);
+    EXPECT_EQ(Expected, CFDA.Run(range(64), Pool));
+    EXPECT_LE(FDA.getNumTests(), CFDA.getNumTests());
+  }
+}
+
 }
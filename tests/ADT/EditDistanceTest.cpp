@@ -6,10 +6,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/EditDistanceIndex.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/edit_distance.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <random>
 
 using namespace llvm;
 
@@ -61,3 +63,81 @@ TEST(EditDistance, VerifyShortCircuit) {
   EXPECT_EQ(R.EditDist, 2U);
   EXPECT_EQ(R.NumMaps, 0U);
 }
+
+/// Computes the edit distance with the row-by-row DP, by mapping the bytes to
+/// a type the bit-parallel implementation does not handle.
+static unsigned referenceEditDistance(StringRef A, StringRef B,
+                                      bool AllowReplacements,
+                                      unsigned MaxEditDistance) {
+  return llvm::ComputeMappedEditDistance(
+      ArrayRef(A.data(), A.size()), ArrayRef(B.data(), B.size()),
+      [](char C) { return static_cast<int>(C); }, AllowReplacements,
+      MaxEditDistance);
+}
+
+TEST(EditDistance, BitParallelMatchesDP) {
+  std::mt19937 Rng(0);
+  auto RandomString = [&](unsigned MaxLength, unsigned AlphabetSize) {
+    std::string S(Rng() % (MaxLength + 1), '\0');
+    for (char &C : S)
+      C = 'a' + Rng() % AlphabetSize;
+    return S;
+  };
+  // Cover single words, the boundary at 64 and several words per column.
+  for (unsigned MaxLength : {8u, 63u, 64u, 65u, 200u}) {
+    for (int Iter = 0; Iter != 200; ++Iter) {
+      unsigned AlphabetSize = 1 + Rng() % 6;
+      std::string A = RandomString(MaxLength, AlphabetSize);
+      std::string B = RandomString(MaxLength, AlphabetSize);
+      for (bool AllowReplacements : {true, false}) {
+        for (unsigned Max : {0u, 1u, 3u, 10u, 50u}) {
+          EXPECT_EQ(referenceEditDistance(A, B, AllowReplacements, Max),
+                    StringRef(A).edit_distance(B, AllowReplacements, Max))
+              << A << " " << B << " " << AllowReplacements << " " << Max;
+        }
+      }
+    }
+  }
+}
+
+TEST(EditDistance, Index) {
+  std::vector<std::string> Words;
+  std::mt19937 Rng(1);
+  for (int I = 0; I != 500; ++I) {
+    std::string S(1 + Rng() % 10, '\0');
+    for (char &C : S)
+      C = 'a' + Rng() % 4;
+    Words.push_back(S);
+  }
+  // Duplicates must all be found.
+  Words.push_back(Words[7]);
+  std::vector<StringRef> Dictionary(Words.begin(), Words.end());
+
+  for (bool AllowReplacements : {true, false}) {
+    EditDistanceIndex Tree(Dictionary, AllowReplacements);
+    EditDistanceIndex Linear(Dictionary, AllowReplacements,
+                             /*BuildTree=*/false);
+    for (int Iter = 0; Iter != 20; ++Iter) {
+      std::string Query(Rng() % 12, '\0');
+      for (char &C : Query)
+        C = 'a' + Rng() % 4;
+      for (unsigned K : {1u, 5u, 1000u}) {
+        for (unsigned Max : {0u, 2u}) {
+          std::vector<EditDistanceMatch> Expected;
+          for (unsigned I = 0, E = Dictionary.size(); I != E; ++I) {
+            unsigned D = Dictionary[I].edit_distance(Query, AllowReplacements);
+            if (!Max || D <= Max)
+              Expected.push_back({I, D});
+          }
+          llvm::sort(Expected);
+          if (Expected.size() > K)
+            Expected.resize(K);
+          auto FromTree = Tree.findClosest(Query, K, Max);
+          auto FromLinear = Linear.findClosest(Query, K, Max);
+          EXPECT_EQ(ArrayRef(Expected), ArrayRef(FromTree)) << Query;
+          EXPECT_EQ(ArrayRef(Expected), ArrayRef(FromLinear)) << Query;
+        }
+      }
+    }
+  }
+}
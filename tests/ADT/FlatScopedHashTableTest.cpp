@@ -0,0 +1,172 @@
+//===- FlatScopedHashTableTest.cpp - FlatScopedHashTable unit tests -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/FlatScopedHashTable.h"
+#include "llvm/ADT/ScopedHashTable.h"
+#include "llvm/ADT/StringRef.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <random>
+#include <stack>
+#include <type_traits>
+#include <vector>
+
+using ::llvm::FlatScopedHashTable;
+using ::llvm::FlatScopedHashTableScope;
+using ::llvm::ScopedHashTable;
+using ::llvm::ScopedHashTableScope;
+using ::llvm::StringLiteral;
+using ::llvm::StringRef;
+
+using ::testing::Test;
+
+template <typename IterT> static auto collect(IterT I, IterT E) {
+  std::vector<std::remove_reference_t<decltype(*I)>> Values;
+  for (; I != E; ++I)
+    Values.push_back(*I);
+  return Values;
+}
+
+class FlatScopedHashTableTest : public Test {
+protected:
+  FlatScopedHashTableTest() { symbolTable.insert(kGlobalName, kGlobalValue); }
+
+  FlatScopedHashTable<StringRef, StringRef> symbolTable{};
+  FlatScopedHashTableScope<StringRef, StringRef> globalScope{symbolTable};
+
+  static constexpr StringLiteral kGlobalName = "global";
+  static constexpr StringLiteral kGlobalValue = "gvalue";
+  static constexpr StringLiteral kLocalName = "local";
+  static constexpr StringLiteral kLocalValue = "lvalue";
+  static constexpr StringLiteral kLocalValue2 = "lvalue2";
+};
+
+TEST_F(FlatScopedHashTableTest, AccessWithNoActiveScope) {
+  EXPECT_EQ(symbolTable.count(kGlobalName), 1U);
+}
+
+TEST_F(FlatScopedHashTableTest, InsertInOutedScope) {
+  {
+    [[maybe_unused]] FlatScopedHashTableScope<StringRef, StringRef> varScope(
+        symbolTable);
+    symbolTable.insert(kLocalName, kLocalValue);
+    EXPECT_EQ(symbolTable.count(kLocalName), 1U);
+  }
+  EXPECT_EQ(symbolTable.count(kLocalName), 0U);
+  EXPECT_EQ(symbolTable.lookup(kLocalName), StringRef());
+}
+
+TEST_F(FlatScopedHashTableTest, OverrideInScope) {
+  [[maybe_unused]] FlatScopedHashTableScope<StringRef, StringRef> funScope(
+      symbolTable);
+  symbolTable.insert(kLocalName, kLocalValue);
+  {
+    [[maybe_unused]] FlatScopedHashTableScope<StringRef, StringRef> varScope(
+        symbolTable);
+    symbolTable.insert(kLocalName, kLocalValue2);
+    EXPECT_EQ(symbolTable.lookup(kLocalName), kLocalValue2);
+  }
+  EXPECT_EQ(symbolTable.lookup(kLocalName), kLocalValue);
+}
+
+TEST_F(FlatScopedHashTableTest, IterateShadowedValues) {
+  [[maybe_unused]] FlatScopedHashTableScope<StringRef, StringRef> funScope(
+      symbolTable);
+  symbolTable.insert(kGlobalName, kLocalValue);
+  symbolTable.insert(kLocalName, kLocalValue);
+  [[maybe_unused]] FlatScopedHashTableScope<StringRef, StringRef> varScope(
+      symbolTable);
+  symbolTable.insert(kGlobalName, kLocalValue2);
+
+  EXPECT_EQ(collect(symbolTable.begin(kGlobalName), symbolTable.end()),
+            (std::vector<StringRef>{kLocalValue2, kLocalValue, kGlobalValue}));
+  EXPECT_EQ(symbolTable.begin("missing"), symbolTable.end());
+}
+
+TEST_F(FlatScopedHashTableTest, GetCurScope) {
+  EXPECT_EQ(symbolTable.getCurScope(), &globalScope);
+  {
+    FlatScopedHashTableScope<StringRef, StringRef> funScope(symbolTable);
+    FlatScopedHashTableScope<StringRef, StringRef> funScope2(symbolTable);
+    EXPECT_EQ(symbolTable.getCurScope(), &funScope2);
+    EXPECT_EQ(funScope2.getParentScope(), &funScope);
+    {
+      FlatScopedHashTableScope<StringRef, StringRef> blockScope(symbolTable);
+      EXPECT_EQ(symbolTable.getCurScope(), &blockScope);
+    }
+    EXPECT_EQ(symbolTable.getCurScope(), &funScope2);
+  }
+  EXPECT_EQ(symbolTable.getCurScope(), &globalScope);
+}
+
+TEST_F(FlatScopedHashTableTest, PopScope) {
+  using SymbolTableScopeTy =
+      FlatScopedHashTable<StringRef, StringRef>::ScopeTy;
+
+  std::stack<StringRef> ExpectedValues;
+  std::stack<std::unique_ptr<SymbolTableScopeTy>> Scopes;
+
+  Scopes.emplace(std::make_unique<SymbolTableScopeTy>(symbolTable));
+  ExpectedValues.emplace(kLocalValue);
+  symbolTable.insert(kGlobalName, kLocalValue);
+
+  Scopes.emplace(std::make_unique<SymbolTableScopeTy>(symbolTable));
+  ExpectedValues.emplace(kLocalValue2);
+  symbolTable.insert(kGlobalName, kLocalValue2);
+
+  while (symbolTable.getCurScope() != &globalScope) {
+    EXPECT_EQ(symbolTable.getCurScope(), Scopes.top().get());
+    EXPECT_EQ(symbolTable.lookup(kGlobalName), ExpectedValues.top());
+    ExpectedValues.pop();
+    Scopes.pop();
+    EXPECT_NE(symbolTable.getCurScope(), nullptr);
+  }
+  ASSERT_TRUE(ExpectedValues.empty());
+  ASSERT_TRUE(Scopes.empty());
+  EXPECT_EQ(symbolTable.lookup(kGlobalName), kGlobalValue);
+}
+
+TEST(FlatScopedHashTableRandomTest, MatchesScopedHashTable) {
+  // Push and pop scopes and insert keys at random, some several times in one
+  // scope, and check every key against ScopedHashTable after each step.
+  const unsigned NumKeys = 64;
+  std::mt19937 Rng(0);
+  FlatScopedHashTable<unsigned, unsigned> Flat;
+  ScopedHashTable<unsigned, unsigned> Ref;
+  using FlatScopeTy = FlatScopedHashTable<unsigned, unsigned>::ScopeTy;
+  using RefScopeTy = ScopedHashTable<unsigned, unsigned>::ScopeTy;
+  std::vector<std::unique_ptr<FlatScopeTy>> FlatScopes;
+  std::vector<std::unique_ptr<RefScopeTy>> RefScopes;
+
+  for (unsigned Step = 0; Step != 4000; ++Step) {
+    unsigned Op = Rng() % 8;
+    if (FlatScopes.empty() || Op == 0) {
+      FlatScopes.push_back(std::make_unique<FlatScopeTy>(Flat));
+      RefScopes.push_back(std::make_unique<RefScopeTy>(Ref));
+    } else if (Op == 1) {
+      FlatScopes.pop_back();
+      RefScopes.pop_back();
+    } else {
+      unsigned Key = Rng() % NumKeys;
+      Flat.insert(Key, Step);
+      Ref.insert(Key, Step);
+    }
+
+    for (unsigned Key = 0; Key != NumKeys; ++Key) {
+      ASSERT_EQ(Ref.count(Key), Flat.count(Key));
+      ASSERT_EQ(Ref.lookup(Key), Flat.lookup(Key));
+      ASSERT_EQ(collect(Ref.begin(Key), Ref.end()),
+                collect(Flat.begin(Key), Flat.end()));
+    }
+  }
+
+  while (!FlatScopes.empty()) {
+    FlatScopes.pop_back();
+    RefScopes.pop_back();
+  }
+}
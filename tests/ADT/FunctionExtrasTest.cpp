@@ -343,4 +343,50 @@ TEST(UniqueFunctionTest, MovedFromStateIsDestroyedCorrectly) {
             CountCopyAndMove::Destructions);
 }
 
+// Check that a larger inline capacity keeps larger payloads inline, across
+// moves.
+TEST(UniqueFunctionTest, CustomInlineStorageSize) {
+  using BigFunction = unique_function<long(void *), 64>;
+  static_assert(sizeof(BigFunction) > sizeof(unique_function<long(void *)>),
+                "inline storage should have grown");
+  long Data[6] = {1, 2, 3, 4, 5, 6};
+  auto IsInline = [Data](void *Self) {
+    auto Mid = reinterpret_cast<uintptr_t>(&Data);
+    auto Beg = reinterpret_cast<uintptr_t>(Self);
+    auto End = Beg + sizeof(BigFunction);
+    EXPECT_TRUE(Mid >= Beg && Mid < End);
+    return Data[0] + Data[5];
+  };
+  BigFunction F = IsInline;
+  EXPECT_EQ(7, F(&F));
+  BigFunction G = std::move(F);
+  EXPECT_FALSE(F);
+  EXPECT_EQ(7, G(&G));
+
+  // Payloads larger than the inline storage still go out of line.
+  long More[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  BigFunction H = [More](void *) { return More[9]; };
+  EXPECT_EQ(10, H(&H));
+  G = std::move(H);
+  EXPECT_EQ(10, G(&G));
+
+  const unique_function<long() const, 48> C = [Data] { return Data[4]; };
+  EXPECT_EQ(5, C());
+}
+
+TEST(UniqueFunctionTest, CustomInlineStorageNonTrivial) {
+  CountCopyAndMove::ResetCounts();
+  {
+    auto Ptr = std::make_unique<int>(13);
+    unique_function<int(), 64> F = [Counter = CountCopyAndMove{},
+                                    Ptr = std::move(Ptr)] { return *Ptr; };
+    unique_function<int(), 64> G = std::move(F);
+    EXPECT_EQ(13, G());
+    F = std::move(G);
+    EXPECT_EQ(13, F());
+  }
+  EXPECT_EQ(CountCopyAndMove::TotalConstructions(),
+            CountCopyAndMove::Destructions);
+}
+
 } // anonymous namespace
@@ -0,0 +1,296 @@
+//===- unittests/ADT/IListNodePoolTest.cpp - ilist_node_pool unit tests ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ilist_node_pool.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/ilist.h"
+#include "llvm/ADT/ilist_node.h"
+#include "llvm/ADT/simple_ilist.h"
+#include "gtest/gtest.h"
+#include <memory>
+
+using namespace llvm;
+
+namespace {
+
+struct Node : ilist_node<Node> {
+  int Value;
+  std::shared_ptr<int> Counter;
+
+  Node(int Value, std::shared_ptr<int> Counter = nullptr)
+      : Value(Value), Counter(std::move(Counter)) {
+    if (this->Counter)
+      ++*this->Counter;
+  }
+  Node(Node &&RHS) : Value(RHS.Value), Counter(std::move(RHS.Counter)) {
+    RHS.Value = -1;
+  }
+  ~Node() {
+    if (Counter)
+      --*Counter;
+  }
+};
+
+using Pool = ilist_node_pool<Node>;
+
+} // end anonymous namespace
+
+namespace llvm {
+template <> struct ilist_alloc_traits<Node> : ilist_pool_alloc_traits<Node> {};
+} // end namespace llvm
+
+namespace {
+
+SmallVector<int> getValues(const ilist<Node> &List) {
+  SmallVector<int> Values;
+  for (const Node &N : List)
+    Values.push_back(N.Value);
+  return Values;
+}
+
+/// Return how many steps of a traversal of \p List move to the next slot of
+/// the same block.
+template <typename ListT> size_t countSequentialSteps(const ListT &List) {
+  size_t Sequential = 0;
+  const Node *Prev = nullptr;
+  for (const Node &N : List) {
+    if (Prev && reinterpret_cast<const char *>(&N) ==
+                    reinterpret_cast<const char *>(Prev) + sizeof(Node))
+      ++Sequential;
+    Prev = &N;
+  }
+  return Sequential;
+}
+
+TEST(IListNodePoolTest, Basic) {
+  Pool P;
+  EXPECT_EQ(0u, P.size());
+  EXPECT_EQ(0u, P.getNumBlocks());
+  EXPECT_GE(Pool::getNodesPerBlock(), 8u);
+
+  ilist<Node> List;
+  for (int I = 0; I < 10; ++I)
+    List.push_back(P.create(I));
+  EXPECT_EQ(10u, P.size());
+  EXPECT_EQ(1u, P.getNumBlocks());
+  EXPECT_EQ((SmallVector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), getValues(List));
+  // Nodes created in list order are laid out in list order.
+  EXPECT_EQ(9u, countSequentialSteps(List));
+
+  // Erasing returns the node to the pool, and the next node reuses its slot.
+  Node *Third = &*std::next(List.begin(), 2);
+  List.erase(Third);
+  EXPECT_EQ(9u, P.size());
+  Node *N = P.create(42);
+  EXPECT_EQ(Third, N);
+  List.push_back(N);
+
+  List.clear();
+  EXPECT_EQ(0u, P.size());
+  EXPECT_EQ(1u, P.getNumBlocks());
+}
+
+TEST(IListNodePoolTest, Destructors) {
+  auto Counter = std::make_shared<int>(0);
+  Pool P;
+  {
+    ilist<Node> List;
+    for (int I = 0; I < 100; ++I)
+      List.push_back(P.create(I, Counter));
+    EXPECT_EQ(100, *Counter);
+    List.erase(List.begin());
+    EXPECT_EQ(99, *Counter);
+    P.repack(List);
+    EXPECT_EQ(99, *Counter);
+  }
+  EXPECT_EQ(0, *Counter);
+  EXPECT_EQ(0u, P.size());
+}
+
+TEST(IListNodePoolTest, ManyBlocks) {
+  Pool P;
+  ilist<Node> List;
+  size_t NumNodes = 5 * Pool::getNodesPerBlock() + 1;
+  for (size_t I = 0; I != NumNodes; ++I)
+    List.push_back(P.create(I));
+  EXPECT_EQ(6u, P.getNumBlocks());
+  EXPECT_EQ(NumNodes - 6, countSequentialSteps(List));
+
+  // Emptying the blocks keeps them for later nodes.
+  List.clear();
+  EXPECT_EQ(6u, P.getNumBlocks());
+  for (size_t I = 0; I != NumNodes; ++I)
+    List.push_back(P.create(I));
+  EXPECT_EQ(6u, P.getNumBlocks());
+}
+
+TEST(IListNodePoolTest, CreateNear) {
+  Pool P;
+  ilist<Node> List;
+  // Leave every other slot of a block free.
+  for (int I = 0; I < 20; ++I)
+    List.push_back(P.create(I * 2));
+  for (auto I = List.begin(); I != List.end();) {
+    auto Next = std::next(I);
+    if (I->Value % 4 == 2)
+      List.erase(I);
+    I = Next;
+  }
+  EXPECT_EQ(10u, P.size());
+
+  // Fill each gap with a node created next to its predecessor.
+  SmallVector<Node *> Nodes(make_pointer_range(List));
+  for (Node *N : Nodes) {
+    Node *New = P.createNear(N, N->Value + 2);
+    EXPECT_EQ(N + 1, New);
+    List.insertAfter(N->getIterator(), New);
+  }
+  EXPECT_EQ(19u, countSequentialSteps(List));
+  SmallVector<int> Expected;
+  for (int I = 0; I < 20; ++I)
+    Expected.push_back(I * 2);
+  EXPECT_EQ(Expected, getValues(List));
+
+  // Without a free slot after the hint, the closest one before it is used.
+  while (P.size() != Pool::getNodesPerBlock())
+    List.push_back(P.create(0));
+  EXPECT_EQ(1u, P.getNumBlocks());
+  Node &Last = List.back();
+  Node &First = List.front();
+  List.erase(First);
+  Node *New = P.createNear(&Last, 100);
+  EXPECT_EQ(&First, New);
+  List.push_back(New);
+}
+
+TEST(IListNodePoolTest, CreateNearFullBlock) {
+  Pool P;
+  ilist<Node> List;
+  for (size_t I = 0; I != Pool::getNodesPerBlock(); ++I)
+    List.push_back(P.create(I));
+  EXPECT_EQ(1u, P.getNumBlocks());
+  List.push_back(P.createNear(&List.front(), -1));
+  EXPECT_EQ(2u, P.getNumBlocks());
+  EXPECT_EQ(-1, List.back().Value);
+
+  // A hint from another pool is ignored.
+  Pool Other;
+  Node *N = Other.createNear(&List.front(), -2);
+  EXPECT_EQ(1u, Other.size());
+  EXPECT_EQ(1u, Other.getNumBlocks());
+  List.push_back(N);
+}
+
+TEST(IListNodePoolTest, Repack) {
+  Pool P;
+  ilist<Node> List;
+  // Build a list whose nodes are scattered over the blocks by inserting in
+  // the middle.
+  size_t NumNodes = 4 * Pool::getNodesPerBlock();
+  SmallVector<int> Expected;
+  for (size_t I = 0; I != NumNodes; ++I) {
+    auto Pos = std::next(List.begin(), (I * 7919) % (List.size() + 1));
+    List.insert(Pos, P.create(I));
+  }
+  for (auto I = List.begin(); I != List.end();) {
+    auto Next = std::next(I);
+    if (I->Value % 3 == 0)
+      List.erase(I);
+    else
+      Expected.push_back(I->Value);
+    I = Next;
+  }
+  EXPECT_EQ(Expected.size(), P.size());
+  EXPECT_EQ(4u, P.getNumBlocks());
+  EXPECT_LT(countSequentialSteps(List), Expected.size() / 2);
+
+  P.repack(List);
+  EXPECT_EQ(Expected, getValues(List));
+  EXPECT_EQ(Expected.size(), P.size());
+  // The old blocks are freed, and the nodes now fill fresh blocks in list
+  // order.
+  size_t NumBlocks = divideCeil(Expected.size(), Pool::getNodesPerBlock());
+  EXPECT_EQ(NumBlocks, P.getNumBlocks());
+  EXPECT_EQ(Expected.size() - NumBlocks, countSequentialSteps(List));
+
+  // The free slots of the last block are used by later nodes.
+  List.push_back(P.create(-1));
+  EXPECT_EQ(NumBlocks, P.getNumBlocks());
+  EXPECT_EQ(Expected.size() - NumBlocks + 1, countSequentialSteps(List));
+}
+
+TEST(IListNodePoolTest, RepackKeepsOtherLists) {
+  Pool P;
+  ilist<Node> A, B;
+  for (int I = 0; I < 50; ++I) {
+    A.push_back(P.create(I));
+    B.push_back(P.create(100 + I));
+  }
+  Node *BFront = &B.front();
+  P.repack(A);
+  // The nodes of B did not move, so their blocks are kept.
+  EXPECT_EQ(BFront, &B.front());
+  EXPECT_EQ(100u, P.size());
+  for (int I = 0; I < 50; ++I) {
+    EXPECT_EQ(I, std::next(A.begin(), I)->Value);
+    EXPECT_EQ(100 + I, std::next(B.begin(), I)->Value);
+  }
+  EXPECT_EQ(49u, countSequentialSteps(A));
+}
+
+TEST(IListNodePoolTest, MixedPools) {
+  Pool P1;
+  ilist<Node> List;
+  {
+    auto P2 = std::make_unique<Pool>();
+    for (int I = 0; I < 10; ++I)
+      List.push_back(I % 2 ? P2->create(I) : P1.create(I));
+    EXPECT_EQ(5u, P1.size());
+    EXPECT_EQ(5u, P2->size());
+
+    // Splicing moves no node.
+    ilist<Node> Other;
+    Other.splice(Other.end(), List, std::next(List.begin(), 3), List.end());
+    Node *Fourth = &Other.front();
+    List.splice(List.end(), Other);
+    EXPECT_EQ(Fourth, &*std::next(List.begin(), 3));
+
+    // Erasing returns each node to its own pool.
+    List.erase(List.begin(), std::next(List.begin(), 4));
+    EXPECT_EQ(3u, P1.size());
+    EXPECT_EQ(3u, P2->size());
+
+    // Repacking moves every node into P1, so P2 can go away.
+    P1.repack(List);
+    EXPECT_EQ(6u, P1.size());
+    EXPECT_EQ(0u, P2->size());
+  }
+  EXPECT_EQ((SmallVector<int>{4, 5, 6, 7, 8, 9}), getValues(List));
+  List.clear();
+  EXPECT_EQ(0u, P1.size());
+}
+
+TEST(IListNodePoolTest, SimpleIList) {
+  Pool P;
+  simple_ilist<Node> List;
+  for (int I = 0; I < 30; ++I)
+    List.push_front(*P.create(I));
+  EXPECT_EQ(0u, countSequentialSteps(List));
+
+  P.repack(List);
+  EXPECT_EQ(29u, countSequentialSteps(List));
+  int Expected = 29;
+  for (Node &N : List)
+    EXPECT_EQ(Expected--, N.Value);
+  List.clearAndDispose(Pool::destroy);
+  EXPECT_EQ(0u, P.size());
+  EXPECT_EQ(1u, P.getNumBlocks());
+}
+
+} // end anonymous namespace
@@ -0,0 +1,245 @@
+//===- llvm/unittest/ADT/IndexedPriorityQueueTest.cpp ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// IndexedPriorityQueue unit tests.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/IndexedPriorityQueue.h"
+#include "llvm/ADT/PriorityQueue.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace llvm;
+
+template <typename T> class IndexedPriorityQueueTest : public ::testing::Test {
+};
+using TestTypes = ::testing::Types<
+    IndexedPriorityQueue<unsigned, int>,
+    IndexedPriorityQueue<unsigned, int, std::less<int>, 2>,
+    IndexedPriorityQueue<unsigned, int, std::less<int>, 4,
+                         DensePositionMap<unsigned>>>;
+TYPED_TEST_SUITE(IndexedPriorityQueueTest, TestTypes, );
+
+TYPED_TEST(IndexedPriorityQueueTest, Basic) {
+  TypeParam Q;
+  EXPECT_TRUE(Q.empty());
+  EXPECT_EQ(0u, Q.size());
+  EXPECT_FALSE(Q.contains(3));
+
+  Q.push(3, 30);
+  Q.push(1, 10);
+  Q.push(7, 70);
+  Q.push(5, 50);
+  EXPECT_EQ(4u, Q.size());
+  EXPECT_TRUE(Q.contains(1));
+  EXPECT_FALSE(Q.contains(2));
+  EXPECT_EQ(50, Q.getPriority(5));
+
+  EXPECT_EQ(7u, Q.top());
+  EXPECT_EQ(70, Q.topPriority());
+  EXPECT_EQ(7u, Q.pop_top());
+  EXPECT_FALSE(Q.contains(7));
+  EXPECT_EQ(5u, Q.pop_top());
+  EXPECT_EQ(3u, Q.pop_top());
+  EXPECT_EQ(1u, Q.pop_top());
+  EXPECT_TRUE(Q.empty());
+
+  Q.push(7, 1);
+  EXPECT_EQ(7u, Q.top());
+  Q.clear();
+  EXPECT_TRUE(Q.empty());
+  EXPECT_FALSE(Q.contains(7));
+}
+
+TYPED_TEST(IndexedPriorityQueueTest, Update) {
+  TypeParam Q;
+  for (unsigned I = 0; I < 20; ++I)
+    EXPECT_TRUE(Q.update(I, I * 10));
+  EXPECT_EQ(19u, Q.top());
+
+  // Raise a key to the top.
+  EXPECT_FALSE(Q.update(4, 1000));
+  EXPECT_EQ(4u, Q.top());
+  EXPECT_EQ(1000, Q.getPriority(4));
+
+  // Sink it back to the bottom.
+  EXPECT_FALSE(Q.update(4, -1));
+  EXPECT_EQ(19u, Q.top());
+  EXPECT_EQ(20u, Q.size());
+
+  std::vector<unsigned> Order;
+  while (!Q.empty())
+    Order.push_back(Q.pop_top());
+  std::vector<unsigned> Expected;
+  for (unsigned I = 20; I-- != 5;)
+    Expected.push_back(I);
+  Expected.insert(Expected.end(), {3, 2, 1, 0, 4});
+  EXPECT_EQ(Expected, Order);
+}
+
+TYPED_TEST(IndexedPriorityQueueTest, Erase) {
+  TypeParam Q;
+  for (unsigned I = 0; I < 50; ++I)
+    Q.push(I, (I * 37) % 50);
+  EXPECT_FALSE(Q.erase(100));
+  for (unsigned I = 0; I < 50; I += 2)
+    EXPECT_TRUE(Q.erase(I));
+  EXPECT_FALSE(Q.erase(0));
+  EXPECT_EQ(25u, Q.size());
+
+  int Prev = 1000;
+  while (!Q.empty()) {
+    int P = Q.topPriority();
+    unsigned Key = Q.pop_top();
+    EXPECT_EQ(1u, Key % 2);
+    EXPECT_LT(P, Prev);
+    Prev = P;
+  }
+}
+
+TYPED_TEST(IndexedPriorityQueueTest, BulkInsert) {
+  TypeParam Q;
+  std::vector<std::pair<unsigned, int>> Entries;
+  for (unsigned I = 0; I < 100; ++I)
+    Entries.push_back({I, int((I * 61) % 100)});
+  // Into an empty queue, which rebuilds the heap.
+  Q.insert(Entries);
+  EXPECT_EQ(100u, Q.size());
+  for (unsigned I = 0; I < 100; ++I)
+    EXPECT_EQ(int((I * 61) % 100), Q.getPriority(I));
+
+  // A short sequence into a larger queue, which sifts each key up.
+  Q.insert(std::vector<std::pair<unsigned, int>>{{200, 500}, {201, -5}});
+  EXPECT_EQ(200u, Q.top());
+  EXPECT_TRUE(Q.erase(200));
+
+  int Prev = 1000;
+  unsigned Count = 0;
+  while (!Q.empty()) {
+    EXPECT_LT(Q.topPriority(), Prev);
+    Prev = Q.topPriority();
+    Q.pop();
+    ++Count;
+  }
+  EXPECT_EQ(101u, Count);
+  EXPECT_EQ(-5, Prev);
+
+#if GTEST_HAS_DEATH_TEST && !defined(NDEBUG)
+  // A key repeated within the sequence, on both insertion paths.
+  EXPECT_DEATH(Q.insert(std::vector<std::pair<unsigned, int>>{{1, 1}, {1, 2}}),
+               "Key is repeated in the sequence!");
+  Q.insert(std::vector<std::pair<unsigned, int>>{{1, 1}, {2, 2}, {3, 3}});
+  EXPECT_DEATH(Q.insert(std::vector<std::pair<unsigned, int>>{{4, 1}, {4, 2}}),
+               "Key is repeated in the sequence!");
+  EXPECT_DEATH(Q.insert(std::vector<std::pair<unsigned, int>>{{2, 1}}),
+               "Key is already in the queue!");
+#endif
+}
+
+TYPED_TEST(IndexedPriorityQueueTest, Random) {
+  // Compare against a reference built from an ordered set of
+  // (priority, key) pairs.
+  std::mt19937 Rng(42);
+  TypeParam Q;
+  std::map<unsigned, int> Priorities;
+  std::set<std::pair<int, unsigned>> Ordered;
+  for (unsigned Step = 0; Step < 20000; ++Step) {
+    unsigned Key = Rng() % 300;
+    int P = Rng() % 1000;
+    switch (Rng() % 4) {
+    case 0:
+    case 1: {
+      auto It = Priorities.find(Key);
+      bool Inserted = It == Priorities.end();
+      if (!Inserted)
+        Ordered.erase({It->second, Key});
+      Priorities[Key] = P;
+      Ordered.insert({P, Key});
+      ASSERT_EQ(Inserted, Q.update(Key, P));
+      break;
+    }
+    case 2: {
+      auto It = Priorities.find(Key);
+      bool Present = It != Priorities.end();
+      if (Present) {
+        Ordered.erase({It->second, Key});
+        Priorities.erase(It);
+      }
+      ASSERT_EQ(Present, Q.erase(Key));
+      break;
+    }
+    case 3:
+      if (Ordered.empty())
+        break;
+      ASSERT_EQ(Ordered.rbegin()->first, Q.topPriority());
+      Key = Q.pop_top();
+      ASSERT_TRUE(Ordered.erase({Priorities[Key], Key}));
+      Priorities.erase(Key);
+      break;
+    }
+    ASSERT_EQ(Ordered.size(), Q.size());
+  }
+  for (auto [Key, P] : Priorities)
+    EXPECT_EQ(P, Q.getPriority(Key));
+}
+
+TEST(IndexedPriorityQueueTest, Dijkstra) {
+  // Shortest paths over a random graph, with decrease-key, agree with the
+  // lazy-deletion search over PriorityQueue.
+  const unsigned NumNodes = 500;
+  std::mt19937 Rng(7);
+  std::vector<std::vector<std::pair<unsigned, unsigned>>> Edges(NumNodes);
+  for (unsigned I = 0; I < NumNodes * 8; ++I)
+    Edges[Rng() % NumNodes].push_back({unsigned(Rng() % NumNodes),
+                                       unsigned(Rng() % 100 + 1)});
+
+  const unsigned Inf = ~0u;
+  std::vector<unsigned> Dist(NumNodes, Inf);
+  IndexedPriorityQueue<unsigned, unsigned, std::greater<unsigned>, 4,
+                       DensePositionMap<unsigned>>
+      Q;
+  Dist[0] = 0;
+  Q.push(0, 0);
+  while (!Q.empty()) {
+    unsigned N = Q.pop_top();
+    for (auto [To, W] : Edges[N])
+      if (Dist[N] + W < Dist[To]) {
+        Dist[To] = Dist[N] + W;
+        Q.update(To, Dist[To]);
+      }
+  }
+
+  std::vector<unsigned> RefDist(NumNodes, Inf);
+  PriorityQueue<std::pair<unsigned, unsigned>,
+                std::vector<std::pair<unsigned, unsigned>>,
+                std::greater<std::pair<unsigned, unsigned>>>
+      RefQ;
+  RefDist[0] = 0;
+  RefQ.push({0, 0});
+  while (!RefQ.empty()) {
+    auto [D, N] = RefQ.top();
+    RefQ.pop();
+    if (D != RefDist[N])
+      continue;
+    for (auto [To, W] : Edges[N])
+      if (D + W < RefDist[To]) {
+        RefDist[To] = D + W;
+        RefQ.push({RefDist[To], To});
+      }
+  }
+  EXPECT_EQ(RefDist, Dist);
+}
+
+} // end anonymous namespace
@@ -0,0 +1,396 @@
+//===- llvm/unittest/ADT/RoaringBitVectorTest.cpp - RoaringBitVector tests ===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/RoaringBitVector.h"
+#include "llvm/ADT/SparseBitVector.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+std::vector<unsigned> toVector(const RoaringBitVector &BV) {
+  return std::vector<unsigned>(BV.begin(), BV.end());
+}
+
+TEST(RoaringBitVectorTest, TrivialOperation) {
+  RoaringBitVector Vec;
+  EXPECT_EQ(0U, Vec.count());
+  EXPECT_FALSE(Vec.test(17));
+  Vec.set(5);
+  EXPECT_TRUE(Vec.test(5));
+  EXPECT_FALSE(Vec.test(17));
+  Vec.reset(6);
+  EXPECT_TRUE(Vec.test(5));
+  EXPECT_FALSE(Vec.test(6));
+  Vec.reset(5);
+  EXPECT_FALSE(Vec.test(5));
+  EXPECT_TRUE(Vec.empty());
+  EXPECT_TRUE(Vec.test_and_set(17));
+  EXPECT_FALSE(Vec.test_and_set(17));
+  EXPECT_TRUE(Vec.test(17));
+  Vec.clear();
+  EXPECT_FALSE(Vec.test(17));
+
+  Vec.set(5);
+  const RoaringBitVector ConstVec = Vec;
+  EXPECT_TRUE(ConstVec.test(5));
+  EXPECT_FALSE(ConstVec.test(17));
+
+  Vec.set(1337 << 16);
+  EXPECT_TRUE(Vec.test(1337 << 16));
+  EXPECT_FALSE(Vec.test(1337));
+  Vec = ConstVec;
+  EXPECT_FALSE(Vec.test(1337 << 16));
+
+  Vec.set(~0u);
+  EXPECT_TRUE(Vec.test(~0u));
+  RoaringBitVector MovedVec(std::move(Vec));
+  EXPECT_TRUE(MovedVec.test(5));
+  EXPECT_TRUE(MovedVec.test(~0u));
+  EXPECT_EQ(2U, MovedVec.count());
+}
+
+TEST(RoaringBitVectorTest, ContainerKinds) {
+  RoaringBitVector Vec;
+  for (unsigned I = 0; I != RoaringBitVector::MaxArraySize; ++I)
+    Vec.set(I * 2);
+  EXPECT_EQ(1U, Vec.getNumContainers(RoaringBitVector::ArrayContainer));
+
+  // One more member turns the array into a bitmap, and one fewer turns it
+  // back.
+  Vec.set(1);
+  EXPECT_EQ(1U, Vec.getNumContainers(RoaringBitVector::BitmapContainer));
+  EXPECT_EQ(RoaringBitVector::MaxArraySize + 1, Vec.count());
+  Vec.reset(1);
+  EXPECT_EQ(1U, Vec.getNumContainers(RoaringBitVector::ArrayContainer));
+  EXPECT_EQ(RoaringBitVector::MaxArraySize, Vec.count());
+
+  // A range becomes runs, and setting and resetting inside it keeps them.
+  RoaringBitVector Runs;
+  Runs.set(100, 3 * RoaringBitVector::BlockSize + 7);
+  EXPECT_EQ(4U, Runs.getNumContainers(RoaringBitVector::RunContainer));
+  EXPECT_EQ(3 * RoaringBitVector::BlockSize - 93, Runs.count());
+  Runs.reset(1000);
+  Runs.set(1000);
+  Runs.reset(RoaringBitVector::BlockSize);
+  EXPECT_EQ(4U, Runs.getNumContainers(RoaringBitVector::RunContainer));
+  EXPECT_FALSE(Runs.test(99));
+  EXPECT_TRUE(Runs.test(100));
+  EXPECT_TRUE(Runs.test(1000));
+  EXPECT_FALSE(Runs.test(RoaringBitVector::BlockSize));
+  EXPECT_TRUE(Runs.test(3 * RoaringBitVector::BlockSize + 6));
+  EXPECT_FALSE(Runs.test(3 * RoaringBitVector::BlockSize + 7));
+  EXPECT_TRUE(Runs.test(RoaringBitVector::BlockSize - 1));
+  EXPECT_EQ(3 * RoaringBitVector::BlockSize - 94, Runs.count());
+  EXPECT_EQ(Runs.count(), toVector(Runs).size());
+  EXPECT_EQ(100, Runs.find_first());
+  EXPECT_EQ(3 * RoaringBitVector::BlockSize + 6, Runs.find_last());
+
+  // runOptimize() picks the smallest container for each block.
+  RoaringBitVector Mixed;
+  Mixed.set(0, 10000);
+  for (unsigned I = 0; I < 30000; I += 3)
+    Mixed.set(RoaringBitVector::BlockSize + I);
+  Mixed.set(2 * RoaringBitVector::BlockSize + 5);
+  RoaringBitVector Before = Mixed;
+  Mixed.runOptimize();
+  EXPECT_EQ(1U, Mixed.getNumContainers(RoaringBitVector::RunContainer));
+  EXPECT_EQ(1U, Mixed.getNumContainers(RoaringBitVector::BitmapContainer));
+  EXPECT_EQ(1U, Mixed.getNumContainers(RoaringBitVector::ArrayContainer));
+  EXPECT_EQ(Before, Mixed);
+  EXPECT_EQ(toVector(Before), toVector(Mixed));
+
+  RoaringBitVector Dense;
+  for (unsigned I = 0; I != 20000; ++I)
+    Dense.set(I);
+  EXPECT_EQ(1U, Dense.getNumContainers(RoaringBitVector::BitmapContainer));
+  EXPECT_TRUE(Dense.runOptimize());
+  EXPECT_EQ(1U, Dense.getNumContainers(RoaringBitVector::RunContainer));
+  EXPECT_FALSE(Dense.runOptimize());
+  EXPECT_EQ(20000U, Dense.count());
+}
+
+TEST(RoaringBitVectorTest, RunIntersectionOverflow) {
+  // Two run containers of about 1820 runs each, where every run of one
+  // overlaps two runs of the other, intersect into almost twice as many runs,
+  // which a bitmap holds in less memory.
+  RoaringBitVector Vec, Other;
+  for (unsigned Start = 0; Start < RoaringBitVector::BlockSize; Start += 36) {
+    Vec.set(Start, std::min(Start + 21, RoaringBitVector::BlockSize));
+    Other.set(Start + 16, std::min(Start + 41, RoaringBitVector::BlockSize));
+  }
+  Vec.runOptimize();
+  Other.runOptimize();
+  ASSERT_EQ(1U, Vec.getNumContainers(RoaringBitVector::RunContainer));
+  ASSERT_EQ(1U, Other.getNumContainers(RoaringBitVector::RunContainer));
+
+  std::vector<unsigned> Expected;
+  for (unsigned Idx : Vec)
+    if (Other.test(Idx))
+      Expected.push_back(Idx);
+  EXPECT_TRUE(Vec &= Other);
+  EXPECT_EQ(1U, Vec.getNumContainers(RoaringBitVector::BitmapContainer));
+  EXPECT_EQ(Expected, toVector(Vec));
+}
+
+TEST(RoaringBitVectorTest, HighIndices) {
+  RoaringBitVector BV;
+  BV.set(0x80000000u);
+  BV.set(0xfffffff0u, 0xffffffffu);
+  BV.set(0xffffffffu);
+  EXPECT_EQ(INT64_C(0x80000000), BV.find_first());
+  EXPECT_EQ(INT64_C(0xffffffff), BV.find_last());
+  EXPECT_EQ(17U, BV.count());
+  EXPECT_EQ(0x80000000u, *BV.begin());
+
+  BV.reset(0x80000000u);
+  EXPECT_EQ(INT64_C(0xfffffff0), BV.find_first());
+  BV.clear();
+  EXPECT_EQ(-1, BV.find_first());
+  EXPECT_EQ(-1, BV.find_last());
+}
+
+TEST(RoaringBitVectorTest, SetOperations) {
+  RoaringBitVector Vec, Other;
+  Vec.set(1);
+  Other.set(1);
+  EXPECT_FALSE(Vec &= Other);
+  EXPECT_TRUE(Vec.test(1));
+  EXPECT_FALSE(Vec |= Other);
+  EXPECT_TRUE(Vec.contains(Other));
+  EXPECT_TRUE(Vec.intersects(Other));
+
+  Other.clear();
+  Other.set(1 << 20);
+  EXPECT_FALSE(Vec.intersects(Other));
+  EXPECT_TRUE(Vec |= Other);
+  EXPECT_TRUE(Vec.contains(Other));
+  EXPECT_FALSE(Other.contains(Vec));
+  EXPECT_TRUE(Vec.intersectWithComplement(Other));
+  EXPECT_EQ(std::vector<unsigned>{1}, toVector(Vec));
+  EXPECT_TRUE(Vec &= Other);
+  EXPECT_TRUE(Vec.empty());
+
+  // Self-operations.
+  Vec.set(5);
+  EXPECT_FALSE(Vec |= Vec);
+  EXPECT_FALSE(Vec &= Vec);
+  EXPECT_TRUE(Vec.intersectWithComplement(Vec));
+  EXPECT_TRUE(Vec.empty());
+
+  RoaringBitVector A, B;
+  A.set(0, 100);
+  B.set(50, 150);
+  EXPECT_EQ(150U, (A | B).count());
+  EXPECT_EQ(50U, (A & B).count());
+  EXPECT_EQ(50U, (A - B).count());
+  EXPECT_EQ(0, (B - A).find_first() - 100);
+  A.intersectWithComplement(A, B);
+  EXPECT_EQ(49, A.find_last());
+  B.intersectWithComplement(A, B);
+  EXPECT_EQ(A, B);
+
+  std::string Str;
+  raw_string_ostream OS(Str);
+  RoaringBitVector Small;
+  Small.set(3);
+  Small.set(70000);
+  dump(Small, OS);
+  EXPECT_EQ("[3 70000]\n", Str);
+}
+
+/// Build a set mixing scattered bits, dense regions and runs over the first
+/// few blocks, with some of its blocks stored as runs.
+RoaringBitVector makeRandom(std::mt19937 &Rng, SparseBitVector<> &Ref) {
+  RoaringBitVector BV;
+  unsigned NumBlocks = 4;
+  for (unsigned Block = 0; Block != NumBlocks; ++Block) {
+    unsigned Base = Block * RoaringBitVector::BlockSize;
+    switch (Rng() % 4) {
+    case 0: // Empty.
+      break;
+    case 1: // Sparse.
+      for (unsigned I = 0, E = Rng() % 200; I != E; ++I) {
+        unsigned Idx = Base + Rng() % RoaringBitVector::BlockSize;
+        BV.set(Idx);
+        Ref.set(Idx);
+      }
+      break;
+    case 2: // Dense.
+      for (unsigned I = 0; I != 6000; ++I) {
+        unsigned Idx = Base + Rng() % 12000;
+        BV.set(Idx);
+        Ref.set(Idx);
+      }
+      break;
+    case 3: // Runs.
+      for (unsigned I = 0, E = 1 + Rng() % 8; I != E; ++I) {
+        unsigned Start = Base + Rng() % RoaringBitVector::BlockSize;
+        unsigned End = std::min<unsigned>(Start + Rng() % 5000,
+                                          Base + RoaringBitVector::BlockSize);
+        BV.set(Start, End);
+        for (unsigned Idx = Start; Idx != End; ++Idx)
+          Ref.set(Idx);
+      }
+      break;
+    }
+  }
+  if (Rng() % 2)
+    BV.runOptimize();
+  return BV;
+}
+
+void expectSame(const SparseBitVector<> &Ref, const RoaringBitVector &BV) {
+  ASSERT_EQ(Ref.count(), BV.count());
+  ASSERT_EQ(Ref.find_first(), BV.find_first());
+  ASSERT_EQ(Ref.find_last(), BV.find_last());
+  std::vector<unsigned> RefBits;
+  for (unsigned Idx : Ref)
+    RefBits.push_back(Idx);
+  ASSERT_EQ(RefBits, toVector(BV));
+}
+
+TEST(RoaringBitVectorTest, MatchesSparseBitVector) {
+  std::mt19937 Rng(0);
+  for (unsigned Iter = 0; Iter != 60; ++Iter) {
+    SparseBitVector<> RefA, RefB;
+    RoaringBitVector A = makeRandom(Rng, RefA);
+    RoaringBitVector B = makeRandom(Rng, RefB);
+    expectSame(RefA, A);
+    expectSame(RefB, B);
+
+    EXPECT_EQ(RefA.intersects(RefB), A.intersects(B));
+    EXPECT_EQ(RefA.contains(RefB), A.contains(B));
+    EXPECT_EQ(RefA == RefB, A == B);
+
+    SparseBitVector<> RefUnion = RefA;
+    RoaringBitVector Union = A;
+    EXPECT_EQ(RefUnion |= RefB, Union |= B);
+    expectSame(RefUnion, Union);
+    EXPECT_TRUE(Union.contains(A));
+    EXPECT_TRUE(Union.contains(B));
+
+    SparseBitVector<> RefIntersection = RefA;
+    RoaringBitVector Intersection = A;
+    EXPECT_EQ(RefIntersection &= RefB, Intersection &= B);
+    expectSame(RefIntersection, Intersection);
+
+    SparseBitVector<> RefDifference = RefA;
+    RoaringBitVector Difference = A;
+    EXPECT_EQ(RefDifference.intersectWithComplement(RefB),
+              Difference.intersectWithComplement(B));
+    expectSame(RefDifference, Difference);
+    EXPECT_FALSE(Difference.intersects(B));
+
+    // Remove some members one by one.
+    for (unsigned I = 0; I != 500; ++I) {
+      unsigned Idx = Rng() % (4 * RoaringBitVector::BlockSize);
+      RefA.reset(Idx);
+      A.reset(Idx);
+    }
+    expectSame(RefA, A);
+  }
+}
+
+TEST(RoaringBitVectorTest, Serialization) {
+  std::mt19937 Rng(1);
+  for (unsigned Iter = 0; Iter != 20; ++Iter) {
+    SparseBitVector<> Ref;
+    RoaringBitVector BV = makeRandom(Rng, Ref);
+    SmallVector<char, 0> Buffer;
+    BV.serialize(Buffer);
+    ASSERT_EQ(BV.getSerializedSize(), Buffer.size());
+    StringRef Data(Buffer.data(), Buffer.size());
+
+    Expected<RoaringBitVectorView> View = RoaringBitVectorView::create(Data);
+    ASSERT_THAT_EXPECTED(View, Succeeded());
+    EXPECT_EQ(BV.count(), View->count());
+    EXPECT_EQ(BV.empty(), View->empty());
+    for (unsigned I = 0; I != 2000; ++I) {
+      unsigned Idx = Rng() % (5 * RoaringBitVector::BlockSize);
+      ASSERT_EQ(BV.test(Idx), View->test(Idx)) << Idx;
+    }
+    for (unsigned Idx : BV)
+      ASSERT_TRUE(View->test(Idx)) << Idx;
+
+    Expected<RoaringBitVector> Copy = RoaringBitVector::deserialize(Data);
+    ASSERT_THAT_EXPECTED(Copy, Succeeded());
+    EXPECT_EQ(BV, *Copy);
+    expectSame(Ref, *Copy);
+  }
+}
+
+TEST(RoaringBitVectorTest, MalformedBuffer) {
+  RoaringBitVector BV;
+  BV.set(3);
+  BV.set(7);
+  BV.set(1 << 16, 1 << 17);
+  SmallVector<char, 0> Buffer;
+  BV.serialize(Buffer);
+  StringRef Data(Buffer.data(), Buffer.size());
+
+  EXPECT_THAT_EXPECTED(RoaringBitVectorView::create(Data.drop_back()),
+                       Failed());
+  EXPECT_THAT_EXPECTED(RoaringBitVectorView::create(Data.take_front(4)),
+                       Failed());
+
+  // Swap the members of the array container.
+  SmallVector<char, 0> Unsorted = Buffer;
+  std::swap(Unsorted[40], Unsorted[42]);
+  StringRef UnsortedData(Unsorted.data(), Unsorted.size());
+  EXPECT_THAT_EXPECTED(RoaringBitVectorView::create(UnsortedData),
+                       Succeeded());
+  EXPECT_THAT_EXPECTED(RoaringBitVector::deserialize(UnsortedData), Failed());
+
+  // Claim a different cardinality for the run container.
+  SmallVector<char, 0> BadCount = Buffer;
+  BadCount[8 + 16 + 4] = 1;
+  StringRef BadCountData(BadCount.data(), BadCount.size());
+  EXPECT_THAT_EXPECTED(RoaringBitVector::deserialize(BadCountData), Failed());
+}
+
+TEST(RoaringBitVectorTest, DeserializeTooManyRuns) {
+  // Write a run container of every other bit by hand, with more runs than a
+  // container holds before it becomes an array or a bitmap.
+  const unsigned NumRuns = 3000;
+  SmallVector<char, 0> Buffer(8 + 16 + NumRuns * 4);
+  support::endian::write32le(&Buffer[0], 0x31564252); // "RBV1"
+  support::endian::write32le(&Buffer[4], 1);
+  Buffer[8 + 2] = RoaringBitVector::RunContainer;
+  support::endian::write32le(&Buffer[8 + 4], NumRuns);
+  support::endian::write32le(&Buffer[8 + 8], 8 + 16);
+  support::endian::write32le(&Buffer[8 + 12], NumRuns * 2);
+  RoaringBitVector Ref;
+  for (unsigned I = 0; I != NumRuns; ++I) {
+    support::endian::write16le(&Buffer[24 + I * 4], I * 2);
+    support::endian::write16le(&Buffer[24 + I * 4 + 2], I * 2);
+    Ref.set(I * 2);
+  }
+  StringRef Data(Buffer.data(), Buffer.size());
+  ASSERT_THAT_EXPECTED(RoaringBitVectorView::create(Data), Succeeded());
+
+  Expected<RoaringBitVector> BV = RoaringBitVector::deserialize(Data);
+  ASSERT_THAT_EXPECTED(BV, Succeeded());
+  EXPECT_EQ(0U, BV->getNumContainers(RoaringBitVector::RunContainer));
+  EXPECT_EQ(1U, BV->getNumContainers(RoaringBitVector::ArrayContainer));
+  EXPECT_EQ(Ref, *BV);
+  // Filling a gap joins two runs, which must not bring the run container
+  // back.
+  BV->set(1);
+  EXPECT_EQ(NumRuns + 1, BV->count());
+  EXPECT_EQ(0U, BV->getNumContainers(RoaringBitVector::RunContainer));
+}
+
+} // namespace
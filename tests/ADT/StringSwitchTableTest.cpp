@@ -0,0 +1,135 @@
+//===- llvm/unittest/ADT/StringSwitchTableTest.cpp ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/StringSwitchTable.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+enum class Color { Red, Orange, Yellow, Green, Blue, Indigo, Violet, Unknown };
+
+constexpr auto Colors = makeStringSwitchTable<Color>({
+    {"red", Color::Red},
+    {"orange", Color::Orange},
+    {"yellow", Color::Yellow},
+    {"green", Color::Green},
+    {"blue", Color::Blue},
+    {"indigo", Color::Indigo},
+    {"violet", Color::Violet},
+    {"purple", Color::Violet},
+    // Repeated strings resolve to the first case, as in StringSwitch.
+    {"red", Color::Unknown},
+});
+
+// The table is built, and can be queried, at compile time.
+static_assert(Colors.lookup("green") == Color::Green, "");
+static_assert(Colors.lookup_or("purple", Color::Unknown) == Color::Violet, "");
+static_assert(!Colors.lookup("grey"), "");
+static_assert(Colors.size() == 9, "");
+
+// A keyword set of 500 strings, "kw0" to "kw499".
+struct KeywordPool {
+  char Names[500][6] = {};
+};
+
+constexpr KeywordPool makeKeywordPool() {
+  KeywordPool Pool;
+  for (unsigned I = 0; I < 500; ++I) {
+    char *Name = Pool.Names[I];
+    Name[0] = 'k';
+    Name[1] = 'w';
+    unsigned Pos = 2;
+    if (I >= 100)
+      Name[Pos++] = '0' + I / 100;
+    if (I >= 10)
+      Name[Pos++] = '0' + I / 10 % 10;
+    Name[Pos] = '0' + I % 10;
+  }
+  return Pool;
+}
+
+constexpr KeywordPool Pool = makeKeywordPool();
+
+template <size_t... I>
+constexpr StringSwitchTable<unsigned, sizeof...(I)>
+makeKeywordTable(std::index_sequence<I...>) {
+  const std::pair<StringRef, unsigned> Cases[] = {
+      {StringRef(Pool.Names[I]), unsigned(I)}...};
+  return StringSwitchTable<unsigned, sizeof...(I)>(Cases);
+}
+
+constexpr auto Keywords = makeKeywordTable(std::make_index_sequence<500>());
+
+TEST(StringSwitchTableTest, Basic) {
+  EXPECT_EQ(Color::Red, Colors.lookup("red"));
+  EXPECT_EQ(Color::Orange, Colors.lookup("orange"));
+  EXPECT_EQ(Color::Indigo, Colors.lookup("indigo"));
+  EXPECT_EQ(Color::Violet, Colors.lookup("violet"));
+  EXPECT_EQ(Color::Violet, Colors.lookup("purple"));
+  EXPECT_EQ(std::nullopt, Colors.lookup(""));
+  EXPECT_EQ(std::nullopt, Colors.lookup("Red"));
+  EXPECT_EQ(std::nullopt, Colors.lookup("reds"));
+  EXPECT_EQ(Color::Unknown, Colors.lookup_or("re", Color::Unknown));
+  EXPECT_TRUE(Colors.contains("blue"));
+  EXPECT_FALSE(Colors.contains("blu"));
+
+  // Strings that do not come from literals.
+  std::string S = "yel";
+  S += "low";
+  EXPECT_EQ(Color::Yellow, Colors.lookup(S));
+}
+
+TEST(StringSwitchTableTest, SingleCase) {
+  static constexpr auto Table = makeStringSwitchTable<int>({{"x", 1}});
+  EXPECT_EQ(1, Table.lookup("x"));
+  EXPECT_EQ(std::nullopt, Table.lookup("y"));
+  EXPECT_EQ(std::nullopt, Table.lookup(""));
+}
+
+TEST(StringSwitchTableTest, EmptyString) {
+  static constexpr auto Table =
+      makeStringSwitchTable<int>({{"", 0}, {"a", 1}, {"aa", 2}});
+  EXPECT_EQ(0, Table.lookup(""));
+  EXPECT_EQ(1, Table.lookup("a"));
+  EXPECT_EQ(2, Table.lookup("aa"));
+  EXPECT_EQ(std::nullopt, Table.lookup("aaa"));
+}
+
+TEST(StringSwitchTableTest, ManyKeywords) {
+  for (unsigned I = 0; I < 500; ++I) {
+    std::string Name = "kw" + std::to_string(I);
+    EXPECT_EQ(I, Keywords.lookup(Name)) << Name;
+    EXPECT_FALSE(Keywords.contains(Name + "_")) << Name;
+    EXPECT_FALSE(Keywords.contains("Kw" + std::to_string(I))) << Name;
+  }
+  for (unsigned I = 500; I < 2000; ++I)
+    EXPECT_FALSE(Keywords.contains("kw" + std::to_string(I))) << I;
+}
+
+TEST(StringSwitchTableTest, MatchesStringSwitch) {
+  auto Translate = [](StringRef S) {
+    return StringSwitch<Color>(S)
+        .Case("red", Color::Red)
+        .Case("orange", Color::Orange)
+        .Case("yellow", Color::Yellow)
+        .Case("green", Color::Green)
+        .Case("blue", Color::Blue)
+        .Case("indigo", Color::Indigo)
+        .Cases({"violet", "purple"}, Color::Violet)
+        .Default(Color::Unknown);
+  };
+  for (StringRef S : {"red", "orange", "yellow", "green", "blue", "indigo",
+                      "violet", "purple", "", "r", "grey", "bluee"})
+    EXPECT_EQ(Translate(S), Colors.lookup_or(S, Color::Unknown)) << S;
+}
+
+} // end anonymous namespace
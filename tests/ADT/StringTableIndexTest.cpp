@@ -0,0 +1,109 @@
+//===- llvm/unittest/ADT/StringTableIndexTest.cpp -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/StringTableIndex.h"
+#include "gtest/gtest.h"
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+static constexpr char OpcodesRaw[] = "\0add\0sub\0mul\0div\0fadd\0";
+static constexpr StringTable Opcodes = OpcodesRaw;
+static constexpr StringTableIndex<Opcodes.getNumStrings()>
+    OpcodeIndex(Opcodes);
+
+// The index is built, and can be queried, at compile time.
+static_assert(OpcodeIndex.size() == 6, "");
+static_assert(OpcodeIndex.lookup("") == StringTable::Offset(0), "");
+static_assert(OpcodeIndex.lookup("add") == StringTable::Offset(1), "");
+static_assert(OpcodeIndex.lookup("fadd") == StringTable::Offset(17), "");
+static_assert(!OpcodeIndex.lookup("ad"), "");
+static_assert(!OpcodeIndex.contains("fsub"), "");
+
+// A table of 500 strings, "s0" to "s499", each followed by a null byte, and
+// followed by the null byte of the literal.
+struct NamePool {
+  char Data[1 + 10 * 3 + 90 * 4 + 400 * 5 + 1] = {};
+};
+
+constexpr NamePool makeNamePool() {
+  NamePool Pool;
+  size_t Pos = 1;
+  for (unsigned I = 0; I < 500; ++I) {
+    Pool.Data[Pos++] = 's';
+    if (I >= 100)
+      Pool.Data[Pos++] = '0' + I / 100;
+    if (I >= 10)
+      Pool.Data[Pos++] = '0' + I / 10 % 10;
+    Pool.Data[Pos++] = '0' + I % 10;
+    Pool.Data[Pos++] = '\0';
+  }
+  return Pool;
+}
+
+static constexpr NamePool Names = makeNamePool();
+static constexpr StringTable NameTable = Names.Data;
+static constexpr StringTableIndex<NameTable.getNumStrings()>
+    NameIndex(NameTable);
+
+TEST(StringTableIndexTest, Basic) {
+  EXPECT_EQ(StringTable::Offset(0), OpcodeIndex.lookup(""));
+  for (StringTable::Iterator I = Opcodes.begin(), E = Opcodes.end(); I != E;
+       ++I) {
+    std::optional<StringTable::Offset> O = OpcodeIndex.lookup(*I);
+    ASSERT_TRUE(O) << *I;
+    EXPECT_EQ(I.offset(), *O) << *I;
+    EXPECT_EQ(*I, Opcodes[*O]);
+  }
+
+  // Prefixes and extensions of the strings, and strings which span several
+  // strings of the table, are not found.
+  for (StringRef S : {"a", "ad", "addd", "dd", "fad", "ADD"})
+    EXPECT_FALSE(OpcodeIndex.contains(S)) << S;
+  EXPECT_FALSE(OpcodeIndex.contains(StringRef("sub\0mul", 7)));
+  EXPECT_FALSE(OpcodeIndex.contains(StringRef("fadd\0", 5)));
+  EXPECT_FALSE(OpcodeIndex.contains(StringRef("fadd\0\0", 6)));
+
+  // Strings which do not come from literals.
+  std::string S = "mu";
+  S += "l";
+  EXPECT_EQ(StringTable::Offset(9), OpcodeIndex.lookup(S));
+  EXPECT_EQ(Opcodes.size(), OpcodeIndex.getTable().size());
+}
+
+TEST(StringTableIndexTest, RepeatedStrings) {
+  // The first offset of a repeated string is returned.
+  static constexpr char Raw[] = "\0x\0y\0x\0\0y\0";
+  static constexpr StringTable Table = Raw;
+  static constexpr StringTableIndex<Table.getNumStrings()> Index(Table);
+  EXPECT_EQ(6u, Index.size());
+  EXPECT_EQ(StringTable::Offset(0), Index.lookup(""));
+  EXPECT_EQ(StringTable::Offset(1), Index.lookup("x"));
+  EXPECT_EQ(StringTable::Offset(3), Index.lookup("y"));
+}
+
+TEST(StringTableIndexTest, ManyStrings) {
+  EXPECT_EQ(501u, NameIndex.size());
+  for (StringTable::Iterator I = NameTable.begin(), E = NameTable.end();
+       I != E; ++I)
+    EXPECT_EQ(I.offset(), NameIndex.lookup(*I)) << *I;
+  for (unsigned I = 0; I < 500; ++I) {
+    std::string Name = "s" + std::to_string(I);
+    std::optional<StringTable::Offset> O = NameIndex.lookup(Name);
+    ASSERT_TRUE(O) << Name;
+    EXPECT_EQ(Name, NameTable[*O]);
+    EXPECT_FALSE(NameIndex.contains(Name + "_")) << Name;
+    EXPECT_FALSE(NameIndex.contains(Name.substr(1))) << Name;
+  }
+  for (unsigned I = 500; I < 2000; ++I)
+    EXPECT_FALSE(NameIndex.contains("s" + std::to_string(I))) << I;
+}
+
+} // end anonymous namespace
@@ -27,6 +27,7 @@ TEST(StringTableTest, Basic) {
   static_assert(T[0].empty());
   static_assert(T[StringTable::Offset()].empty());
   static_assert(T[1].size() == 4);
+  static_assert(T.getNumStrings() == 2);
 
   // And use normal Google Test runtime assertions to check the contents and
   // give more complete error messages.
@@ -38,4 +39,17 @@ TEST(StringTableTest, Basic) {
   EXPECT_THAT(T[1].data(), StrEq("test"));
 }
 
+TEST(StringTableTest, NumStrings) {
+  static constexpr char InputTable[] = "\0a\0\0bc\0";
+  constexpr StringTable T = InputTable;
+  static_assert(T.getNumStrings() == 4);
+
+  size_t NumStrings = 0;
+  for (StringRef S : T) {
+    (void)S;
+    ++NumStrings;
+  }
+  EXPECT_EQ(T.getNumStrings(), NumStrings);
+}
+
 } // anonymous namespace
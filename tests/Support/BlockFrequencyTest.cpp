@@ -7,11 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/BlockFrequency.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/BranchProbability.h"
 #include "llvm/Support/DataTypes.h"
 #include "gtest/gtest.h"
 #include <climits>
 #include <cstdint>
+#include <random>
 
 using namespace llvm;
 
@@ -117,6 +119,24 @@ TEST(BlockFrequencyTest, Saturate) {
   EXPECT_EQ(33527736066704712ULL, Freq.getFrequency());
 }
 
+TEST(BlockFrequencyTest, ScaleByProbabilities) {
+  std::mt19937_64 Rng(0);
+  SmallVector<BranchProbability, 16> Probs;
+  SmallVector<BlockFrequency, 16> Freqs;
+  for (int I = 0; I < 2000; ++I) {
+    BlockFrequency Freq(Rng() >> (Rng() % 64));
+    Probs.assign({BranchProbability::getZero(), BranchProbability::getOne(),
+                  BranchProbability::getUnknown()});
+    while (Probs.size() < 16)
+      Probs.push_back(BranchProbability::getRaw(
+          Rng() % (BranchProbability::getDenominator() + 1)));
+    Freqs.resize(Probs.size());
+    Freq.scaleByProbabilities(Probs, Freqs);
+    for (size_t J = 0; J < Probs.size(); ++J)
+      EXPECT_EQ((Freq * Probs[J]).getFrequency(), Freqs[J].getFrequency());
+  }
+}
+
 TEST(BlockFrequencyTest, SaturatingRightShift) {
   BlockFrequency Freq(0x10080ULL);
   Freq >>= 2;
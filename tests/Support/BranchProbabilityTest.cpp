@@ -9,6 +9,7 @@
 #include "llvm/Support/BranchProbability.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
+#include <random>
 
 using namespace llvm;
 
@@ -334,6 +335,32 @@ TEST(BranchProbabilityTest, scaleBruteForce) {
   }
 }
 
+TEST(BranchProbabilityTest, getBranchProbabilities) {
+  std::mt19937_64 Rng(0);
+  SmallVector<uint64_t, 64> Numerators;
+  SmallVector<BranchProbability, 64> Probs;
+  for (int I = 0; I < 2000; ++I) {
+    // Cover small denominators, ones that need scaling down, and powers of
+    // two including the internal denominator itself.
+    uint64_t Denominator = std::max<uint64_t>(Rng() >> (Rng() % 64), 1);
+    if (I % 10 == 0)
+      Denominator = UINT64_C(1) << (Rng() % 64);
+    Numerators.clear();
+    Numerators.push_back(0);
+    Numerators.push_back(Denominator);
+    Numerators.push_back(Denominator / 2);
+    while (Numerators.size() < 64)
+      Numerators.push_back(Rng() % Denominator);
+    Probs.resize(Numerators.size());
+    BranchProbability::getBranchProbabilities(Numerators, Denominator, Probs);
+    for (size_t J = 0; J < Numerators.size(); ++J)
+      EXPECT_EQ(BranchProbability::getBranchProbability(Numerators[J],
+                                                        Denominator),
+                Probs[J])
+          << Numerators[J] << " / " << Denominator;
+  }
+}
+
 TEST(BranchProbabilityTest, NormalizeProbabilities) {
   const auto UnknownProb = BranchProbability::getUnknown();
   {
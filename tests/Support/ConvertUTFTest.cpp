@@ -9,6 +9,7 @@
 #include "llvm/Support/ConvertUTF.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -73,6 +74,94 @@ TEST(ConvertUTFTest, ConvertUTF8ToUTF16String) {
     EXPECT_EQ(Expected[I], Result[I]);
 }
 
+TEST(ConvertUTFTest, LongRunsAndTightTargets) {
+  // Runs of ASCII long enough to take the word-at-a-time paths, mixed with
+  // two, three and four byte sequences, converted into every target size.
+  std::vector<UTF32> CodePoints;
+  for (UTF32 Other : {0xE9u, 0x416u, 0x4E2Du, 0x1F600u, 0xFFFDu}) {
+    for (unsigned I = 0; I != 19; ++I)
+      CodePoints.push_back('a' + I);
+    for (unsigned I = 0; I != 5; ++I)
+      CodePoints.push_back(Other);
+  }
+
+  std::vector<UTF8> UTF8Text(CodePoints.size() * 4);
+  std::vector<UTF16> UTF16Text(CodePoints.size() * 2);
+  {
+    const UTF32 *Src = CodePoints.data();
+    UTF8 *Dst = UTF8Text.data();
+    ASSERT_EQ(conversionOK,
+              ConvertUTF32toUTF8(&Src, Src + CodePoints.size(), &Dst,
+                                 Dst + UTF8Text.size(), strictConversion));
+    UTF8Text.resize(Dst - UTF8Text.data());
+    const UTF32 *Src16 = CodePoints.data();
+    UTF16 *Dst16 = UTF16Text.data();
+    ASSERT_EQ(conversionOK,
+              ConvertUTF32toUTF16(&Src16, Src16 + CodePoints.size(), &Dst16,
+                                  Dst16 + UTF16Text.size(), strictConversion));
+    UTF16Text.resize(Dst16 - UTF16Text.data());
+  }
+
+  for (size_t Size = 0; Size <= UTF16Text.size(); ++Size) {
+    std::vector<UTF16> Out(Size);
+    const UTF8 *Src = UTF8Text.data();
+    UTF16 *Dst = Out.data();
+    ConversionResult Result =
+        ConvertUTF8toUTF16(&Src, Src + UTF8Text.size(), &Dst, Dst + Size,
+                           strictConversion);
+    EXPECT_EQ(Size == UTF16Text.size() ? conversionOK : targetExhausted,
+              Result);
+    size_t Produced = Dst - Out.data();
+    EXPECT_TRUE(std::equal(Out.begin(), Out.begin() + Produced,
+                           UTF16Text.begin()));
+    // At most one surrogate pair's worth of space is left unused.
+    EXPECT_LE(Size - Produced, Result == conversionOK ? 0u : 1u);
+  }
+
+  for (size_t Size = 0; Size <= CodePoints.size(); ++Size) {
+    std::vector<UTF32> Out(Size);
+    const UTF8 *Src = UTF8Text.data();
+    UTF32 *Dst = Out.data();
+    ConversionResult Result =
+        ConvertUTF8toUTF32(&Src, Src + UTF8Text.size(), &Dst, Dst + Size,
+                           strictConversion);
+    EXPECT_EQ(Size == CodePoints.size() ? conversionOK : targetExhausted,
+              Result);
+    EXPECT_EQ(Out.data() + Size, Dst);
+    EXPECT_TRUE(std::equal(Out.begin(), Out.end(), CodePoints.begin()));
+  }
+
+  for (size_t Size = 0; Size <= UTF8Text.size(); ++Size) {
+    std::vector<UTF8> Out(Size);
+    const UTF16 *Src = UTF16Text.data();
+    UTF8 *Dst = Out.data();
+    ConversionResult Result =
+        ConvertUTF16toUTF8(&Src, Src + UTF16Text.size(), &Dst, Dst + Size,
+                           strictConversion);
+    EXPECT_EQ(Size == UTF8Text.size() ? conversionOK : targetExhausted,
+              Result);
+    size_t Produced = Dst - Out.data();
+    EXPECT_TRUE(std::equal(Out.begin(), Out.begin() + Produced,
+                           UTF8Text.begin()));
+    EXPECT_LE(Size - Produced, Result == conversionOK ? 0u : 3u);
+    // The source stops at the first character that did not fit.
+    EXPECT_EQ(Produced == UTF8Text.size(),
+              Src == UTF16Text.data() + UTF16Text.size());
+  }
+
+  // An ill-formed sequence after a long ASCII run stops the conversion there.
+  std::string Bad(37, 'x');
+  Bad += "\xe0\x80\x80yyyy";
+  std::vector<UTF16> Out(Bad.size());
+  const UTF8 *Src = reinterpret_cast<const UTF8 *>(Bad.data());
+  UTF16 *Dst = Out.data();
+  EXPECT_EQ(sourceIllegal,
+            ConvertUTF8toUTF16(&Src, Src + Bad.size(), &Dst,
+                               Dst + Out.size(), strictConversion));
+  EXPECT_EQ(reinterpret_cast<const UTF8 *>(Bad.data()) + 37, Src);
+  EXPECT_EQ(Out.data() + 37, Dst);
+}
+
 TEST(ConvertUTFTest, OddLengthInput) {
   std::string Result;
   bool Success = convertUTF16ToUTF8String(ArrayRef("xxxxx", 5), Result);
@@ -0,0 +1,129 @@
+//===- llvm/unittest/Support/CrashRecoveryContextTest.cpp -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/CrashRecoveryContext.h"
+#include "llvm/Config/llvm-config.h"
+#include "gtest/gtest.h"
+
+#ifdef LLVM_ON_UNIX
+#include <signal.h>
+#endif
+
+using namespace llvm;
+
+#ifdef LLVM_ON_UNIX
+
+namespace {
+
+void crash() { raise(SIGSEGV); }
+
+class CrashRecoveryContextTest : public testing::Test {
+protected:
+  void SetUp() override { CrashRecoveryContext::Enable(); }
+  void TearDown() override { CrashRecoveryContext::Disable(); }
+};
+
+TEST_F(CrashRecoveryContextTest, Basic) {
+  int Count = 0;
+  EXPECT_TRUE(CrashRecoveryContext().RunSafely([&] { ++Count; }));
+  EXPECT_EQ(1, Count);
+
+  CrashRecoveryContext CRC;
+  EXPECT_FALSE(CRC.RunSafely(crash));
+  EXPECT_EQ(128 + SIGSEGV, CRC.RetCode);
+  EXPECT_TRUE(CrashRecoveryContext::isCrash(CRC.RetCode));
+}
+
+TEST_F(CrashRecoveryContextTest, ReuseAfterCrash) {
+  // Every context below after the first is the one the previous context left
+  // behind, so each must start out as if it were new.
+  for (int Round = 0; Round != 3; ++Round) {
+    {
+      CrashRecoveryContext CRC;
+      EXPECT_FALSE(CRC.RunSafely(crash));
+      EXPECT_EQ(128 + SIGSEGV, CRC.RetCode);
+      EXPECT_EQ(nullptr, CrashRecoveryContext::GetCurrent());
+    }
+    {
+      CrashRecoveryContext CRC;
+      CrashRecoveryContext *Current = nullptr;
+      EXPECT_TRUE(
+          CRC.RunSafely([&] { Current = CrashRecoveryContext::GetCurrent(); }));
+      EXPECT_EQ(&CRC, Current);
+      EXPECT_EQ(0, CRC.RetCode);
+    }
+    EXPECT_EQ(nullptr, CrashRecoveryContext::GetCurrent());
+    {
+      CrashRecoveryContext CRC;
+      EXPECT_FALSE(CRC.RunSafely([] {
+        CrashRecoveryContext::GetCurrent()->HandleExit(42);
+      }));
+      EXPECT_EQ(42, CRC.RetCode);
+    }
+  }
+}
+
+TEST_F(CrashRecoveryContextTest, Nested) {
+  CrashRecoveryContext Outer;
+  CrashRecoveryContext *InInner = nullptr, *AfterInner = nullptr;
+  bool InnerResult = true;
+  EXPECT_FALSE(Outer.RunSafely([&] {
+    {
+      CrashRecoveryContext Inner;
+      EXPECT_TRUE(Inner.RunSafely(
+          [&] { InInner = CrashRecoveryContext::GetCurrent(); }));
+      EXPECT_EQ(&Inner, InInner);
+    }
+    {
+      CrashRecoveryContext Inner;
+      InnerResult = Inner.RunSafely(crash);
+    }
+    AfterInner = CrashRecoveryContext::GetCurrent();
+    // The outer context still recovers once the inner ones are gone.
+    crash();
+  }));
+  EXPECT_FALSE(InnerResult);
+  EXPECT_EQ(&Outer, AfterInner);
+  EXPECT_EQ(128 + SIGSEGV, Outer.RetCode);
+  EXPECT_EQ(nullptr, CrashRecoveryContext::GetCurrent());
+}
+
+TEST_F(CrashRecoveryContextTest, RunSafelyOnThread) {
+  for (int Round = 0; Round != 2; ++Round) {
+    {
+      // Take this thread's spare context, so that it keeps the one CRC
+      // releases below.
+      CrashRecoveryContext Holder;
+      EXPECT_TRUE(Holder.RunSafely([] {}));
+      CrashRecoveryContext CRC;
+      CrashRecoveryContext *Current = nullptr;
+      EXPECT_TRUE(CRC.RunSafelyOnThread(
+          [&] { Current = CrashRecoveryContext::GetCurrent(); }));
+      EXPECT_EQ(&CRC, Current);
+    }
+    {
+      CrashRecoveryContext CRC;
+      EXPECT_FALSE(CRC.RunSafelyOnThread(crash));
+      EXPECT_EQ(128 + SIGSEGV, CRC.RetCode);
+    }
+    // The contexts were created on the other threads but released on this
+    // one, which must not have become their current context.
+    EXPECT_EQ(nullptr, CrashRecoveryContext::GetCurrent());
+    {
+      CrashRecoveryContext CRC;
+      EXPECT_TRUE(CRC.RunSafely([] {}));
+    }
+    EXPECT_EQ(nullptr, CrashRecoveryContext::GetCurrent());
+    CrashRecoveryContext CRC;
+    EXPECT_FALSE(CRC.RunSafely(crash));
+  }
+}
+
+} // namespace
+
+#endif // LLVM_ON_UNIX
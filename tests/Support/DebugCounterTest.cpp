@@ -7,8 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/DebugCounter.h"
+#include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <string>
 using namespace llvm;
 
@@ -37,4 +39,47 @@ TEST(DebugCounterTest, Basic) {
   EXPECT_TRUE(StringRef(Str).contains("{200,1:3-5:78:79:89:100-102:150}"));
 }
 
+TEST(DebugCounterTest, ThreadSafe) {
+  DEBUG_COUNTER_THREADSAFE(TestCounter, "test-counter-threadsafe",
+                           "Thread-safe counter used for unit test");
+  auto DC = &DebugCounter::instance();
+  DC->push_back("test-counter-threadsafe=1:3-5:78:79:89:100-102:150");
+
+  // Sequential queries behave as for any other counter.
+  SmallVector<unsigned> Res;
+  for (unsigned Idx = 0; Idx < 200; Idx++) {
+    if (DebugCounter::shouldExecute(TestCounter))
+      Res.push_back(Idx);
+  }
+  SmallVector<unsigned> Expected = {1, 3, 4, 5, 78, 79, 89, 100, 101, 102, 150};
+  EXPECT_EQ(Expected, Res);
+
+  // Concurrent queries execute as many times in total.
+  std::atomic<unsigned> Executed = 0;
+  DebugCounter::setCounterState(TestCounter, {0, 0});
+  parallelFor(0, 2000, [&](size_t) {
+    if (DebugCounter::shouldExecute(TestCounter))
+      ++Executed;
+  });
+  EXPECT_EQ(Expected.size(), Executed);
+
+  // Indexed queries execute exactly the chosen indices.
+  std::atomic<bool> ExecutedIdx[200] = {};
+  parallelFor(0, 200, [&](size_t Idx) {
+    if (DebugCounter::shouldExecute(TestCounter, Idx))
+      ExecutedIdx[Idx] = true;
+  });
+  Res.clear();
+  for (unsigned Idx = 0; Idx < 200; Idx++) {
+    if (ExecutedIdx[Idx])
+      Res.push_back(Idx);
+  }
+  EXPECT_EQ(Expected, Res);
+
+  std::string Str;
+  llvm::raw_string_ostream OS(Str);
+  DC->print(OS);
+  EXPECT_TRUE(StringRef(Str).contains("{2200,1:3-5:78:79:89:100-102:150}"));
+}
+
 #endif
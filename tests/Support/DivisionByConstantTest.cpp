@@ -7,8 +7,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/DivisionByConstantInfo.h"
 #include "gtest/gtest.h"
+#include <random>
 
 using namespace llvm;
 
@@ -35,7 +38,7 @@ APInt SignedDivideUsingMagic(APInt Numerator, APInt Divisor,
   APInt ShiftMask(Bits, -1, true);
   if (Divisor.isOne() || Divisor.isAllOnes()) {
     // If d is +1/-1, we just multiply the numerator by +1/-1.
-    Factor = Divisor.getSExtValue();
+    Factor = Divisor;
     Magics.Magic = 0;
     Magics.ShiftAmount = 0;
     ShiftMask = 0;
@@ -44,7 +47,7 @@ APInt SignedDivideUsingMagic(APInt Numerator, APInt Divisor,
     Factor = 1;
   } else if (Divisor.isNegative() && Magics.Magic.isStrictlyPositive()) {
     // If d < 0 and m > 0, subtract the numerator.
-    Factor = -1;
+    Factor = APInt::getAllOnes(Bits);
   }
 
   // Multiply the numerator by the magic value.
@@ -186,4 +189,66 @@ TEST(UnsignedDivisionByConstantTest, Test) {
   }
 }
 
+// Widths above 10 bits are too slow to enumerate, so check random divisors and
+// numerators, on both sides of the 64-bit boundary.
+static APInt getRandomAPInt(std::mt19937_64 &Rng, unsigned Bits) {
+  SmallVector<uint64_t, 2> Words;
+  for (unsigned I = 0; I < (Bits + 63) / 64; ++I)
+    Words.push_back(Rng());
+  return APInt(Bits, Words).lshr(Rng() % Bits);
+}
+
+static const unsigned RandomTestWidths[] = {13, 16, 31, 32, 33,
+                                            63, 64, 65, 128};
+
+TEST(SignedDivisionByConstantTest, Random) {
+  std::mt19937_64 Rng(0);
+  for (unsigned Bits : RandomTestWidths) {
+    for (int I = 0; I < 200; ++I) {
+      APInt Divisor = getRandomAPInt(Rng, Bits);
+      if (Rng() % 2)
+        Divisor.negate();
+      if (Divisor.isZero() || Divisor.isOne() || Divisor.isAllOnes())
+        continue;
+      SignedDivisionByConstantInfo Magics =
+          SignedDivisionByConstantInfo::get(Divisor);
+      for (int J = 0; J < 50; ++J) {
+        APInt Numerator = getRandomAPInt(Rng, Bits);
+        if (Rng() % 2)
+          Numerator.negate();
+        ASSERT_EQ(SignedDivideUsingMagic(Numerator, Divisor, Magics),
+                  Numerator.sdiv(Divisor))
+            << " ... given the operation:  srem i" << Bits << " " << Numerator
+            << ", " << Divisor;
+      }
+    }
+  }
+}
+
+TEST(UnsignedDivisionByConstantTest, Random) {
+  std::mt19937_64 Rng(0);
+  for (unsigned Bits : RandomTestWidths) {
+    for (int I = 0; I < 200; ++I) {
+      APInt Divisor = getRandomAPInt(Rng, Bits);
+      if (Divisor.isZero() || Divisor.isOne())
+        continue;
+      UnsignedDivisionByConstantInfo Magics =
+          UnsignedDivisionByConstantInfo::get(Divisor);
+      for (int J = 0; J < 50; ++J) {
+        APInt Numerator = getRandomAPInt(Rng, Bits);
+        for (bool LZOptimization : {true, false}) {
+          for (bool AllowEvenDivisorOptimization : {true, false}) {
+            ASSERT_EQ(UnsignedDivideUsingMagic(
+                          Numerator, Divisor, LZOptimization,
+                          AllowEvenDivisorOptimization, false, Magics),
+                      Numerator.udiv(Divisor))
+                << " ... given the operation:  urem i" << Bits << " "
+                << Numerator << ", " << Divisor;
+          }
+        }
+      }
+    }
+  }
+}
+
 } // end anonymous namespace
@@ -12,10 +12,12 @@
 
 #include "llvm/Support/KnownBits.h"
 #include "KnownBitsTest.h"
+#include "llvm/Support/KnownBitsN.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "gtest/gtest.h"
+#include <functional>
 
 using namespace llvm;
 
@@ -920,4 +922,129 @@ TEST(KnownBitsTest, ReduceAddExhaustive) {
   }
 }
 
+template <unsigned Bits> static void testKnownBitsNMatchesKnownBits() {
+  using KB = KnownBitsN<Bits>;
+  ForeachKnownBits(Bits, [&](const KnownBits &Known1) {
+    if (Known1.hasConflict())
+      return;
+    KB N1(Known1);
+    EXPECT_EQ(Known1, N1.toKnownBits());
+    EXPECT_EQ(Known1.isConstant(), N1.isConstant());
+    EXPECT_EQ(Known1.isNegative(), N1.isNegative());
+    EXPECT_EQ(Known1.isNonNegative(), N1.isNonNegative());
+    EXPECT_EQ(Known1.getMaxValue().getZExtValue(), N1.getMaxValue());
+    EXPECT_EQ(Known1.countMinTrailingZeros(), N1.countMinTrailingZeros());
+    EXPECT_EQ(Known1.countMinLeadingZeros(), N1.countMinLeadingZeros());
+    EXPECT_EQ(Known1.countMaxTrailingZeros(), N1.countMaxTrailingZeros());
+    EXPECT_EQ(Known1.countMaxPopulation(), N1.countMaxPopulation());
+    ForeachKnownBits(Bits, [&](const KnownBits &Known2) {
+      if (Known2.hasConflict())
+        return;
+      KB N2(Known2);
+      auto Check = [&](StringRef Name, const KnownBits &Expected,
+                       const KB &Computed) {
+        EXPECT_EQ(Expected, Computed.toKnownBits())
+            << Name << ": Inputs = " << Known1 << ", " << Known2;
+      };
+      Check("and", Known1 & Known2, N1 & N2);
+      Check("or", Known1 | Known2, N1 | N2);
+      Check("xor", Known1 ^ Known2, N1 ^ N2);
+      Check("intersectWith", Known1.intersectWith(Known2),
+            N1.intersectWith(N2));
+      Check("unionWith", Known1.unionWith(Known2), N1.unionWith(N2));
+      Check("add", KnownBits::add(Known1, Known2), KB::add(N1, N2));
+      Check("sub", KnownBits::sub(Known1, Known2), KB::sub(N1, N2));
+      Check("mul", KnownBits::mul(Known1, Known2), KB::mul(N1, N2));
+      Check("shl", KnownBits::shl(Known1, Known2), KB::shl(N1, N2));
+      Check("lshr", KnownBits::lshr(Known1, Known2), KB::lshr(N1, N2));
+      Check("ashr", KnownBits::ashr(Known1, Known2), KB::ashr(N1, N2));
+      ForeachKnownBits(1, [&](const KnownBits &Carry) {
+        if (Carry.hasConflict())
+          return;
+        Check("addCarry", KnownBits::computeForAddCarry(Known1, Known2, Carry),
+              KB::computeForAddCarry(N1, N2, KnownBitsN<1>(Carry)));
+      });
+    });
+  });
+}
+
+TEST(KnownBitsTest, KnownBitsNExhaustive) {
+  testKnownBitsNMatchesKnownBits<1>();
+  testKnownBitsNMatchesKnownBits<3>();
+  testKnownBitsNMatchesKnownBits<4>();
+}
+
+TEST(KnownBitsTest, KnownBitsNVector) {
+  // Pseudo-random 64-bit values with a mix of known and unknown bits.
+  uint64_t State = 0x9E3779B97F4A7C15ULL;
+  auto Next = [&] {
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return State;
+  };
+  auto NextKnown = [&] {
+    uint64_t Value = Next(), KnownMask = Next() | Next();
+    return KnownBits64(~Value & KnownMask, Value & KnownMask);
+  };
+
+  KnownBitsNVector<64> LHS, RHS, Amounts, AmountRanges;
+  for (unsigned I = 0; I != 100; ++I) {
+    LHS.push_back(NextKnown());
+    RHS.push_back(NextKnown());
+    Amounts.push_back(KnownBits64::makeConstant(Next() % 64));
+    // Shift amounts with the low two bits unknown.
+    uint64_t Amount = Next() % 64;
+    AmountRanges.push_back(KnownBits64(~Amount & ~3ULL, Amount & ~3ULL));
+  }
+  ASSERT_EQ(100u, LHS.size());
+
+  auto CheckBinary = [&](StringRef Name, const KnownBitsNVector<64> &Other,
+                         auto Op, auto RefOp) {
+    KnownBitsNVector<64> Result;
+    Result.assign(LHS, Other, Op);
+    ASSERT_EQ(LHS.size(), Result.size());
+    for (size_t I = 0, E = LHS.size(); I != E; ++I) {
+      EXPECT_EQ(Op(LHS[I], Other[I]), Result[I]) << Name << " " << I;
+      EXPECT_EQ(RefOp(LHS[I].toKnownBits(), Other[I].toKnownBits()),
+                Result[I].toKnownBits())
+          << Name << " " << I;
+    }
+  };
+  CheckBinary("add", RHS, KnownBits64::add,
+              [](const KnownBits &L, const KnownBits &R) {
+                return KnownBits::add(L, R);
+              });
+  CheckBinary("sub", RHS, KnownBits64::sub,
+              [](const KnownBits &L, const KnownBits &R) {
+                return KnownBits::sub(L, R);
+              });
+  CheckBinary("mul", RHS, KnownBits64::mul,
+              [](const KnownBits &L, const KnownBits &R) {
+                return KnownBits::mul(L, R);
+              });
+  CheckBinary("and", RHS, std::bit_and<>(), std::bit_and<>());
+  CheckBinary("xor", RHS, std::bit_xor<>(), std::bit_xor<>());
+  CheckBinary("shl", Amounts, KnownBits64::shl,
+              [](const KnownBits &L, const KnownBits &R) {
+                return KnownBits::shl(L, R);
+              });
+  CheckBinary("lshr", AmountRanges, KnownBits64::lshr,
+              [](const KnownBits &L, const KnownBits &R) {
+                return KnownBits::lshr(L, R);
+              });
+  CheckBinary("ashr", Amounts, KnownBits64::ashr,
+              [](const KnownBits &L, const KnownBits &R) {
+                return KnownBits::ashr(L, R);
+              });
+
+  // In place, with a unary function.
+  KnownBitsNVector<64> Copy = LHS;
+  Copy.assign(Copy, [](const KnownBits64 &Known) {
+    return KnownBits64::add(Known, KnownBits64::makeConstant(1));
+  });
+  for (size_t I = 0, E = LHS.size(); I != E; ++I)
+    EXPECT_EQ(KnownBits64::add(LHS[I], KnownBits64::makeConstant(1)), Copy[I]);
+}
+
 } // end anonymous namespace
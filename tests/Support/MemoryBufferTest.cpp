@@ -15,8 +15,10 @@
 #include "llvm/Config/llvm-config.h" // for LLVM_ENABLE_THREADS, LLVM_ON_UNIX
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
@@ -24,6 +26,7 @@
 #include <thread>
 #endif
 #if LLVM_ON_UNIX
+#include <sys/resource.h>
 #include <unistd.h>
 #endif
 #if _WIN32
@@ -435,6 +438,127 @@ TEST_F(MemoryBufferTest, mmapVolatileNoNull) {
   EXPECT_TRUE(MB->getBuffer().starts_with("01234567"));
 }
 
+TEST_F(MemoryBufferTest, mmapAccessHints) {
+  // Create a file large enough to mmap, with a distinct tag on every page.
+  int FD;
+  SmallString<64> TestPath;
+  ASSERT_NO_ERROR(sys::fs::createTemporaryFile(
+      "MemoryBufferTest_mmapAccessHints", "temp", FD, TestPath));
+  FileRemover Cleanup(TestPath);
+  raw_fd_ostream OF(FD, true);
+  unsigned PageSize = sys::Process::getPageSizeEstimate();
+  const unsigned NumPages = 256;
+  for (unsigned I = 0; I != NumPages; ++I) {
+    OF << format("%08u", I);
+    OF.write_zeros(PageSize - 8);
+  }
+  OF.close();
+
+  // Count the page faults taken while touching every page of the buffer.
+  // Nothing in the loop may allocate, or heap growth would skew the count.
+  auto TouchPages = [&](const MemoryBuffer &MB) {
+    long Faults = 0;
+    unsigned Mismatches = 0;
+    char Tag[9];
+#if LLVM_ON_UNIX
+    struct rusage Before, After;
+    ::getrusage(RUSAGE_SELF, &Before);
+#endif
+    for (unsigned I = 0; I != NumPages; ++I) {
+      snprintf(Tag, sizeof(Tag), "%08u", I);
+      if (memcmp(Tag, MB.getBufferStart() + I * PageSize, 8) != 0)
+        ++Mismatches;
+    }
+#if LLVM_ON_UNIX
+    ::getrusage(RUSAGE_SELF, &After);
+    Faults = (After.ru_minflt - Before.ru_minflt) +
+             (After.ru_majflt - Before.ru_majflt);
+#endif
+    EXPECT_EQ(0u, Mismatches);
+    return Faults;
+  };
+
+  // Every hint must map the file and read back the right contents. The number
+  // of page faults taken depends on the page cache, transparent huge pages and
+  // readahead of the host, so it is only recorded as a measurement: a
+  // populated mapping of a cached file usually takes none.
+  using sys::fs::AccessHint;
+  static const std::pair<AccessHint, const char *> Hints[] = {
+      {AccessHint::Normal, "Normal"},
+      {AccessHint::Sequential, "Sequential"},
+      {AccessHint::Random, "Random"},
+      {AccessHint::WillNeed, "WillNeed"},
+      {AccessHint::Populate, "Populate"}};
+  for (auto [Hint, Name] : Hints) {
+    SCOPED_TRACE(Name);
+    auto MBOrError =
+        MemoryBuffer::getFile(TestPath, /*IsText=*/false,
+                              /*RequiresNullTerminator=*/false,
+                              /*IsVolatile=*/false, std::nullopt, Hint);
+    ASSERT_NO_ERROR(MBOrError.getError());
+    OwningBuffer MB = std::move(*MBOrError);
+    EXPECT_EQ(MemoryBuffer::MemoryBuffer_MMap, MB->getBufferKind());
+    EXPECT_EQ(NumPages * PageSize, MB->getBufferSize());
+    RecordProperty(std::string("PageFaults") + Name, int(TouchPages(*MB)));
+
+    auto SliceOrError = MemoryBuffer::getFileSlice(
+        TestPath, 4 * PageSize, PageSize, /*IsVolatile=*/false, std::nullopt,
+        Hint);
+    ASSERT_NO_ERROR(SliceOrError.getError());
+    EXPECT_EQ("00000001", (*SliceOrError)->getBuffer().substr(0, 8));
+  }
+}
+
+TEST_F(MemoryBufferTest, getFiles) {
+  // A mix of small files, one file large enough to be mapped, and one missing
+  // file.
+  unsigned PageSize = sys::Process::getPageSizeEstimate();
+  SmallVector<SmallString<64>, 8> Paths;
+  std::vector<std::unique_ptr<FileRemover>> Cleanup;
+  for (unsigned I = 0; I != 6; ++I) {
+    int FD;
+    SmallString<64> TestPath;
+    ASSERT_NO_ERROR(sys::fs::createTemporaryFile("MemoryBufferTest_getFiles",
+                                                 "temp", FD, TestPath));
+    Cleanup.push_back(std::make_unique<FileRemover>(TestPath));
+    raw_fd_ostream OF(FD, true);
+    OF << "file" << I;
+    if (I == 5)
+      for (unsigned J = 0; J < PageSize * 4 / 8; ++J)
+        OF << "01234567";
+    OF.close();
+    Paths.push_back(TestPath);
+  }
+  Paths.push_back(Paths.back());
+  Paths.back() += ".missing";
+
+  SmallVector<StringRef, 8> Names(Paths.begin(), Paths.end());
+  DefaultThreadPool Pool(hardware_concurrency(4));
+
+  // Every file is reported exactly once.
+  SmallVector<unsigned, 8> Seen(Names.size(), 0);
+  MemoryBuffer::getFiles(Names, Pool,
+                         [&](size_t Index, ErrorOr<OwningBuffer> MB) {
+                           ++Seen[Index];
+                           EXPECT_EQ(Index == 6, !MB);
+                         });
+  for (unsigned Count : Seen)
+    EXPECT_EQ(1u, Count);
+
+  auto Results = MemoryBuffer::getFiles(Names, Pool);
+  ASSERT_EQ(Names.size(), Results.size());
+  for (unsigned I = 0; I != 6; ++I) {
+    ASSERT_NO_ERROR(Results[I].getError());
+    OwningBuffer &MB = *Results[I];
+    EXPECT_TRUE(MB->getBuffer().starts_with(("file" + Twine(I)).str()));
+    EXPECT_EQ(Names[I], MB->getBufferIdentifier());
+    EXPECT_EQ('\0', *MB->getBufferEnd());
+  }
+  EXPECT_EQ(MemoryBuffer::MemoryBuffer_Malloc, Results[0].get()->getBufferKind());
+  EXPECT_EQ(MemoryBuffer::MemoryBuffer_MMap, Results[5].get()->getBufferKind());
+  EXPECT_EQ(std::errc::no_such_file_or_directory, Results[6].getError());
+}
+
 // Test that SmallVector without a null terminator gets one.
 TEST(SmallVectorMemoryBufferTest, WithoutNullTerminatorRequiresNullTerminator) {
   SmallString<0> Data("some data");
@@ -0,0 +1,168 @@
+//===- llvm/unittest/Support/PathCanonicalizerTest.cpp - unit tests -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/FileSystem/PathCanonicalizer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::sys;
+
+#define ASSERT_NO_ERROR(x)                                                     \
+  if (std::error_code ASSERT_NO_ERROR_ec = x) {                                \
+    SmallString<128> MessageStorage;                                           \
+    raw_svector_ostream Message(MessageStorage);                               \
+    Message << #x ": did not return errc::success.\n"                          \
+            << "error number: " << ASSERT_NO_ERROR_ec.value() << "\n"          \
+            << "error message: " << ASSERT_NO_ERROR_ec.message() << "\n";      \
+    GTEST_FATAL_FAILURE_(MessageStorage.c_str());                              \
+  } else {                                                                     \
+  }
+
+namespace {
+
+class PathCanonicalizerTest : public testing::Test {
+protected:
+  SmallString<128> TestDirectory;
+  std::vector<std::string> Paths;
+
+  void SetUp() override {
+    ASSERT_NO_ERROR(
+        fs::createUniqueDirectory("path-canonicalizer-test", TestDirectory));
+    // TestDirectory/
+    //   a/b/file
+    // and, where create_link makes symlinks,
+    //   link -> a
+    //   abs -> TestDirectory/a/b
+    //   a/filelink -> ../a/b/file
+    ASSERT_NO_ERROR(fs::create_directories(join("a/b")));
+    {
+      std::error_code EC;
+      raw_fd_ostream OS(join("a/b/file"), EC);
+      ASSERT_NO_ERROR(EC);
+      OS << "contents";
+    }
+#ifdef LLVM_ON_UNIX
+    ASSERT_NO_ERROR(fs::create_link("a", join("link")));
+    ASSERT_NO_ERROR(fs::create_link(join("a/b"), join("abs")));
+    ASSERT_NO_ERROR(fs::create_link("../a/b/file", join("a/filelink")));
+#endif
+
+    Paths = {
+        join("a"),
+        join("a/b/file"),
+        join("a/./b/../b/file"),
+        join("a/b/../../a"),
+        join("a/missing"),
+        join("a/b/file/not-a-directory"),
+        join("a/b/file/.."),
+        join("a/b/file/."),
+        join("a/b/file/../file"),
+#ifdef LLVM_ON_UNIX
+        join("link"),
+        join("link/b/file"),
+        join("link/b/../../a/b"),
+        join("abs/file"),
+        join("abs/../b/file"),
+        join("a/filelink"),
+        join("link/filelink"),
+        join("a/filelink/.."),
+#endif
+    };
+  }
+
+  void TearDown() override {
+    ASSERT_NO_ERROR(fs::remove_directories(TestDirectory));
+  }
+
+  /// Appends the '/' separated components of \p Relative to TestDirectory.
+  std::string join(StringRef Relative) {
+    SmallString<128> Path = TestDirectory;
+    SmallVector<StringRef, 8> Components;
+    Relative.split(Components, '/');
+    for (StringRef Component : Components)
+      path::append(Path, Component);
+    return std::string(Path);
+  }
+
+  void expectMatchesRealPath(StringRef Path, ErrorOr<StringRef> Result) {
+    SmallString<128> Expected;
+    std::error_code EC = fs::real_path(Path, Expected);
+    if (EC) {
+      EXPECT_FALSE(Result) << Path;
+      return;
+    }
+    ASSERT_TRUE(bool(Result)) << Path << ": " << Result.getError().message();
+    EXPECT_EQ(Expected, *Result) << Path;
+  }
+};
+
+TEST_F(PathCanonicalizerTest, MatchesRealPath) {
+  fs::PathCanonicalizer Canonicalizer;
+  // Run twice, so the second round is answered from the cache.
+  for (int Round = 0; Round != 2; ++Round)
+    for (const std::string &Path : Paths)
+      expectMatchesRealPath(Path, Canonicalizer.canonicalize(Path));
+  expectMatchesRealPath(".", Canonicalizer.canonicalize("."));
+  EXPECT_EQ(StringRef(), *Canonicalizer.canonicalize(""));
+}
+
+TEST_F(PathCanonicalizerTest, NotADirectory) {
+  fs::PathCanonicalizer Canonicalizer;
+  // Once from the file system, and once with the file in the cache.
+  for (int Round = 0; Round != 2; ++Round) {
+    ErrorOr<StringRef> Result = Canonicalizer.canonicalize(join("a/b/file/.."));
+    EXPECT_EQ(std::errc::not_a_directory, Result.getError());
+    EXPECT_TRUE(bool(Canonicalizer.canonicalize(join("a/b/file"))));
+  }
+#ifdef LLVM_ON_UNIX
+  // A symlink to a file is not a directory either.
+  EXPECT_EQ(std::errc::not_a_directory,
+            Canonicalizer.canonicalize(join("a/filelink/.")).getError());
+  // A symlink to a directory is.
+  EXPECT_TRUE(bool(Canonicalizer.canonicalize(join("link/.."))));
+#endif
+}
+
+TEST_F(PathCanonicalizerTest, Interned) {
+  fs::PathCanonicalizer Canonicalizer;
+  ErrorOr<StringRef> First = Canonicalizer.canonicalize(join("a/b/file"));
+  ErrorOr<StringRef> Second = Canonicalizer.canonicalize(join("a/b/./file"));
+  ASSERT_TRUE(First && Second);
+  EXPECT_EQ(First->data(), Second->data());
+#ifdef LLVM_ON_UNIX
+  ErrorOr<StringRef> ThroughLink =
+      Canonicalizer.canonicalize(join("link/b/file"));
+  ASSERT_TRUE(bool(ThroughLink));
+  EXPECT_EQ(First->data(), ThroughLink->data());
+#endif
+}
+
+TEST_F(PathCanonicalizerTest, Batch) {
+  SmallVector<StringRef, 0> Batch;
+  for (int Repeat = 0; Repeat != 16; ++Repeat)
+    Batch.append(Paths.begin(), Paths.end());
+
+  fs::PathCanonicalizer Sequential;
+  auto Results = Sequential.canonicalizeAll(Batch);
+  ASSERT_EQ(Batch.size(), Results.size());
+  for (size_t I = 0, E = Batch.size(); I != E; ++I)
+    expectMatchesRealPath(Batch[I], Results[I]);
+
+  fs::PathCanonicalizer Parallel;
+  DefaultThreadPool Pool(hardware_concurrency(4));
+  Results = Parallel.canonicalizeAll(Batch, Pool);
+  ASSERT_EQ(Batch.size(), Results.size());
+  for (size_t I = 0, E = Batch.size(); I != E; ++I)
+    expectMatchesRealPath(Batch[I], Results[I]);
+}
+
+} // namespace
@@ -0,0 +1,51 @@
+//===- llvm/unittest/Support/PrettyStackTraceTest.cpp ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+#include <string>
+using namespace llvm;
+
+namespace {
+
+template <typename EntryT> std::string printEntry(const EntryT &Entry) {
+  std::string Str;
+  raw_string_ostream OS(Str);
+  Entry.print(OS);
+  return Str;
+}
+
+TEST(PrettyStackTraceTest, DeferredFormat) {
+  const char *Name = "foo";
+  PrettyStackTraceDeferredFormat Deferred("Running pass '%s' on #%d (%.1f)",
+                                          Name, 42, 0.5);
+  EXPECT_EQ("Running pass 'foo' on #42 (0.5)\n", printEntry(Deferred));
+
+  // The arguments are copied when the entry is made.
+  int Count = 1;
+  PrettyStackTraceDeferredFormat CountEntry("count %d", Count);
+  Count = 2;
+  EXPECT_EQ("count 1\n", printEntry(CountEntry));
+
+  PrettyStackTraceDeferredFormat NoArgs("no arguments");
+  EXPECT_EQ("no arguments\n", printEntry(NoArgs));
+
+#if ENABLE_BACKTRACES
+  // The entries are on the pretty stack like any other, innermost first.
+  const auto *Top = static_cast<const PrettyStackTraceEntry *>(
+      SavePrettyStackState());
+  ASSERT_EQ(&NoArgs, Top);
+  EXPECT_EQ(&CountEntry, Top->getNextEntry());
+  EXPECT_EQ(&Deferred, Top->getNextEntry()->getNextEntry());
+#endif
+}
+
+} // namespace
@@ -521,6 +521,77 @@ TEST_F(ProgramEnvTest, TestExecuteAndWaitStatistics) {
   ASSERT_GE(ProcStat->TotalTime, ProcStat->UserTime);
 }
 
+TEST_F(ProgramEnvTest, TestProcessPool) {
+  using namespace llvm::sys;
+
+  if (getenv("LLVM_PROGRAM_TEST_PROCESS_POOL")) {
+    unsigned N = std::stoi(ProgramTestStringArg1);
+    // Write more than a pipe buffer's worth from one of the children, so the
+    // pool has to drain the pipe while the child is still running.
+    if (N == 0)
+      fprintf(stdout, "%s", std::string(256 * 1024, 'x').c_str());
+    fprintf(stdout, "out-%u\n", N);
+    fprintf(stderr, "err-%u\n", N);
+    exit(N);
+  }
+
+  std::string Executable =
+      sys::fs::getMainExecutable(TestMainArgv0, &ProgramTestStringArg1);
+  addEnvVar("LLVM_PROGRAM_TEST_PROCESS_POOL=1");
+
+  constexpr unsigned NumJobs = 8;
+  ProcessPool Pool(/*MaxRunning=*/3);
+  std::vector<std::string> Args;
+  for (unsigned I = 0; I != NumJobs; ++I) {
+    std::string Arg = "--program-test-string-arg1=" + std::to_string(I);
+    StringRef argv[] = {Executable,
+                        "--gtest_filter=ProgramEnvTest.TestProcessPool", Arg};
+    EXPECT_EQ(I, Pool.addJob(Executable, argv, getEnviron()));
+  }
+  SmallString<128> Missing;
+  sys::path::append(Missing, sys::path::parent_path(Executable),
+                    "program-test-does-not-exist");
+  StringRef MissingArgv[] = {Missing};
+  EXPECT_EQ(NumJobs, Pool.addJob(Missing, MissingArgv));
+
+  std::vector<bool> Seen(NumJobs + 1);
+  Pool.run([&](ProcessPool::Result &R) {
+    ASSERT_LT(R.Index, Seen.size());
+    EXPECT_FALSE(Seen[R.Index]);
+    Seen[R.Index] = true;
+    ASSERT_TRUE(R.Stdout);
+    ASSERT_TRUE(R.Stderr);
+    if (R.Index == NumJobs) {
+      EXPECT_EQ(-1, R.ReturnCode);
+      EXPECT_FALSE(R.ErrMsg.empty());
+      return;
+    }
+    EXPECT_FALSE(R.ExecutionFailed) << R.ErrMsg;
+    EXPECT_EQ(static_cast<int>(R.Index), R.ReturnCode);
+    std::string Index = std::to_string(R.Index);
+    EXPECT_TRUE(R.Stdout->getBuffer().contains("out-" + Index));
+    EXPECT_TRUE(R.Stderr->getBuffer().contains("err-" + Index));
+    if (R.Index == 0) {
+      EXPECT_GT(R.Stdout->getBufferSize(), 256u * 1024);
+    }
+  });
+  for (unsigned I = 0; I != NumJobs + 1; ++I)
+    EXPECT_TRUE(Seen[I]) << "job " << I << " was not reported";
+
+  // Jobs added after a run are numbered after the ones already run.
+  StringRef argv[] = {Executable,
+                      "--gtest_filter=ProgramEnvTest.TestProcessPool",
+                      "--program-test-string-arg1=5"};
+  EXPECT_EQ(NumJobs + 1, Pool.addJob(Executable, argv, getEnviron()));
+  unsigned NumReported = 0;
+  Pool.run([&](ProcessPool::Result &R) {
+    ++NumReported;
+    EXPECT_EQ(NumJobs + 1, R.Index);
+    EXPECT_EQ(5, R.ReturnCode);
+  });
+  EXPECT_EQ(1u, NumReported);
+}
+
 TEST_F(ProgramEnvTest, TestLockFile) {
   using namespace llvm::sys;
 
@@ -7,8 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/ScaledNumber.h"
+#include "llvm/ADT/APInt.h"
 #include "llvm/Support/DataTypes.h"
 #include "gtest/gtest.h"
+#include <random>
 
 using namespace llvm;
 using namespace llvm::ScaledNumbers;
@@ -189,6 +191,58 @@ TEST(ScaledNumberHelpersTest, getQuotient) {
   EXPECT_EQ(SP64(0xd555555555555555, -63), getQuotient64(5, 3));
 }
 
+// Compute getProduct64 and getQuotient64 with exact 128-bit arithmetic, to
+// check the fast paths against.
+static std::pair<uint64_t, int16_t> referenceProduct64(uint64_t L,
+                                                       uint64_t R) {
+  APInt Product = APInt(128, L) * APInt(128, R);
+  unsigned Bits = Product.getActiveBits();
+  if (Bits <= 64)
+    return {Product.getZExtValue(), 0};
+  unsigned Shift = Bits - 64;
+  return getRounded(Product.lshr(Shift).getZExtValue(), Shift,
+                    Product[Shift - 1]);
+}
+
+static std::pair<uint64_t, int16_t> referenceQuotient64(uint64_t Dividend,
+                                                        uint64_t Divisor) {
+  if (!Dividend)
+    return {0, 0};
+  if (!Divisor)
+    return {UINT64_MAX, MaxScale};
+  int Shift = -(int)llvm::countr_zero(Divisor);
+  Divisor >>= llvm::countr_zero(Divisor);
+  if (Divisor == 1)
+    return {Dividend, Shift};
+  Shift -= llvm::countl_zero(Dividend);
+  Dividend <<= llvm::countl_zero(Dividend);
+  // Take quotient bits until there are 64 of them or the division is exact.
+  APInt D(128, Divisor), Q, R;
+  for (unsigned Steps = 0;; ++Steps) {
+    APInt::udivrem(APInt(128, Dividend).shl(Steps), D, Q, R);
+    if (Q.getActiveBits() == 64 || R.isZero())
+      return getRounded(Q.getZExtValue(), Shift - Steps,
+                        R.uge((Divisor >> 1) + (Divisor & 1)));
+  }
+}
+
+TEST(ScaledNumberHelpersTest, getProductAndQuotientRandom) {
+  std::mt19937_64 Rng(0);
+  auto Random = [&] {
+    // Vary the width of the operands so that every normalization shift is
+    // exercised, and sometimes clear low bits to get even divisors.
+    uint64_t V = Rng() >> (Rng() % 64);
+    return V << (Rng() % 4 == 0 ? Rng() % 64 : 0);
+  };
+  for (int I = 0; I < 100000; ++I) {
+    uint64_t L = Random(), R = Random();
+    EXPECT_EQ(SP64(referenceProduct64(L, R)), getProduct64(L, R))
+        << L << " * " << R;
+    EXPECT_EQ(SP64(referenceQuotient64(L, R)), getQuotient64(L, R))
+        << L << " / " << R;
+  }
+}
+
 TEST(ScaledNumberHelpersTest, getLg) {
   EXPECT_EQ(0, getLg(UINT32_C(1), 0));
   EXPECT_EQ(1, getLg(UINT32_C(1), 1));
@@ -66,4 +66,56 @@ TEST(SignalsTest, SymbolizerMarkupDisabled) {
   EXPECT_THAT(Res, Not(MatchesRegex(TAG_BEGIN "reset" TAG_END ".*")));
 }
 
+TEST(SignalsTest, PrintsPreloadedSymbols) {
+  scope_exit Unload([]() { UnloadStackTraceSymbols(); });
+  PreloadStackTraceSymbols();
+  std::string Res;
+  raw_string_ostream RawStream(Res);
+  PrintStackTrace(RawStream);
+  // The frame for PrintStackTrace itself is named from the symbol table of
+  // this binary, along with the module and offset.
+  EXPECT_THAT(Res, MatchesRegex(" *#0 0x[0-9a-f]+ [^\n]*PrintStackTrace[^\n]* "
+                                "\\+ [0-9]+ \\([^\n]+\\+0x[0-9a-f]+\\)\n.*"));
+  EXPECT_THAT(Res, Not(MatchesRegex(".*Stack dump without symbol names.*")));
+}
+
 #endif // defined(HAVE_BACKTRACE) && ...
+
+#if defined(__linux__) || defined(__FreeBSD__) ||                              \
+    defined(__FreeBSD_kernel__) || defined(__NetBSD__) ||                      \
+    defined(__OpenBSD__) || defined(__DragonFly__)
+namespace signals_test {
+LLVM_ATTRIBUTE_NOINLINE void preloadedFrame() {}
+} // namespace signals_test
+
+TEST(SignalsTest, PrintPreloadedStackTrace) {
+  // Frames for a function of this binary, given as return addresses past its
+  // first byte, and for an address no function covers.
+  int Local;
+  void *Frames[12];
+  for (void *&Frame : Frames)
+    Frame = reinterpret_cast<char *>(&signals_test::preloadedFrame) + 1;
+  Frames[11] = &Local;
+
+  std::string Res;
+  raw_string_ostream RawStream(Res);
+  EXPECT_FALSE(PrintPreloadedStackTrace(RawStream, Frames, 12));
+  EXPECT_EQ("", Res);
+
+  scope_exit Unload([]() { UnloadStackTraceSymbols(); });
+  PreloadStackTraceSymbols();
+  ASSERT_TRUE(PrintPreloadedStackTrace(RawStream, Frames, 12));
+  // Names are printed mangled, and frame numbers are right-aligned.
+  EXPECT_THAT(Res, MatchesRegex(" #0 0x[0-9a-f]+ _ZN12signals_test14"
+                                "preloadedFrameEv \\+ 1 "
+                                "\\([^\n]+\\+0x[0-9a-f]+\\)\n.*"));
+  EXPECT_THAT(Res, MatchesRegex(".*\n#10 0x[0-9a-f]+ _ZN12signals_test14"
+                                "preloadedFrameEv [^\n]*\n.*"));
+  // The last frame gets its address only.
+  EXPECT_THAT(Res, MatchesRegex(".*\n#11 0x[0-9a-f]+\n"));
+
+  UnloadStackTraceSymbols();
+  Res.clear();
+  EXPECT_FALSE(PrintPreloadedStackTrace(RawStream, Frames, 12));
+}
+#endif
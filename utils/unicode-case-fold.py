@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""
+Unicode case folding database conversion utility
+
+Parses the database and generates a C++ function which implements the simple
+case folding algorithm. The database entries are of the form:
+
+  <code>; <status>; <mapping>; # <name>
+
+<status> can be one of four characters:
+  C - Common mappings
+  S - mappings for Simple case folding
+  F - mappings for Full case folding
+  T - special case for Turkish I characters
+
+Simple case folding uses the C and S entries. The generated function looks the
+code point up in a three-level trie: the top level is indexed by the high bits
+of the code point, the middle level by the next bits, and the leaves hold an
+index into a table of the differences between folded and original code points.
+Identical blocks at each level are shared, which keeps the tables small.
+"""
+
+import re
+import sys
+from urllib.request import urlopen
+
+# The number of code point bits handled by the leaf and middle levels.
+LEAF_BITS = 4
+MID_BITS = 5
+
+
+def read_mappings(source):
+    if re.match(r"^https?://", source):
+        lines = urlopen(source).read().decode("utf-8").splitlines()
+    else:
+        with open(source, encoding="utf-8") as f:
+            lines = f.read().splitlines()
+
+    mappings = {}
+    pattern = re.compile(r"^([0-9A-F]+); ([CSFT]); ([0-9A-F ]+);")
+    for line in lines:
+        m = pattern.match(line)
+        if not m or m.group(2) not in "CS":
+            continue
+        mappings[int(m.group(1), 16)] = int(m.group(3), 16)
+    return mappings
+
+
+def build_trie(values):
+    """Split values into deduplicated leaf and middle blocks."""
+    leaf_size = 1 << LEAF_BITS
+    mid_size = 1 << MID_BITS
+    leaves, leaf_ids, mid_entries = [], {}, []
+    for i in range(0, len(values), leaf_size):
+        block = tuple(values[i : i + leaf_size])
+        if block not in leaf_ids:
+            leaf_ids[block] = len(leaves)
+            leaves.append(block)
+        mid_entries.append(leaf_ids[block])
+    mids, mid_ids, top = [], {}, []
+    for i in range(0, len(mid_entries), mid_size):
+        block = tuple(mid_entries[i : i + mid_size])
+        if block not in mid_ids:
+            mid_ids[block] = len(mids)
+            mids.append(block)
+        top.append(mid_ids[block])
+    return top, mids, leaves
+
+
+def c_type(values):
+    return "uint8_t" if max(values) < 256 else "uint16_t"
+
+
+def print_table(name, ctype, values, fmt):
+    print("static const %s %s[] = {" % (ctype, name))
+    line = "   "
+    for v in values:
+        item = " " + fmt(v) + ","
+        if len(line) + len(item) > 80:
+            print(line)
+            line = "   "
+        line += item
+    print(line)
+    print("};")
+    print()
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s <CaseFolding.txt path or URL>" % sys.argv[0])
+    source = sys.argv[1]
+    mappings = read_mappings(source)
+
+    block = 1 << (LEAF_BITS + MID_BITS)
+    limit = (max(mappings) // block + 1) * block
+    deltas = sorted(set(to - code for code, to in mappings.items()) | {0})
+    delta_ids = {d: i for i, d in enumerate(deltas)}
+    values = [delta_ids[mappings.get(c, c) - c] for c in range(limit)]
+    top, mids, leaves = build_trie(values)
+    mid_values = [v for m in mids for v in m]
+    leaf_values = [v for l in leaves for v in l]
+    assert len(deltas) < 256 and len(mids) < 256
+
+    print(
+        """\
+//===---------- Support/UnicodeCaseFold.cpp -------------------------------===//
+//
+// This file was generated by utils/unicode-case-fold.py from the Unicode
+// case folding database at
+//    %s
+//
+// To regenerate this file, run:
+//   utils/unicode-case-fold.py \\
+//     "%s" \\
+//     > lib/Support/UnicodeCaseFold.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Unicode.h"
+#include <cstdint>
+
+// Differences between a folded code point and the original one.
+"""
+        % (source, source),
+        end="",
+    )
+    print_table("FoldDeltas", "int32_t", deltas, str)
+    print("// Index of the middle-level block, by code point bits %d and up."
+          % (LEAF_BITS + MID_BITS))
+    print_table("FoldTop", c_type(top), top, str)
+    print("// Index of the leaf block, by code point bits %d to %d."
+          % (LEAF_BITS, LEAF_BITS + MID_BITS - 1))
+    print_table("FoldMid", c_type(mid_values), mid_values, str)
+    print("// Index into FoldDeltas, by code point bits 0 to %d."
+          % (LEAF_BITS - 1))
+    print_table("FoldLeaves", c_type(leaf_values), leaf_values, str)
+    print(
+        """\
+int llvm::sys::unicode::foldCharSimple(int C) {
+  if (static_cast<unsigned>(C) >= 0x%x)
+    return C;
+  unsigned Mid = FoldTop[C >> %d];
+  unsigned Leaf = FoldMid[(Mid << %d) | ((C >> %d) & %d)];
+  return C + FoldDeltas[FoldLeaves[(Leaf << %d) | (C & %d)]];
+}"""
+        % (
+            limit,
+            LEAF_BITS + MID_BITS,
+            MID_BITS,
+            LEAF_BITS,
+            (1 << MID_BITS) - 1,
+            LEAF_BITS,
+            (1 << LEAF_BITS) - 1,
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
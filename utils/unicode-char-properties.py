@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""
+Unicode character property table generator
+
+Reads the UnicodeCharRange tables that tests/Support/UnicodeTest.cpp defines
+for isPrintable, isFormatting and charWidth, and generates a three-level trie
+that maps every code point to all of those properties at once. The top level
+is indexed by the high bits of the code point, the middle level by the next
+bits, and the leaves hold the properties. Identical blocks at each level are
+shared, which keeps the tables small.
+
+Each property value is a byte:
+  bits 0-1 - the column width plus one, or 0 if the code point is not
+             printable
+  bit 2    - set if the code point is a formatting character
+
+To regenerate the tables after changing the ranges, run:
+  utils/unicode-char-properties.py tests/Support/UnicodeTest.cpp \\
+    > lib/Support/UnicodeCharProperties.inc
+"""
+
+import re
+import sys
+
+# The number of code point bits handled by the leaf and middle levels.
+LEAF_BITS = 4
+MID_BITS = 5
+
+MAX_CODE_POINT = 0x10FFFF
+
+# Clang treats U+00AD SOFT HYPHEN as printable, as it is rendered as an actual
+# hyphen in most terminals.
+SOFT_HYPHEN = 0x00AD
+
+
+def read_ranges(path):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    ranges = {}
+    for m in re.finditer(
+        r"static const UnicodeCharRange (\w+)\[\] = \{(.*?)\};", text, re.S
+    ):
+        pairs = re.findall(r"\{(0x[0-9A-Fa-f]+), (0x[0-9A-Fa-f]+)\}", m.group(2))
+        ranges[m.group(1)] = [(int(lo, 16), int(hi, 16)) for lo, hi in pairs]
+    return ranges
+
+
+def to_set(ranges, size):
+    values = bytearray(size)
+    for lo, hi in ranges:
+        values[lo : hi + 1] = b"\x01" * (hi - lo + 1)
+    return values
+
+
+def build_trie(values):
+    """Split values into deduplicated leaf and middle blocks."""
+    leaf_size = 1 << LEAF_BITS
+    mid_size = 1 << MID_BITS
+    leaves, leaf_ids, mid_entries = [], {}, []
+    for i in range(0, len(values), leaf_size):
+        block = tuple(values[i : i + leaf_size])
+        if block not in leaf_ids:
+            leaf_ids[block] = len(leaves)
+            leaves.append(block)
+        mid_entries.append(leaf_ids[block])
+    mids, mid_ids, top = [], {}, []
+    for i in range(0, len(mid_entries), mid_size):
+        block = tuple(mid_entries[i : i + mid_size])
+        if block not in mid_ids:
+            mid_ids[block] = len(mids)
+            mids.append(block)
+        top.append(mid_ids[block])
+    return top, mids, leaves
+
+
+def c_type(values):
+    return "uint8_t" if max(values) < 256 else "uint16_t"
+
+
+def print_table(name, ctype, values):
+    print("static const %s %s[] = {" % (ctype, name))
+    line = "   "
+    for v in values:
+        item = " %d," % v
+        if len(line) + len(item) > 80:
+            print(line)
+            line = "   "
+        line += item
+    print(line)
+    print("};")
+    print()
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: %s <path to tests/Support/UnicodeTest.cpp>" % sys.argv[0])
+    ranges = read_ranges(sys.argv[1])
+
+    size = MAX_CODE_POINT + 1
+    printable = to_set(ranges["PrintableRanges"], size)
+    printable[SOFT_HYPHEN] = 1
+    formatting = to_set(ranges["Cf"], size)
+    combining = to_set(ranges["CombiningCharacterRanges"], size)
+    double_width = to_set(ranges["DoubleWidthCharacterRanges"], size)
+
+    values = bytearray(size)
+    for c in range(size):
+        if printable[c]:
+            width = 0 if combining[c] else 2 if double_width[c] else 1
+            values[c] = width + 1
+        if formatting[c]:
+            values[c] |= 4
+
+    top, mids, leaves = build_trie(values)
+    mid_values = [v for m in mids for v in m]
+    leaf_values = [v for l in leaves for v in l]
+    assert len(mids) < 256
+
+    print(
+        """\
+//===- UnicodeCharProperties.inc - Unicode character property tables -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file was generated by utils/unicode-char-properties.py from the
+// character ranges in tests/Support/UnicodeTest.cpp. Do not edit it by hand.
+//
+//===----------------------------------------------------------------------===//
+"""
+    )
+    print("// Index of the middle-level block, by code point bits %d and up."
+          % (LEAF_BITS + MID_BITS))
+    print_table("CharPropertyTop", c_type(top), top)
+    print("// Index of the leaf block, by code point bits %d to %d."
+          % (LEAF_BITS, LEAF_BITS + MID_BITS - 1))
+    print_table("CharPropertyMid", c_type(mid_values), mid_values)
+    print("// Properties of each code point, by code point bits 0 to %d."
+          % (LEAF_BITS - 1))
+    print_table("CharPropertyLeaves", c_type(leaf_values), leaf_values)
+    print(
+        """\
+// The bits of a property value.
+enum : unsigned {
+  CharPropertyWidthMask = 3,
+  CharPropertyFormatting = 4,
+};
+
+/// Returns the properties of \\p UCS, or 0 if it is not a code point.
+static inline unsigned getCharProperties(int UCS) {
+  if (static_cast<unsigned>(UCS) > 0x%x)
+    return 0;
+  unsigned Mid = CharPropertyTop[UCS >> %d];
+  unsigned Leaf = CharPropertyMid[(Mid << %d) | ((UCS >> %d) & %d)];
+  return CharPropertyLeaves[(Leaf << %d) | (UCS & %d)];
+}"""
+        % (
+            MAX_CODE_POINT,
+            LEAF_BITS + MID_BITS,
+            MID_BITS,
+            LEAF_BITS,
+            (1 << MID_BITS) - 1,
+            LEAF_BITS,
+            (1 << LEAF_BITS) - 1,
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()